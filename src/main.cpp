@@ -1,4 +1,5 @@
 #include <SFML/Graphics.hpp>
+#include <SFML/OpenGL.hpp>
 #include <array>
 #include <vector>
 #include <queue>
@@ -10,12 +11,52 @@
 #include <cmath>
 #include <memory>
 #include <unordered_map>
+#include <cstdint>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <cctype>
+#include <functional>
+#include <future>
+#include <new>
+#include <chrono>
+#include "puyo_core.hpp"
+#include "puyo_chain.hpp"
+#include "puyo_puzzle.hpp"
+#include "puyo_patterns.hpp"
+#include "puyo_stream.hpp"
+#include "puyo_scores.hpp"
+#include "puyo_moves.hpp"
+#include "puyo_search.hpp"
+#include "puyo_metrics.hpp"
+#include "puyo_checkpoint.hpp"
+#include "puyo_tween.hpp"
 
 using namespace std;
 
+// ---- 계측 (--metrics=PORT) ----
+// 모든 operator new를 세어 프레임당 할당 수를 냄 (스레드별 칸에 원자 덧셈 하나)
+void* operator new(size_t size) {
+    metrics::allocations().add();
+    if(void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+// 그리기 호출 수 (프레임마다 차이를 게이지로 냄)
+metrics::Counter& drawCalls() {
+    static metrics::Counter counter;
+    return counter;
+}
+
+void drawCounted(sf::RenderTarget& target, const sf::Drawable& drawable,
+                 const sf::RenderStates& states = sf::RenderStates::Default) {
+    drawCalls().add();
+    target.draw(drawable, states);
+}
+
 // ---- 화면 비율 개선된 상수들 ----
-static const int COLS = 6;
-static const int ROWS = 12;
 static const int BASE_CELL_SIZE = 32;
 static const float ASPECT_RATIO = 4.0f / 3.0f; // 게임의 기본 비율
 static const int BASE_GAME_WIDTH = COLS * BASE_CELL_SIZE;
@@ -56,54 +97,109 @@ struct DisplaySettings {
     }
 };
 
+// ---- 실행 파일에 포함된 폰트 ----
+// 빌드 시 fonts/*.ttf를 .incbin으로 바이너리에 직접 넣음 (저장소 루트에서 컴파일)
+#if defined(__GNUC__) && (defined(__ELF__) || defined(_WIN64))
+#  if defined(_WIN64)
+#    define PUYO_EMBED_SECTION ".section .rdata,\"dr\"\n"
+#  else
+#    define PUYO_EMBED_SECTION ".section .rodata\n"
+#  endif
+#  define PUYO_EMBED_FILE(name, path) \
+    extern "C" const unsigned char name##_data[]; \
+    extern "C" const unsigned char name##_end[]; \
+    __asm__(PUYO_EMBED_SECTION \
+            ".global " #name "_data\n" \
+            ".balign 16\n" \
+            #name "_data:\n" \
+            ".incbin \"" path "\"\n" \
+            ".global " #name "_end\n" \
+            #name "_end:\n" \
+            ".byte 0\n" \
+            ".previous\n");
+#  define PUYO_HAS_EMBEDDED_FONTS 1
+
+PUYO_EMBED_FILE(puyo_font_title, "fonts/orbitron-bold.ttf")
+PUYO_EMBED_FILE(puyo_font_ui, "fonts/roboto.ttf")
+PUYO_EMBED_FILE(puyo_font_score, "fonts/sourcecodepro.ttf")
+PUYO_EMBED_FILE(puyo_font_retro, "fonts/pressstart2p.ttf")
+#else
+#  define PUYO_HAS_EMBEDDED_FONTS 0
+#endif
+
+// 시작 시간 계측 (단계별 경과 시간을 콘솔에 출력)
+struct StartupProfiler {
+    sf::Clock clock;
+
+    void mark(const char* stage) const {
+        fprintf(stderr, "[startup] %-20s %8.2f ms\n", stage,
+                clock.getElapsedTime().asMicroseconds() / 1000.0);
+    }
+};
+
 // 향상된 폰트 매니저
 class FontManager {
 private:
-    std::unordered_map<std::string, sf::Font> fonts;
-    sf::Font defaultFont;
-    bool defaultFontLoaded = false;
-    
-public:
-    bool loadAllFonts() {
+    // 백그라운드 스레드에서 읽어온 폰트 (메인 스레드에서 합침)
+    struct LoadedFonts {
+        vector<pair<string, unique_ptr<sf::Font>>> fonts;
+        unique_ptr<sf::Font> defaultFont;
+    };
+
+    std::unordered_map<std::string, unique_ptr<sf::Font>> fonts;
+    unique_ptr<sf::Font> defaultFont;
+    std::future<LoadedFonts> pending;
+
+    // 파일 시스템 폰트 검색 (느릴 수 있으므로 백그라운드에서 실행)
+    static LoadedFonts loadSystemFonts(vector<string> missingCategories) {
         // 폰트 경로들을 우선순위별로 정리
         vector<pair<string, vector<string>>> fontCategories = {
             {"title", {
                 "fonts/orbitron-bold.ttf",
                 "fonts/audiowide.ttf", 
                 "assets/fonts/title.ttf",
+#ifdef _WIN32
                 "C:/Windows/Fonts/impact.ttf",
                 "C:/Windows/Fonts/arial.ttf"
+#endif
             }},
             {"ui", {
                 "fonts/roboto.ttf",
                 "fonts/opensans.ttf",
                 "assets/fonts/ui.ttf", 
+#ifdef _WIN32
                 "C:/Windows/Fonts/segoeui.ttf",
                 "C:/Windows/Fonts/arial.ttf"
+#endif
             }},
             {"score", {
                 "fonts/courier-new.ttf",
                 "fonts/sourcecodepro.ttf",
                 "assets/fonts/mono.ttf",
+#ifdef _WIN32
                 "C:/Windows/Fonts/consola.ttf", 
                 "C:/Windows/Fonts/arial.ttf"
+#endif
             }},
             {"retro", {
                 "fonts/pressstart2p.ttf",
                 "fonts/pixelated.ttf",
                 "assets/fonts/retro.ttf",
+#ifdef _WIN32
                 "C:/Windows/Fonts/arial.ttf"
+#endif
             }}
         };
         
-        // 각 카테고리별 폰트 로딩 시도
-        int loadedCount = 0;
+        LoadedFonts result;
         for(const auto& category : fontCategories) {
+            if(std::find(missingCategories.begin(), missingCategories.end(), category.first) == missingCategories.end()) {
+                continue;
+            }
             for(const auto& path : category.second) {
-                sf::Font font;
-                if(font.loadFromFile(path)) {
-                    fonts[category.first] = font;
-                    loadedCount++;
+                auto font = std::make_unique<sf::Font>();
+                if(font->loadFromFile(path)) {
+                    result.fonts.emplace_back(category.first, std::move(font));
                     break;
                 }
             }
@@ -111,29 +207,94 @@ public:
         
         // 기본 폰트 로딩 (fallback)
         vector<string> defaultPaths = {
+#if defined(_WIN32)
             "C:/Windows/Fonts/arial.ttf",
             "C:/Windows/Fonts/calibri.ttf", 
+#elif defined(__APPLE__)
             "/System/Library/Fonts/Helvetica.ttc",
+#else
             "/usr/share/fonts/truetype/dejavu/DejaVuSans.ttf",
+#endif
             "arial.ttf"
         };
         
         for(const auto& path : defaultPaths) {
-            if(defaultFont.loadFromFile(path)) {
-                defaultFontLoaded = true;
+            auto font = std::make_unique<sf::Font>();
+            if(font->loadFromFile(path)) {
+                result.defaultFont = std::move(font);
                 break;
             }
         }
-        
-        return loadedCount > 0 || defaultFontLoaded;
+        return result;
+    }
+    
+public:
+    // 바이너리에 포함된 폰트를 메모리에서 바로 로딩 (파일 접근 없음)
+    int loadEmbeddedFonts() {
+        int loadedCount = 0;
+#if PUYO_HAS_EMBEDDED_FONTS
+        struct EmbeddedFont { const char* category; const unsigned char* begin; const unsigned char* end; };
+        const EmbeddedFont embedded[] = {
+            {"title", puyo_font_title_data, puyo_font_title_end},
+            {"ui",    puyo_font_ui_data,    puyo_font_ui_end},
+            {"score", puyo_font_score_data, puyo_font_score_end},
+            {"retro", puyo_font_retro_data, puyo_font_retro_end}
+        };
+        for(const auto& entry : embedded) {
+            size_t size = static_cast<size_t>(entry.end - entry.begin);
+            if(size == 0) continue;
+            auto font = std::make_unique<sf::Font>();
+            if(font->loadFromMemory(entry.begin, size)) {
+                fonts[entry.category] = std::move(font);
+                loadedCount++;
+            }
+        }
+#endif
+        return loadedCount;
+    }
+
+    // 내장 폰트가 없는 카테고리와 기본 폰트를 백그라운드에서 검색
+    void loadSystemFontsAsync() {
+        vector<string> missing;
+        for(const char* category : {"title", "ui", "score", "retro"}) {
+            if(!hasFont(category)) missing.push_back(category);
+        }
+        pending = std::async(std::launch::async, &FontManager::loadSystemFonts, std::move(missing));
+    }
+
+    // 백그라운드 로딩이 끝났으면 결과를 합침 (완료 시 true)
+    bool pollAsyncFonts(bool wait = false) {
+        if(!pending.valid()) return false;
+        if(!wait && pending.wait_for(std::chrono::seconds(0)) != std::future_status::ready) return false;
+
+        LoadedFonts loaded = pending.get();
+        for(auto& entry : loaded.fonts) {
+            fonts[entry.first] = std::move(entry.second);
+        }
+        if(loaded.defaultFont) {
+            defaultFont = std::move(loaded.defaultFont);
+        }
+        return true;
+    }
+
+    bool isLoading() const {
+        return pending.valid();
+    }
+
+    // 모든 폰트를 동기적으로 로딩 (헤드리스 벤치마크 등)
+    bool loadAllFonts() {
+        loadEmbeddedFonts();
+        loadSystemFontsAsync();
+        pollAsyncFonts(true);
+        return isLoaded();
     }
     
     const sf::Font& getFont(const string& category) const {
         auto it = fonts.find(category);
         if(it != fonts.end()) {
-            return it->second;
+            return *it->second;
         }
-        return defaultFontLoaded ? defaultFont : fonts.begin()->second;
+        return defaultFont ? *defaultFont : *fonts.begin()->second;
     }
     
     bool hasFont(const string& category) const {
@@ -141,28 +302,164 @@ public:
     }
     
     bool isLoaded() const {
-        return !fonts.empty() || defaultFontLoaded;
+        return !fonts.empty() || defaultFont != nullptr;
     }
 };
 
 // 게임 상태
-enum GameState { MENU, PLAYING, GAME_OVER, PAUSED };
+enum GameState { MENU, PLAYING, GAME_OVER, PAUSED, LEADERBOARD };
+
+// 글로우 텍스처 캐시 - 문자열/크기별로 CPU에서 한 번 블러 처리한 알파 텍스처를 보관
+class GlowCache {
+public:
+    struct Glow {
+        sf::Texture texture;
+        float padding = 0.0f; // 텍스트 원점 기준 여백 (픽셀)
+    };
+
+private:
+    static const size_t MAX_ENTRIES = 128;
+    static constexpr float GLOW_GAIN = 2.2f;
+
+    unordered_map<string, unique_ptr<Glow>> entries;
+    string keyBuffer; // 조회용 키 버퍼 (용량 재사용)
+    vector<uint8_t> alpha, scratch, transposed;
+    vector<uint32_t> accum;
+
+    // 세로 방향 박스 블러 - 안쪽 루프가 연속 메모리라 컴파일러가 SIMD로 벡터화
+    void boxBlurColumns(const uint8_t* src, uint8_t* dst, int w, int h, int r) {
+        accum.assign(w, 0);
+        for(int y = 0; y <= r && y < h; y++) {
+            const uint8_t* row = src + y * w;
+            for(int x = 0; x < w; x++) accum[x] += row[x];
+        }
+
+        const uint32_t inv = (1u << 16) / static_cast<uint32_t>(2 * r + 1);
+        for(int y = 0; y < h; y++) {
+            uint8_t* out = dst + y * w;
+            for(int x = 0; x < w; x++) {
+                out[x] = static_cast<uint8_t>((accum[x] * inv) >> 16);
+            }
+            int addRow = y + r + 1;
+            int subRow = y - r;
+            if(addRow < h) {
+                const uint8_t* row = src + addRow * w;
+                for(int x = 0; x < w; x++) accum[x] += row[x];
+            }
+            if(subRow >= 0) {
+                const uint8_t* row = src + subRow * w;
+                for(int x = 0; x < w; x++) accum[x] -= row[x];
+            }
+        }
+    }
+
+    static void transpose(const uint8_t* src, uint8_t* dst, int w, int h) {
+        for(int y = 0; y < h; y++) {
+            for(int x = 0; x < w; x++) {
+                dst[x * h + y] = src[y * w + x];
+            }
+        }
+    }
+
+    // 분리형 블러: 세로 패스 -> 전치 -> 세로 패스 -> 전치 (박스 3회 ~ 가우시안)
+    void separableBlur(int w, int h, int r) {
+        scratch.resize(alpha.size());
+        transposed.resize(alpha.size());
+        for(int pass = 0; pass < 3; pass++) {
+            boxBlurColumns(alpha.data(), scratch.data(), w, h, r);
+            transpose(scratch.data(), transposed.data(), w, h);
+            boxBlurColumns(transposed.data(), scratch.data(), h, w, r);
+            transpose(scratch.data(), alpha.data(), h, w);
+        }
+    }
+
+    unique_ptr<Glow> bake(const sf::Font& font, unsigned size, const char* text, size_t length, int radius) {
+        auto glow = std::make_unique<Glow>();
+        int padding = radius * 3 + 2;
+        glow->padding = static_cast<float>(padding);
+
+        sf::Text textObj(string(text, length), font, size);
+        textObj.setFillColor(sf::Color::White);
+        textObj.setPosition(static_cast<float>(padding), static_cast<float>(padding));
+        sf::FloatRect bounds = textObj.getLocalBounds();
+
+        int w = static_cast<int>(std::ceil(bounds.left + bounds.width)) + padding * 2;
+        int h = static_cast<int>(std::ceil(bounds.top + bounds.height)) + padding * 2;
+        w = std::max(w, 1);
+        h = std::max(h, 1);
+
+        // 텍스트 알파 마스크를 한 번만 읽어와 CPU에서 블러
+        sf::RenderTexture mask;
+        if(!mask.create(w, h)) return glow;
+        mask.clear(sf::Color::Transparent);
+        drawCounted(mask, textObj);
+        mask.display();
+        sf::Image image = mask.getTexture().copyToImage();
+
+        const sf::Uint8* pixels = image.getPixelsPtr();
+        alpha.resize(static_cast<size_t>(w) * h);
+        for(size_t i = 0; i < alpha.size(); i++) {
+            alpha[i] = pixels[i * 4 + 3];
+        }
 
-// 셀 상태  
-enum Color { EMPTY=0, RED, GREEN, BLUE, YELLOW, PURPLE, COLOR_COUNT };
+        separableBlur(w, h, radius);
 
-// 2차원 좌표
-struct Vec2 { int x, y; };
+        vector<sf::Uint8> rgba(alpha.size() * 4, 255);
+        for(size_t i = 0; i < alpha.size(); i++) {
+            rgba[i * 4 + 3] = static_cast<sf::Uint8>(std::min(255.0f, alpha[i] * GLOW_GAIN));
+        }
+
+        if(glow->texture.create(w, h)) {
+            glow->texture.update(rgba.data());
+            glow->texture.setSmooth(true);
+        }
+        return glow;
+    }
+
+public:
+    // radius는 블러 반경 (픽셀). 같은 문자열/크기는 캐시된 텍스처를 반환
+    const Glow& get(const sf::Font& font, unsigned size, const char* text, size_t length, int radius) {
+        keyBuffer.clear();
+        const void* fontPtr = &font;
+        keyBuffer.append(reinterpret_cast<const char*>(&fontPtr), sizeof(fontPtr));
+        keyBuffer.append(reinterpret_cast<const char*>(&size), sizeof(size));
+        keyBuffer.append(reinterpret_cast<const char*>(&radius), sizeof(radius));
+        keyBuffer.append(text, length);
+
+        auto it = entries.find(keyBuffer);
+        if(it != entries.end()) return *it->second;
+
+        if(entries.size() >= MAX_ENTRIES) entries.clear();
+        auto result = entries.emplace(keyBuffer, bake(font, size, text, length, radius));
+        return *result.first->second;
+    }
+
+    bool enabled = true; // 이펙트 예산이 부족하면 글로우 패스를 생략
+
+    // 글로우 스프라이트 한 장으로 그리기 (scale은 펄스 애니메이션용 배율)
+    void draw(sf::RenderTarget& target, const sf::Font& font, unsigned size,
+              const char* text, size_t length, float radius,
+              sf::Vector2f position, sf::Color color, float scale) {
+        if(!enabled) return;
+        const Glow& glow = get(font, size, text, length, std::max(1, static_cast<int>(radius + 0.5f)));
+        sf::Sprite sprite(glow.texture);
+        sprite.setColor(color);
+        sprite.setScale(scale, scale);
+        sprite.setPosition(position.x - glow.padding * scale, position.y - glow.padding * scale);
+        drawCounted(target, sprite);
+    }
+};
 
 // 향상된 텍스트 렌더러 클래스
 class TextRenderer {
 private:
     const FontManager& fontManager;
     const DisplaySettings& display;
+    GlowCache& glowCache;
     
 public:
-    TextRenderer(const FontManager& fm, const DisplaySettings& ds) 
-        : fontManager(fm), display(ds) {}
+    TextRenderer(const FontManager& fm, const DisplaySettings& ds, GlowCache& gc) 
+        : fontManager(fm), display(ds), glowCache(gc) {}
     
     enum TextStyle {
         NORMAL,
@@ -172,7 +469,7 @@ public:
         RETRO
     };
     
-    void drawText(sf::RenderWindow& window, const string& text, 
+    void drawText(sf::RenderTarget& target, const string& text, 
                   const string& fontCategory, int baseSize,
                   sf::Vector2f position, sf::Color color,
                   TextStyle style = NORMAL, float scale = 1.0f,
@@ -194,7 +491,7 @@ public:
                 shadow.setFillColor(sf::Color(0, 0, 0, 120));
                 shadow.setPosition(scaledPos.x + 2 * display.scaleFactor, 
                                  scaledPos.y + 2 * display.scaleFactor);
-                window.draw(shadow);
+                drawCounted(target, shadow);
                 break;
             }
             case OUTLINED: {
@@ -203,22 +500,11 @@ public:
                 break;
             }
             case GLOWING: {
-                // 글로우 효과를 위한 여러 레이어
-                for(int i = 1; i <= 3; i++) {
-                    sf::Text glow = textObj;
-                    sf::Color glowColor = color;
-                    glowColor.a = static_cast<sf::Uint8>(60 / i);
-                    glow.setFillColor(glowColor);
-                    float offset = i * 2.0f * display.scaleFactor;
-                    for(int dx = -1; dx <= 1; dx++) {
-                        for(int dy = -1; dy <= 1; dy++) {
-                            if(dx == 0 && dy == 0) continue;
-                            glow.setPosition(scaledPos.x + dx * offset, 
-                                           scaledPos.y + dy * offset);
-                            window.draw(glow);
-                        }
-                    }
-                }
+                // 미리 구워둔 글로우 텍스처를 펄스 배율로 한 번만 그림
+                unsigned bakeSize = static_cast<unsigned>(baseSize * display.scaleFactor);
+                glowCache.draw(target, fontManager.getFont(fontCategory), bakeSize,
+                               text.data(), text.size(), 2.0f * display.scaleFactor,
+                               scaledPos, color, scale);
                 break;
             }
             case RETRO: {
@@ -231,10 +517,10 @@ public:
         
         textObj.setFillColor(color);
         textObj.setPosition(scaledPos);
-        window.draw(textObj);
+        drawCounted(target, textObj);
     }
     
-    void drawCenteredText(sf::RenderWindow& window, const string& text,
+    void drawCenteredText(sf::RenderTarget& target, const string& text,
                          const string& fontCategory, int baseSize,
                          sf::Vector2f centerPos, sf::Color color,
                          TextStyle style = NORMAL, float scale = 1.0f,
@@ -251,7 +537,190 @@ public:
             centerPos.y - bounds.height / 2
         );
         
-        drawText(window, text, fontCategory, baseSize, adjustedPos, color, style, scale, gameOffset);
+        drawText(target, text, fontCategory, baseSize, adjustedPos, color, style, scale, gameOffset);
+    }
+};
+
+// 숫자 전용 렌더러 - 문자열 변환/할당 없이 정수를 글리프 정점으로 직접 기록
+class DigitRenderer {
+private:
+    static const int FIRST_CHAR = 32;
+    static const int LAST_CHAR = 126;
+    static const int GLYPH_COUNT = LAST_CHAR - FIRST_CHAR + 1;
+
+    // 폰트 + 크기 + 외곽선 두께별로 미리 래스터화한 글리프 세트
+    struct GlyphKey {
+        const sf::Font* font;
+        unsigned size;
+        int outline; // 외곽선 두께 (1/4 픽셀 단위)
+
+        bool operator==(const GlyphKey& o) const {
+            return font == o.font && size == o.size && outline == o.outline;
+        }
+    };
+
+    struct GlyphKeyHash {
+        size_t operator()(const GlyphKey& k) const {
+            size_t h = std::hash<const void*>()(k.font);
+            h ^= (static_cast<size_t>(k.size) << 8) ^ static_cast<size_t>(k.outline);
+            return h;
+        }
+    };
+
+    struct GlyphSet {
+        array<sf::Glyph, GLYPH_COUNT> fill;
+        array<sf::Glyph, GLYPH_COUNT> outline;
+        array<bool, GLYPH_COUNT> ready{};
+    };
+
+    const FontManager& fontManager;
+    const DisplaySettings& display;
+    GlowCache& glowCache;
+    unordered_map<GlyphKey, GlyphSet, GlyphKeyHash> glyphSets;
+    sf::VertexArray vertices;
+
+    GlyphSet& getGlyphSet(const sf::Font& font, unsigned size, float outlineThickness) {
+        GlyphKey key{&font, size, static_cast<int>(outlineThickness * 4.0f + 0.5f)};
+        auto it = glyphSets.find(key);
+        if(it != glyphSets.end()) return it->second;
+
+        GlyphSet& set = glyphSets[key];
+        // 숫자와 자주 쓰는 기호는 처음 사용할 때 한 번에 래스터화
+        for(const char* p = "0123456789+-/%:x"; *p; ++p) {
+            loadGlyph(set, font, size, outlineThickness, *p);
+        }
+        return set;
+    }
+
+    void loadGlyph(GlyphSet& set, const sf::Font& font, unsigned size, float outlineThickness, char c) {
+        int index = c - FIRST_CHAR;
+        set.fill[index] = font.getGlyph(static_cast<sf::Uint32>(c), size, false);
+        if(outlineThickness > 0) {
+            set.outline[index] = font.getGlyph(static_cast<sf::Uint32>(c), size, false, outlineThickness);
+        }
+        set.ready[index] = true;
+    }
+
+    // sf::Text와 동일한 방식으로 글리프 하나의 사각형(삼각형 2개)을 추가
+    void addGlyphQuad(sf::Vector2f pos, sf::Color color, const sf::Glyph& glyph) {
+        const float padding = 1.0f;
+
+        float left   = pos.x + glyph.bounds.left - padding;
+        float top    = pos.y + glyph.bounds.top - padding;
+        float right  = pos.x + glyph.bounds.left + glyph.bounds.width + padding;
+        float bottom = pos.y + glyph.bounds.top + glyph.bounds.height + padding;
+
+        float u1 = static_cast<float>(glyph.textureRect.left) - padding;
+        float v1 = static_cast<float>(glyph.textureRect.top) - padding;
+        float u2 = static_cast<float>(glyph.textureRect.left + glyph.textureRect.width) + padding;
+        float v2 = static_cast<float>(glyph.textureRect.top + glyph.textureRect.height) + padding;
+
+        vertices.append(sf::Vertex(sf::Vector2f(left, top), color, sf::Vector2f(u1, v1)));
+        vertices.append(sf::Vertex(sf::Vector2f(right, top), color, sf::Vector2f(u2, v1)));
+        vertices.append(sf::Vertex(sf::Vector2f(left, bottom), color, sf::Vector2f(u1, v2)));
+        vertices.append(sf::Vertex(sf::Vector2f(left, bottom), color, sf::Vector2f(u1, v2)));
+        vertices.append(sf::Vertex(sf::Vector2f(right, top), color, sf::Vector2f(u2, v1)));
+        vertices.append(sf::Vertex(sf::Vector2f(right, bottom), color, sf::Vector2f(u2, v2)));
+    }
+
+    // 문자 버퍼 한 줄을 정점으로 변환 (useOutline이면 외곽선 글리프 사용)
+    void addLine(GlyphSet& set, const sf::Font& font, unsigned size, float outlineThickness,
+                 const char* chars, int count, sf::Vector2f origin, sf::Color color, bool useOutline) {
+        sf::Vector2f pen(origin.x, origin.y + static_cast<float>(size));
+        for(int i = 0; i < count; i++) {
+            char c = chars[i];
+            if(c < FIRST_CHAR || c > LAST_CHAR) continue;
+            int index = c - FIRST_CHAR;
+            if(!set.ready[index]) {
+                loadGlyph(set, font, size, outlineThickness, c);
+            }
+            const sf::Glyph& glyph = set.fill[index];
+            if(c != ' ') {
+                addGlyphQuad(pen, color, useOutline ? set.outline[index] : glyph);
+            }
+            pen.x += glyph.advance;
+        }
+    }
+
+public:
+    DigitRenderer(const FontManager& fm, const DisplaySettings& ds, GlowCache& gc)
+        : fontManager(fm), display(ds), glowCache(gc), vertices(sf::Triangles) {}
+
+    // prefix/suffix는 정적 문자열 리터럴 ("+", "/25", " COMBO!" 등)
+    void drawNumber(sf::RenderTarget& target, long long value,
+                    const string& fontCategory, int baseSize,
+                    sf::Vector2f position, sf::Color color,
+                    TextRenderer::TextStyle style = TextRenderer::NORMAL, float scale = 1.0f,
+                    sf::Vector2f gameOffset = sf::Vector2f(0, 0),
+                    const char* prefix = "", const char* suffix = "") {
+
+        if(!fontManager.isLoaded()) return;
+
+        unsigned scaledSize = static_cast<unsigned>(std::max(0, static_cast<int>(baseSize * display.scaleFactor * scale)));
+        if(scaledSize == 0) return;
+        sf::Vector2f scaledPos(
+            position.x * display.scaleFactor + gameOffset.x,
+            position.y * display.scaleFactor + gameOffset.y
+        );
+
+        // 정수 -> 문자 버퍼 (스택, 할당 없음)
+        char chars[64];
+        int count = 0;
+        for(const char* p = prefix; *p && count < 24; ++p) chars[count++] = *p;
+
+        char digits[24];
+        int digitCount = 0;
+        unsigned long long magnitude = value < 0 ? 0ULL - static_cast<unsigned long long>(value)
+                                                 : static_cast<unsigned long long>(value);
+        do {
+            digits[digitCount++] = static_cast<char>('0' + magnitude % 10);
+            magnitude /= 10;
+        } while(magnitude > 0);
+        if(value < 0) chars[count++] = '-';
+        while(digitCount > 0) chars[count++] = digits[--digitCount];
+
+        for(const char* p = suffix; *p && count < 64; ++p) chars[count++] = *p;
+
+        float outlineThickness = 0.0f;
+        sf::Color outlineColor = sf::Color::Black;
+        if(style == TextRenderer::OUTLINED) {
+            outlineThickness = 1.5f * display.scaleFactor;
+            outlineColor = sf::Color(0, 0, 0, 200);
+        } else if(style == TextRenderer::RETRO) {
+            outlineThickness = 1.0f * display.scaleFactor;
+        }
+
+        const sf::Font& font = fontManager.getFont(fontCategory);
+        GlyphSet& set = getGlyphSet(font, scaledSize, outlineThickness);
+
+        vertices.clear();
+
+        switch(style) {
+            case TextRenderer::SHADOWED: {
+                sf::Vector2f shadowPos(scaledPos.x + 2 * display.scaleFactor,
+                                       scaledPos.y + 2 * display.scaleFactor);
+                addLine(set, font, scaledSize, outlineThickness, chars, count, shadowPos, sf::Color(0, 0, 0, 120), false);
+                break;
+            }
+            case TextRenderer::GLOWING: {
+                // TextRenderer와 같은 캐시된 글로우 텍스처 사용
+                unsigned bakeSize = static_cast<unsigned>(baseSize * display.scaleFactor);
+                glowCache.draw(target, font, bakeSize, chars, static_cast<size_t>(count),
+                               2.0f * display.scaleFactor, scaledPos, color, scale);
+                break;
+            }
+            default:
+                break;
+        }
+
+        if(outlineThickness > 0) {
+            addLine(set, font, scaledSize, outlineThickness, chars, count, scaledPos, outlineColor, true);
+        }
+        addLine(set, font, scaledSize, outlineThickness, chars, count, scaledPos, color, false);
+
+        sf::RenderStates states;
+        states.texture = &font.getTexture(scaledSize);
+        drawCounted(target, vertices, states);
     }
 };
 
@@ -316,137 +785,260 @@ struct Particle {
     }
 };
 
+// 떠오르는 점수 (움직임은 Board의 타임라인 값 칸에서 읽음)
 struct ScoreEffect {
-    sf::Vector2f position;
-    sf::Vector2f velocity;
+    static constexpr float LIFE = 3.0f;
+
+    sf::Vector2f position;        // 시작 위치
     int score;
-    float life;
-    float maxLife;
     sf::Color color;
-    float scale;
-    float bounce = 0.0f;
-    
-    ScoreEffect(sf::Vector2f pos, int points, sf::Color col) 
-        : position(pos), velocity(0, -120), score(points), life(3.0f), maxLife(3.0f), color(col), scale(0.8f) {}
-        
-    bool update(float dt) {
-        position += velocity * dt;
-        life -= dt;
-        
-        bounce += dt * 8.0f;
-        velocity.y += 30.0f * dt;
-        
-        if (life > maxLife * 0.8f) {
-            scale += dt * 3.0f;
-        } else if (life < maxLife * 0.3f) {
-            scale -= dt * 1.5f;
-        }
-        scale = std::max(0.1f, scale);
-        
-        float alpha = std::pow(life / maxLife, 0.5f) * 255.0f;
-        color.a = static_cast<sf::Uint8>(std::max(0.0f, alpha));
-        
-        return life > 0;
+    int rise, scale, alpha, bounce;
+
+    // 3초 동안 감속하며 떠오르고, 처음 0.6초 커졌다 마지막 0.9초 작아지며 흐려짐
+    void start(tween::Timeline& t) {
+        for(int track : { rise, scale, alpha, bounce }) t.cancel(track);
+        t.play(rise, t.value(rise), t.value(rise) - 225.0f, LIFE, tween::OUT_QUAD);
+        t.play(scale, t.value(scale), 2.6f, 0.6f);
+        t.play(scale, 2.6f, 1.25f, 0.9f, tween::LINEAR, LIFE - 0.9f);
+        t.play(alpha, 255.0f, 0.0f, LIFE, tween::IN_SQRT);
+        t.wave(bounce, 0.0f, 3.0f, 6.28318531f / 8.0f, LIFE);
     }
 };
 
-// 뿌요쌍 구조체
-struct PuyoPair {
-    Vec2 pivot;
-    Vec2 sub;
-    Color c1, c2;
-    float animationTimer = 0.0f;
+// 이펙트 예산 관리자 - 최근 작업 시간에 따라 파티클/글로우/화면 흔들림 디테일을 조절
+class EffectBudget {
+private:
+    static const int HISTORY = 30;
+    array<float, HISTORY> workTimes{};
+    int historyIndex = 0;
+    int historyCount = 0;
+    int headroomFrames = 0;
+    float detail = 1.0f;
+    int spawnedThisFrame = 0;
+
+public:
+    static constexpr float MIN_DETAIL = 0.2f;
+
+    float frameBudget = 1.0f / 60.0f; // 목표 프레임 시간 (초)
+    int maxParticles = 800;           // 최대 디테일에서 동시에 살아있는 파티클 수
+    int maxSpawnPerFrame = 300;       // 한 프레임에 새로 만들 수 있는 파티클 수
+    int maxScoreEffects = 24;
+
+    void beginFrame() { spawnedThisFrame = 0; }
+
+    // 업데이트+렌더링에 걸린 시간(vsync 대기 제외)을 기록하고 디테일 조정
+    void recordFrame(float workTime) {
+        workTimes[historyIndex] = workTime;
+        historyIndex = (historyIndex + 1) % HISTORY;
+        historyCount = std::min(historyCount + 1, HISTORY);
+
+        float sum = 0.0f;
+        for(int i = 0; i < historyCount; i++) sum += workTimes[i];
+        float average = sum / historyCount;
+
+        // 예산에 근접하면 즉시 낮추고, 여유가 계속될 때만 천천히 복구
+        if(workTime > frameBudget * 0.75f || average > frameBudget * 0.6f) {
+            detail = std::max(MIN_DETAIL, detail * 0.8f);
+            headroomFrames = 0;
+        } else if(average < frameBudget * 0.4f) {
+            if(++headroomFrames >= HISTORY) {
+                detail = std::min(1.0f, detail + 0.05f);
+                headroomFrames = HISTORY / 2;
+            }
+        } else {
+            headroomFrames = 0;
+        }
+    }
+
+    float detailLevel() const { return detail; }
+
+    // 요청한 파티클 수 중 이번 프레임에 허용되는 수 (0이면 생략)
+    int allowParticles(int requested, size_t live) {
+        int wanted = std::max(1, static_cast<int>(std::round(requested * detail)));
+        int capacity = particleCapacity() - static_cast<int>(live);
+        int frameLeft = static_cast<int>(maxSpawnPerFrame * detail) - spawnedThisFrame;
+        int allowed = std::max(0, std::min(wanted, std::min(capacity, frameLeft)));
+        spawnedThisFrame += allowed;
+        return allowed;
+    }
+
+    int particleCapacity() const { return static_cast<int>(maxParticles * detail); }
+    size_t scoreEffectLimit() const { return static_cast<size_t>(std::max(4, static_cast<int>(maxScoreEffects * detail))); }
+    bool glowEnabled() const { return detail >= 0.5f; }
+    float shakeScale() const { return detail; }
+    size_t particlePointCount() const { return detail >= 0.75f ? 16 : detail >= 0.4f ? 10 : 6; }
 };
 
-// 유틸 함수들
-bool inBounds(int x, int y) { return x >= 0 && x < COLS && y >= 0 && y < ROWS; }
+// 대기 화면 절전 - 메뉴/일시정지/게임 오버/순위표에서 입력도 이펙트도 없으면
+// 애니메이션을 idleFps로만 그리고 그 사이에는 잠듦 (입력은 POLL 간격으로 확인)
+class IdleGovernor {
+private:
+    sf::Clock wall;
+    float lastInput = 0.0f;
+    float lastIdleFrame = -1e9f;
+    float lastCheck = 0.0f;
+    bool idle = false;
+    bool woke = false;
+
+public:
+    static constexpr float GRACE = 0.5f;    // 마지막 입력 후 전속으로 그리는 시간
+    static constexpr float POLL = 0.015f;   // 잠든 동안 입력 확인 간격 (입력 지연 상한)
+
+    float idleFps = 10.0f;                  // 0이면 절전하지 않음
+
+    // 내장 카운터 (종료 시 report)
+    uint64_t activeFrames = 0, idleFrames = 0, wakeups = 0;
+    double idleSeconds = 0.0, sleptSeconds = 0.0, idleWorkSeconds = 0.0;
 
+    void onInput() { lastInput = wall.getElapsedTime().asSeconds(); }
+
+    // 이번 반복을 그리지 않고 잤으면 true. idleScreen: 대기 화면이고 진행 중인 이펙트가 없음
+    bool rest(bool idleScreen) {
+        float now = wall.getElapsedTime().asSeconds();
+        if(idle) idleSeconds += now - lastCheck;
+        lastCheck = now;
+
+        if(!idleScreen || idleFps <= 0.0f || now - lastInput < GRACE) {
+            if(idle) {
+                idle = false;
+                woke = true;
+                wakeups++;
+            }
+            return false;
+        }
+        idle = true;
+        float interval = 1.0f / idleFps;
+        float untilFrame = lastIdleFrame + interval - now;
+        if(untilFrame <= 0.0f) {
+            lastIdleFrame = now;
+            return false;
+        }
+        sf::Clock slept;
+        sf::sleep(sf::seconds(std::min(POLL, untilFrame)));
+        sleptSeconds += slept.getElapsedTime().asSeconds();
+        return true;
+    }
+
+    bool isIdle() const { return idle; }
+
+    // 잠에서 깬 첫 프레임 (dt에 잠든 시간이 섞이지 않도록)
+    bool consumeWake() {
+        bool w = woke;
+        woke = false;
+        return w;
+    }
+
+    void frameRendered(float workTime) {
+        if(idle) {
+            idleFrames++;
+            idleWorkSeconds += workTime;
+        } else {
+            activeFrames++;
+        }
+    }
+
+    void report() const {
+        double total = wall.getElapsedTime().asSeconds();
+        fprintf(stderr, "[idle] %.1f s of %.1f s idle, %llu idle frames (%.1f fps), busy %.2f%% while idle, "
+                        "%llu wakeups, %llu active frames\n",
+                idleSeconds, total, (unsigned long long)idleFrames,
+                idleSeconds > 0 ? idleFrames / idleSeconds : 0.0,
+                idleSeconds > 0 ? 100.0 * (idleSeconds - sleptSeconds) / idleSeconds : 0.0,
+                (unsigned long long)wakeups, (unsigned long long)activeFrames);
+    }
+};
+
+// 유틸 함수들 (이펙트용 난수 - 게임 진행 난수는 PuyoRng)
 std::mt19937& rng() {
     static std::mt19937 gen(static_cast<unsigned>(time(nullptr)));
     return gen;
 }
 
-Color randomColor() {
-    std::uniform_int_distribution<int> dist(1, COLOR_COUNT-1);
-    return static_cast<Color>(dist(rng()));
-}
-
 float randomFloat(float min, float max) {
     std::uniform_real_distribution<float> dist(min, max);
     return dist(rng());
 }
 
-// 보드 클래스 (스케일링 적용)
-struct Board {
-    array<array<Color, COLS>, ROWS> g{};
-    int score = 0;
-    int chain = 0;
-    int level = 1;
-    int totalLinesCleared = 0;
-    int combo = 0;
-    float comboTimer = 0.0f;
-    
+// 보드 클래스 (규칙은 BoardCore, 여기서는 이펙트와 스케일링 담당)
+struct Board : BoardCore {
     vector<Particle> particles;
     vector<ScoreEffect> scoreEffects;
-    float screenShake = 0.0f;
-    float levelUpEffect = 0.0f;
-    float chainDisplayTimer = 0.0f;
     int currentChain = 0;
+
+    // 이펙트 타이머와 맥동은 모두 타임라인 값 칸 (렌더링은 값만 읽음)
+    tween::Timeline timeline;
+    int shakeTrack, levelUpTrack, chainScaleTrack, comboPulseTrack, spawnTrack, pivotPulseTrack;
+    
+    // 연쇄 잠재력 (잠금 후 증분 갱신, HUD 표시용)
+    chain::ChainAnalyzer chainAnalyzer;
     
     const DisplaySettings& display;
+    EffectBudget& budget;
     
-    Board(const DisplaySettings& ds) : display(ds) { 
+    Board(const DisplaySettings& ds, EffectBudget& eb) : display(ds), budget(eb) { 
+        shakeTrack = timeline.track();
+        levelUpTrack = timeline.track();
+        chainScaleTrack = timeline.track();
+        comboPulseTrack = timeline.track(1.0f);
+        spawnTrack = timeline.track(1.0f);
+        pivotPulseTrack = timeline.track();
         clear(); 
         particles.reserve(200);
         scoreEffects.reserve(50);
     }
 
     void clear() {
-        for(int y = 0; y < ROWS; ++y) 
-            for(int x = 0; x < COLS; ++x) 
-                g[y][x] = EMPTY;
-        score = 0; chain = 0; level = 1; totalLinesCleared = 0; combo = 0;
-        particles.clear(); scoreEffects.clear();
-        screenShake = 0.0f; levelUpEffect = 0.0f; chainDisplayTimer = 0.0f;
-        currentChain = 0; comboTimer = 0.0f;
+        BoardCore::clear();
+        particles.clear();
+        for(const ScoreEffect& e : scoreEffects) {
+            for(int track : { e.rise, e.scale, e.alpha, e.bounce }) timeline.release(track);
+        }
+        scoreEffects.clear();
+        timeline.stopAll();
+        timeline.set(shakeTrack, 0.0f);
+        timeline.set(comboPulseTrack, 1.0f);
+        timeline.set(spawnTrack, 1.0f);
+        timeline.wave(pivotPulseTrack, 0.0f, 0.05f, 6.28318531f / 10.0f);
+        currentChain = 0;
+        chainAnalyzer.reset();
     }
 
-    bool isEmpty(int x, int y) const {
-        return inBounds(x, y) && g[y][x] == EMPTY;
+    // 화면 흔들림: 초당 2.5씩 줄어듦 (더 센 흔들림만 덮어씀)
+    void shake(float amount) {
+        if(amount <= timeline.value(shakeTrack)) return;
+        timeline.cancel(shakeTrack);
+        timeline.play(shakeTrack, amount, 0.0f, amount / 2.5f);
     }
 
-    bool collision(const PuyoPair& p) const {
-        if(!inBounds(p.pivot.x, p.pivot.y) || g[p.pivot.y][p.pivot.x] != EMPTY) return true;
-        int sx = p.pivot.x + p.sub.x;
-        int sy = p.pivot.y + p.sub.y;
-        if(!inBounds(sx, sy) || g[sy][sx] != EMPTY) return true;
-        return false;
+    void showChain(int chainIndex) {
+        currentChain = chainIndex;
+        timeline.cancel(chainScaleTrack);
+        timeline.play(chainScaleTrack, 1.6f, 1.2f, 2.5f);
     }
 
-    void lock(const PuyoPair& p) {
-        if(inBounds(p.pivot.x, p.pivot.y)) {
-            g[p.pivot.y][p.pivot.x] = p.c1;
-        }
-        int sx = p.pivot.x + p.sub.x;
-        int sy = p.pivot.y + p.sub.y;
-        if(inBounds(sx, sy)) {
-            g[sy][sx] = p.c2;
-        }
+    void showCombo() {
+        timeline.cancel(comboPulseTrack);
+        timeline.wave(comboPulseTrack, 1.0f, 0.1f, 6.28318531f / 8.0f, 4.0f);
     }
 
-    void applyGravity() {
-        for(int x = 0; x < COLS; ++x) {
-            int write = ROWS - 1;
-            for(int y = ROWS - 1; y >= 0; --y) {
-                if(g[y][x] != EMPTY) {
-                    Color c = g[y][x];
-                    g[y][x] = EMPTY;
-                    g[write][x] = c;
-                    write--;
-                }
-            }
-        }
+    void showLevelUp() {
+        timeline.cancel(levelUpTrack);
+        timeline.play(levelUpTrack, 1.0f, 0.0f, 4.0f);
+    }
+
+    // 새 조각이 나올 때 0.25초 동안 커지며 등장
+    void spawnPiece() {
+        timeline.cancel(spawnTrack);
+        timeline.play(spawnTrack, 0.5f, 1.0f, 0.25f);
     }
+
+    bool chainShowing() const { return timeline.active(chainScaleTrack); }
+    bool comboShowing() const { return timeline.active(comboPulseTrack); }
+    bool levelUpShowing() const { return timeline.active(levelUpTrack); }
+    float chainScale() const { return timeline.value(chainScaleTrack); }
+    float comboScale() const { return timeline.value(comboPulseTrack); }
+    float pieceScale() const { return timeline.value(spawnTrack); }
+    float pivotPulse() const { return timeline.value(pivotPulseTrack); }
     
     sf::Color getPuyoColor(Color c) const {
         switch(c) {
@@ -467,7 +1059,7 @@ struct Board {
         );
         sf::Color particleColor = getPuyoColor(color);
         
-        int particleCount = 15;
+        int particleCount = budget.allowParticles(15, particles.size());
         particles.reserve(particles.size() + particleCount);
         
         for(int i = 0; i < particleCount; i++) {
@@ -479,7 +1071,7 @@ struct Board {
                                  randomFloat(1.2f, 2.5f), randomFloat(4, 8) * display.scaleFactor);
         }
         
-        screenShake = std::max(screenShake, 0.5f);
+        shake(0.5f * budget.shakeScale());
     }
     
     void createScoreEffect(int x, int y, int points, int chainIndex) {
@@ -495,90 +1087,43 @@ struct Board {
         else if(chainIndex >= 2) color = sf::Color::Yellow;
         else if(points > 300) color = sf::Color::Cyan;
         
-        scoreEffects.emplace_back(position, points, color);
-    }
-
-    int calculateScore(int removed, int chainIndex, int groupCount) {
-        int baseScore = removed * removed * 20;
-        int chainBonus = 0;
-        if(chainIndex >= 2) {
-            chainBonus = (1 << (chainIndex-1)) * 120;
+        // 예산 초과 시 새 이펙트 대신 가장 최근 이펙트에 점수를 합침
+        if(!scoreEffects.empty() && scoreEffects.size() >= budget.scoreEffectLimit()) {
+            ScoreEffect& latest = scoreEffects.back();
+            latest.score += points;
+            latest.color = color;
+            latest.start(timeline);
+            return;
         }
-        int colorBonus = groupCount > 1 ? groupCount * groupCount * 100 : 0;
-        int massBonus = removed >= 10 ? (removed - 9) * 80 : 0;
-        int levelBonus = level * 10;
         
-        return baseScore + chainBonus + colorBonus + massBonus + levelBonus;
+        ScoreEffect e{ position, points, color, timeline.track(), timeline.track(0.8f), timeline.track(), timeline.track() };
+        e.start(timeline);
+        scoreEffects.push_back(e);
     }
 
-    // popGroupsAndScore, getFallSpeed, isGameOver, updateEffects 메서드들은 기존과 동일...
-    
+    // 규칙 처리 후 제거된 셀/점수/레벨업에 맞춰 이펙트 생성
     int popGroupsAndScore(int chainIndex) {
-        vector<vector<bool>> vis(ROWS, vector<bool>(COLS, false));
-        int removedTotal = 0;
-        int groupCount = 0;
-        vector<Vec2> removedPositions;
-
-        for(int y = 0; y < ROWS; ++y) {
-            for(int x = 0; x < COLS; ++x) {
-                if(g[y][x] == EMPTY || vis[y][x]) continue;
-                Color c = g[y][x];
-
-                vector<Vec2> group;
-                queue<Vec2> q;
-                q.push({x, y});
-                vis[y][x] = true;
-                
-                while(!q.empty()) {
-                    auto [cx, cy] = q.front(); q.pop();
-                    group.push_back({cx, cy});
-                    const int dx[4] = {1, -1, 0, 0};
-                    const int dy[4] = {0, 0, 1, -1};
-                    for(int i = 0; i < 4; ++i) {
-                        int nx = cx + dx[i], ny = cy + dy[i];
-                        if(inBounds(nx, ny) && !vis[ny][nx] && g[ny][nx] == c) {
-                            vis[ny][nx] = true;
-                            q.push({nx, ny});
-                        }
-                    }
-                }
+        int removedTotal = BoardCore::popGroupsAndScore(chainIndex);
 
-                if(static_cast<int>(group.size()) >= 4) {
-                    for(auto &v : group) {
-                        g[v.y][v.x] = EMPTY;
-                        removedPositions.push_back(v);
-                        createExplosionEffect(v.x, v.y, c);
-                    }
-                    removedTotal += static_cast<int>(group.size());
-                    groupCount++;
-                }
-            }
+        for(int i = 0; i < poppedCount; i++) {
+            createExplosionEffect(poppedCells[i].x, poppedCells[i].y, poppedColors[i]);
         }
 
         if(removedTotal > 0) {
-            int totalPoints = calculateScore(removedTotal, chainIndex, groupCount);
-            score += totalPoints;
-            combo++;
-            comboTimer = 4.0f;
-            totalLinesCleared += groupCount;
+            showCombo();
             
-            if(chainIndex > 1) {
-                currentChain = chainIndex;
-                chainDisplayTimer = 2.5f;
-            }
+            if(chainIndex > 1) showChain(chainIndex);
             
-            if(!removedPositions.empty()) {
-                Vec2 center = removedPositions[removedPositions.size()/2];
-                createScoreEffect(center.x, center.y, totalPoints, chainIndex);
+            if(poppedCount > 0) {
+                Vec2 center = poppedCells[poppedCount/2];
+                createScoreEffect(center.x, center.y, lastPoints, chainIndex);
             }
             
-            int newLevel = std::min(25, (score / 1200) + 1);
-            if(newLevel > level) {
-                level = newLevel;
-                score += level * 150;
-                levelUpEffect = 4.0f;
+            if(leveledUp) {
+                showLevelUp();
                 
-                for(int i = 0; i < 80; i++) {
+                int burstCount = budget.allowParticles(80, particles.size());
+                for(int i = 0; i < burstCount; i++) {
                     float angle = randomFloat(0, 2 * 3.14159f);
                     float speed = randomFloat(200, 400) * display.scaleFactor;
                     sf::Vector2f pos(
@@ -589,29 +1134,11 @@ struct Board {
                     particles.emplace_back(pos, vel, sf::Color(255, 215, 0), 3.0f, 12 * display.scaleFactor);
                 }
             }
-        } else {
-            combo = 0;
         }
         
         return removedTotal;
     }
     
-    float getFallSpeed() const {
-        const float speeds[] = {
-            1.2f, 1.0f, 0.85f, 0.7f, 0.6f, 0.5f, 0.42f, 0.36f, 0.3f, 0.25f,
-            0.22f, 0.19f, 0.16f, 0.14f, 0.12f, 0.1f, 0.085f, 0.07f, 0.06f, 0.05f,
-            0.04f, 0.035f, 0.03f, 0.025f, 0.02f
-        };
-        return speeds[std::min(level-1, 24)];
-    }
-    
-    bool isGameOver() const {
-        for(int x = 0; x < COLS; ++x) {
-            if(g[1][x] != EMPTY) return true;
-        }
-        return false;
-    }
-    
     void updateEffects(float dt) {
         if(!particles.empty()) {
             particles.erase(
@@ -619,23 +1146,37 @@ struct Board {
                     [dt](Particle& p) { return !p.update(dt); }),
                 particles.end()
             );
+            
+            // 디테일이 낮아지면 오래된 파티클부터 정리
+            int capacity = budget.particleCapacity();
+            if(static_cast<int>(particles.size()) > capacity) {
+                particles.erase(particles.begin(), particles.begin() + (particles.size() - capacity));
+            }
         }
         
+        timeline.advance(dt);
+
+        // 페이드가 끝난 점수 이펙트는 값 칸을 돌려줌
         if(!scoreEffects.empty()) {
             scoreEffects.erase(
                 std::remove_if(scoreEffects.begin(), scoreEffects.end(),
-                    [dt](ScoreEffect& e) { return !e.update(dt); }),
+                    [this](const ScoreEffect& e) {
+                        if(timeline.active(e.alpha)) return false;
+                        for(int track : { e.rise, e.scale, e.alpha, e.bounce }) timeline.release(track);
+                        return true;
+                    }),
                 scoreEffects.end()
             );
         }
-        
-        screenShake = std::max(0.0f, screenShake - dt * 2.5f);
-        levelUpEffect = std::max(0.0f, levelUpEffect - dt);
-        chainDisplayTimer = std::max(0.0f, chainDisplayTimer - dt);
-        comboTimer = std::max(0.0f, comboTimer - dt);
     }
     
+    // 아직 움직이는 이펙트가 있는지 (대기 화면 절전 판단용)
+    bool effectsActive() const {
+        return !particles.empty() || timeline.busy();
+    }
+
     sf::Vector2f getShakeOffset() const {
+        float screenShake = timeline.value(shakeTrack);
         if(screenShake <= 0) return sf::Vector2f(0, 0);
         
         float intensity = screenShake * 6.0f * display.scaleFactor;
@@ -646,195 +1187,346 @@ struct Board {
     }
 };
 
-// 회전 함수들
-Vec2 rotateCW(const Vec2& v) { return Vec2{ -v.y, v.x }; }
-Vec2 rotateCCW(const Vec2& v) { return Vec2{ v.y, -v.x }; }
+// 퍼즐 모드 진행 상태 (--puzzle=FILE[:N])
+struct PuzzleSession {
+    enum Status { RUNNING, CLEARED, FAILED };
+
+    bool active = false;
+    puzzle::Puzzle current;
+    int index = 0;
+    int placed = 0;
+    Status status = RUNNING;
+
+    // i번째 조각 (조각이 다 떨어지면 빈 쌍: NEXT 칸이 비어 보임)
+    PuyoPair piece(int i) const {
+        PuyoPair p;
+        p.pivot = { COLS/2, 0 };
+        p.sub = { 0, -1 };
+        bool has = i < static_cast<int>(current.pieces.size());
+        p.c1 = has ? current.pieces[i].c1 : EMPTY;
+        p.c2 = has ? current.pieces[i].c2 : EMPTY;
+        return p;
+    }
 
-bool wallKick(Board& b, PuyoPair& p) {
-    if(!b.collision(p)) return true;
-    
-    vector<Vec2> kickTests = {{-1, 0}, {1, 0}, {-2, 0}, {2, 0}, {0, -1}};
-    
-    for(const auto& kick : kickTests) {
-        PuyoPair test = p;
-        test.pivot.x += kick.x;
-        test.pivot.y += kick.y;
-        if(!b.collision(test)) {
-            p = test;
+    int piecesLeft() const { return static_cast<int>(current.pieces.size()) - placed; }
+
+    // 조각 하나를 놓고 연쇄가 끝난 뒤 호출. 퍼즐이 끝났으면 true
+    bool onPlaced(int chains) {
+        placed++;
+        if(placed >= static_cast<int>(current.pieces.size())) {
+            status = chains >= current.targetChain ? CLEARED : FAILED;
+            return true;
+        }
+        if(chains > 0) {
+            status = FAILED;  // 마지막 조각 전에 터뜨리면 실패
             return true;
         }
+        return false;
     }
-    return false;
-}
+};
 
-PuyoPair makeSpawnPair() {
-    PuyoPair p;
-    p.pivot = { COLS/2, 0 };
-    p.sub = { 0, -1 };
-    p.c1 = randomColor();
-    p.c2 = randomColor();
-    p.animationTimer = 0.0f;
-    return p;
-}
+// 패턴 라이브러리 힌트 (--patterns=FILE, H 키): 추천 배치를 잠시 반투명으로 표시
+struct PatternHint {
+    static constexpr float SHOW_SECONDS = 3.0f;
+
+    patterns::PatternLibrary library;
+    float timer = 0.0f;       // 0이면 숨김
+    Vec2 cells[2];
+    Color colors[2];
+    std::string name;
+    std::string keys;         // 추천 배치까지의 최소 입력
+    int filled = 0, total = 0, chain = 0;
+    moves::MoveGenerator moveGenerator;
+
+    bool available() const { return library.isOpen(); }
+    bool visible() const { return timer > 0.0f; }
+
+    // 현재 조각의 추천 배치를 찾아 표시 (일치하는 정석이 없으면 false)
+    bool request(const BoardCore& board, const PuyoPair& cur) {
+        timer = 0.0f;
+        if(!available()) return false;
+        const patterns::Entry* e = nullptr;
+        int action = patterns::suggestPlacement(library, board, cur, &e);
+        if(action < 0 || !e) return false;
+
+        BoardCore trial = board;
+        PuyoPair placed = dropPlacement(trial, cur, action / COLS, action % COLS);
+        int n = 0;
+        for(int y = 0; y < ROWS && n < 2; y++)
+            for(int x = 0; x < COLS && n < 2; x++)
+                if(trial.g[y][x] != board.g[y][x]) {
+                    cells[n] = {x, y};
+                    colors[n] = trial.g[y][x];
+                    n++;
+                }
+        if(n < 2) return false;  // 보이는 칸이 하나뿐인 배치는 표시하지 않음
+
+        // 지금 위치에서 그 배치까지 누를 키 (조작 키 표기: < > 이동, Z/X 회전, v 낙하)
+        static const char* const KEY_NAMES[moves::INPUT_COUNT] = {"<", ">", "Z", "X", "v"};
+        keys.clear();
+        if(const moves::Placement* m = moveGenerator.find(board, cur, placed)) {
+            const moves::Input* in = moveGenerator.legalMoves(board, cur).inputsOf(*m);
+            for(int i = 0; i < m->inputCount; i++) {
+                // 연속 낙하는 v*N으로 줄여 표시
+                if(in[i] == moves::IN_DOWN && i > 0 && in[i - 1] == moves::IN_DOWN) continue;
+                int run = 1;
+                while(in[i] == moves::IN_DOWN && i + run < m->inputCount && in[i + run] == moves::IN_DOWN) run++;
+                if(!keys.empty()) keys += ' ';
+                keys += KEY_NAMES[in[i]];
+                if(run > 1) keys += "*" + to_string(run);
+            }
+        }
 
-bool canMove(Board& b, const PuyoPair& p, int dx, int dy) {
-    PuyoPair t = p;
-    t.pivot.x += dx; t.pivot.y += dy;
-    return !b.collision(t);
-}
+        name = library.templateName(e->templateId);
+        filled = e->filled;
+        total = e->total;
+        chain = e->chain;
+        timer = SHOW_SECONDS;
+        return true;
+    }
 
-int main() {
-    // 초기 윈도우 설정
-    DisplaySettings display;
-    FontManager fontManager;
-    
-    // 폰트 로딩
-    bool fontsLoaded = fontManager.loadAllFonts();
-    
-    sf::RenderWindow window(sf::VideoMode(display.windowWidth, display.windowHeight), 
-                           "Enhanced Puyo Puyo Pro - Responsive", 
-                           sf::Style::Titlebar | sf::Style::Close | sf::Style::Resize);
-    window.setFramerateLimit(60);
-    window.setVerticalSyncEnabled(true);
+    void hide() { timer = 0.0f; }
+    void update(float dt) { timer = std::max(0.0f, timer - dt); }
+};
 
-    Board board(display);
-    GameState gameState = MENU;
-    TextRenderer textRenderer(fontManager, display);
+// 점수 기록 (--scores=PREFIX, --player=NAME): 끝난 게임을 저장하고 L 키로 순위표를 보여줌
+struct ScoreBoard {
+    static const int TOP_ROWS = 10;
+    static const int HISTORY_ROWS = 5;
+
+    scores::ScoreStore store;
+    std::string player;
+    vector<uint16_t> replay;      // 이번 게임의 잠금 위치
+    int maxChain = 0;
+    float playTime = 0.0f;
+    uint64_t lastRank = 0;        // 0이면 이번 게임은 기록되지 않음
+    uint64_t lastRecord = 0;
+    bool replayComplete = true;   // 체크포인트에서 이어한 게임은 리플레이가 잘렸을 수 있음 (그러면 기록하지 않음)
+
+    // 순위표 화면용 (열 때 한 번 읽어 둠)
+    vector<scores::Ranked> top, history;
+    float loadMillis = 0.0f;
+
+    bool available() const { return store.isOpen(); }
+
+    void beginGame() {
+        replay.clear();
+        maxChain = 0;
+        playTime = 0.0f;
+        lastRank = 0;
+        replayComplete = true;
+    }
 
-    PuyoPair cur = makeSpawnPair();
-    PuyoPair nextPair = makeSpawnPair();
-    bool alive = true;
+    void onLock(const PuyoPair& p, int chains) {
+        replay.push_back(scores::encodeLock(p));
+        maxChain = std::max(maxChain, chains);
+    }
 
-    float fallTimer = 0.f;
-    InputState leftInput, rightInput, downInput, rotateInput, rotateCCWInput;
+    // CPU가 둔 게임은 "CPU" 이름으로 기록 (사람 순위와 구분)
+    void recordGame(const BoardCore& board, uint32_t seed, bool byCpu) {
+        if(!available() || !replayComplete) return;
+        scores::GameRecord rec{};
+        rec.timestamp = static_cast<uint64_t>(time(nullptr));
+        rec.score = static_cast<uint32_t>(board.score);
+        rec.lines = static_cast<uint32_t>(board.totalLinesCleared);
+        rec.durationMs = static_cast<uint32_t>(playTime * 1000.0f);
+        rec.seed = seed;
+        rec.level = static_cast<uint16_t>(board.level);
+        rec.maxChain = static_cast<uint16_t>(maxChain);
+        std::strncpy(rec.player, byCpu ? "CPU" : player.c_str(), scores::PLAYER_NAME_SIZE);
+        lastRank = store.rankOf(rec.score);
+        if(store.append(rec, replay)) lastRecord = store.count() - 1;
+        else lastRank = 0;
+    }
 
-    sf::Clock clock;
-    float backgroundTime = 0.0f;
+    void refresh() {
+        sf::Clock loadClock;
+        top = store.top(TOP_ROWS);
+        history = store.history(player, HISTORY_ROWS);
+        loadMillis = loadClock.getElapsedTime().asSeconds() * 1000.0f;
+    }
+};
 
-    auto resetGame = [&](){
-        board.clear();
-        cur = makeSpawnPair();
-        nextPair = makeSpawnPair();
-        alive = true;
-        fallTimer = 0;
-        gameState = PLAYING;
-    };
+// CPU 자동 플레이 (--cpu, C 키): 탐색은 워커 스레드에서 돌고, 게임 루프는 결과를 읽어 키 입력으로 옮김
+struct CpuPlayer {
+    static constexpr float STEP_SECONDS = 0.03f;   // 입력 하나 사이 간격 (낙하가 더 빠르면 낙하 간격의 절반)
+
+    bool enabled = false;
+    int threads = 0;
+    ai::EvalWeights weights = ai::EvalWeights::defaults();
+    ai::SearchBudget budget;
+    const patterns::PatternLibrary* library = nullptr;
+    std::unique_ptr<ai::AnytimeSearch> search;
+    moves::MoveGenerator moveGenerator;
+
+    float thinkTimer = 0.0f;      // 남은 생각 시간 (다 쓰면 그때까지의 최선으로 결정)
+    bool thinking = false;
+    bool hasTarget = false;
+    PuyoPair target;              // 결정한 최종 위치
+    bool arrived = false;
+    float stepTimer = 0.0f;
+    ai::SearchStatus decided;     // 마지막 결정 (HUD 표시용)
+
+    void setEnabled(bool on) {
+        enabled = on;
+        if(on && !search) search.reset(new ai::AnytimeSearch(threads, weights, library));
+        if(!on) cancel();
+    }
 
-    while(window.isOpen()) {
-        float dt = clock.restart().asSeconds();
-        backgroundTime += dt;
+    // 새 조각이 나왔을 때 (NEXT가 정해진 순간부터 탐색)
+    void begin(const BoardCore& board, const PuyoPair& cur, const PuyoPair& next) {
+        hasTarget = arrived = false;
+        if(!enabled) return;
+        float seconds = budget.secondsFor(board, cur);
+        search->start(board, cur, next, seconds);
+        thinkTimer = seconds;
+        thinking = true;
+    }
 
-        // 윈도우 크기 변경 감지 및 스케일 업데이트
-        sf::Vector2u currentSize = window.getSize();
-        display.updateScale(currentSize.x, currentSize.y);
-        sf::Vector2f gameOffset = display.getGameOffset(currentSize.x, currentSize.y);
+    void cancel() {
+        if(search) search->cancel();
+        thinking = hasTarget = arrived = false;
+    }
 
-        sf::Event e;
-        while(window.pollEvent(e)) {
-            if(e.type == sf::Event::Closed) window.close();
-            
-            if(e.type == sf::Event::KeyPressed) {
-                if(gameState == MENU) {
-                    if(e.key.code == sf::Keyboard::Space || e.key.code == sf::Keyboard::Return) {
-                        resetGame();
-                    } else if(e.key.code == sf::Keyboard::Escape) {
-                        window.close();
-                    }
-                } else if(gameState == GAME_OVER) {
-                    if(e.key.code == sf::Keyboard::R) {
-                        resetGame();
-                    } else if(e.key.code == sf::Keyboard::Escape) {
-                        gameState = MENU;
-                    }
-                } else if(gameState == PLAYING) {
-                    if(e.key.code == sf::Keyboard::Escape) {
-                        gameState = PAUSED;
-                    }
-                } else if(gameState == PAUSED) {
-                    if(e.key.code == sf::Keyboard::Escape) {
-                        gameState = PLAYING;
-                    } else if(e.key.code == sf::Keyboard::R) {
-                        resetGame();
-                    }
-                }
+    // 목표 위치에 도착함: 게임 루프가 빠른 낙하로 잠금
+    bool wantsDrop() const { return enabled && arrived; }
+
+    // 지금 위치에서 닿는 배치 중 평가값이 가장 높은 것 (목표에 더 이상 닿지 않을 때)
+    void retarget(const BoardCore& board, const PuyoPair& cur) {
+        const moves::MoveList& list = moveGenerator.legalMoves(board, cur);
+        float bestValue = -1e30f;
+        hasTarget = false;
+        for(const moves::Placement& m : list.placements) {
+            BoardCore t = board;
+            t.lock(moves::placedPair(cur, m));
+            t.resolveChains();
+            float value = weights.evaluate(ai::computeFeatures(t, t.score - board.score, library));
+            if(value > bestValue) {
+                bestValue = value;
+                target = moves::placedPair(cur, m);
+                hasTarget = true;
             }
         }
+    }
 
-        // 게임 로직
-        if(gameState == PLAYING && alive) {
-            cur.animationTimer += dt * 4.0f;
-            
-            leftInput.update(dt, sf::Keyboard::isKeyPressed(sf::Keyboard::Left));
-            rightInput.update(dt, sf::Keyboard::isKeyPressed(sf::Keyboard::Right));
-            downInput.update(dt, sf::Keyboard::isKeyPressed(sf::Keyboard::Down));
-            rotateInput.update(dt, sf::Keyboard::isKeyPressed(sf::Keyboard::Up) || 
-                              sf::Keyboard::isKeyPressed(sf::Keyboard::Z));
-            rotateCCWInput.update(dt, sf::Keyboard::isKeyPressed(sf::Keyboard::X) ||
-                                 sf::Keyboard::isKeyPressed(sf::Keyboard::A));
+    // 결정: 탐색 결과(스폰 위치 기준 배치)의 최종 위치를 목표로 삼음
+    void decide(const BoardCore& board, const PuyoPair& cur) {
+        thinking = false;
+        decided = search->status();
+        search->cancel();
+        int action = decided.action >= 0 ? decided.action : ai::choosePlacement(board, cur, weights, library);
+
+        BoardCore trial = board;
+        PuyoPair spawn = cur;
+        spawn.pivot = { COLS/2, 0 };
+        spawn.sub = { 0, -1 };
+        target = dropPlacement(trial, spawn, action / COLS, action % COLS);
+        hasTarget = true;
+        stepTimer = 0.0f;
+    }
 
-            if(leftInput.shouldTrigger() && canMove(board, cur, -1, 0)) {
-                cur.pivot.x -= 1;
+    // 매 프레임: 생각 시간이 끝났거나 조각이 곧 잠기면 결정. 그 뒤로는 입력 간격마다
+    // 지금 위치에서 목표까지의 최소 입력 열을 다시 구해 첫 입력만 실행 (중력에 밀려도 어긋나지 않음)
+    void update(float dt, const BoardCore& board, PuyoPair& cur) {
+        if(!enabled) return;
+        if(thinking) {
+            thinkTimer -= dt;
+            if(thinkTimer > 0.0f && canMove(board, cur, 0, +1)) return;
+            decide(board, cur);
+        }
+        if(!hasTarget || arrived) return;
+        stepTimer -= dt;
+        float interval = std::min(STEP_SECONDS, board.getFallSpeed() * 0.5f);
+        while(stepTimer <= 0.0f && !arrived) {
+            const moves::Placement* m = moveGenerator.find(board, cur, target);
+            if(!m) {
+                retarget(board, cur);
+                m = hasTarget ? moveGenerator.find(board, cur, target) : nullptr;
+                if(!m) return;
             }
-            if(rightInput.shouldTrigger() && canMove(board, cur, +1, 0)) {
-                cur.pivot.x += 1;
+            if(m->inputCount == 0) {
+                arrived = true;
+                return;
             }
+            moves::applyInput(board, cur, moveGenerator.legalMoves(board, cur).inputsOf(*m)[0]);
+            stepTimer += interval;
+        }
+    }
+};
 
-            if(rotateInput.shouldTrigger()) {
-                PuyoPair t = cur;
-                t.sub = rotateCW(t.sub);
-                if(board.collision(t)) {
-                    wallKick(board, t);
-                }
-                cur = t;
-            }
-            
-            if(rotateCCWInput.shouldTrigger()) {
-                PuyoPair t = cur;
-                t.sub = rotateCCW(t.sub);
-                if(board.collision(t)) {
-                    wallKick(board, t);
-                }
-                cur = t;
-            }
+// 진행 중인 게임 체크포인트 (--checkpoint=FILE): 잠금마다, 그리고 몇 프레임마다 논리 상태를 매핑된 파일에 씀.
+// 비정상 종료 후 메뉴에서 R로 이어함 (이펙트/입력 상태는 버림)
+struct GameCheckpoint {
+    static const int EVERY_FRAMES = 10;   // 잠금 사이에는 이 간격으로 (낙하 위치/타이머)
 
-            fallTimer += dt;
-            float curInterval = board.getFallSpeed();
-            
-            if(downInput.shouldTrigger()) {
-                curInterval = 0.02f;
-            }
+    checkpoint::CheckpointFile file;
+    uint64_t gameId = 0;
+    int framesSinceSave = 0;
 
-            if(fallTimer >= curInterval) {
-                fallTimer = 0.f;
-                
-                if(canMove(board, cur, 0, +1)) {
-                    cur.pivot.y += 1;
-                } else {
-                    board.lock(cur);
+    // 메뉴에서 이어할 수 있는 게임 (시작할 때 한 번 읽음)
+    bool resumable = false;
+    checkpoint::GameSnapshot saved{};
+    vector<uint16_t> savedLocks;
 
-                    int chainIndex = 1;
-                    while(true) {
-                        int removed = board.popGroupsAndScore(chainIndex);
-                        if(removed <= 0) break;
-                        board.applyGravity();
-                        chainIndex++;
-                    }
+    bool available() const { return file.isOpen(); }
 
-                    cur = nextPair;
-                    nextPair = makeSpawnPair();
+    bool open(const std::string& path) {
+        if(!file.open(path)) return false;
+        resumable = file.load(saved, savedLocks);
+        file.startFlusher(1.0f);
+        return true;
+    }
 
-                    if(board.isGameOver()) {
-                        alive = false;
-                        gameState = GAME_OVER;
-                    }
-                }
-            }
-        }
+    void beginGame(uint64_t id) {
+        gameId = id;
+        framesSinceSave = EVERY_FRAMES;
+        resumable = false;
+    }
 
-        board.updateEffects(dt);
+    // 잠금 직후에는 바로, 그 밖에는 EVERY_FRAMES마다
+    bool due(bool locked) { return locked || ++framesSinceSave >= EVERY_FRAMES; }
 
-        // 렌더링
-        window.clear(sf::Color(12, 12, 20));
+    void save(const checkpoint::GameSnapshot& s, const vector<uint16_t>& locks) {
+        file.save(s, locks);
+        framesSinceSave = 0;
+    }
+
+    void finishGame() {
+        file.clear();
+        resumable = false;
+    }
+
+    // 정상 종료: 이번 실행의 게임은 이어할 대상이 아님. 손대지 않은 이전 비정상 종료 기록만 남김
+    void shutdown() {
+        if(!resumable) file.clear();
+        file.close();
+    }
+};
+
+// 게임 화면 렌더러 - 창, 오프스크린, 헤드리스 벤치마크가 같은 그리기 코드를 공유
+class GameRenderer {
+private:
+    const DisplaySettings& display;
+    TextRenderer& textRenderer;
+    DigitRenderer& digitRenderer;
+
+public:
+    const PuzzleSession* puzzle = nullptr;
+    const PatternHint* hint = nullptr;
+    const ScoreBoard* scoreBoard = nullptr;
+    const CpuPlayer* cpu = nullptr;
+    const GameCheckpoint* savedGame = nullptr;
+
+    GameRenderer(const DisplaySettings& ds, TextRenderer& tr, DigitRenderer& dr)
+        : display(ds), textRenderer(tr), digitRenderer(dr) {}
+
+    void render(sf::RenderTarget& target, const Board& board, GameState gameState,
+                const PuyoPair& cur, const PuyoPair& nextPair, bool alive,
+                float backgroundTime, bool fontsLoaded) {
+        sf::Vector2u currentSize = target.getSize();
+        sf::Vector2f gameOffset = display.getGameOffset(currentSize.x, currentSize.y);
+
+        target.clear(sf::Color(12, 12, 20));
         sf::Vector2f shakeOffset = board.getShakeOffset();
 
         if(gameState == MENU) {
@@ -848,26 +1540,32 @@ int main() {
                 bgColor.a = static_cast<sf::Uint8>(60 + sin(phase) * 40);
                 bg.setFillColor(bgColor);
                 bg.setPosition(x, y);
-                window.draw(bg);
+                drawCounted(target, bg);
             }
 
             if(fontsLoaded) {
                 float pulse = 1.0f + sin(backgroundTime * 3.0f) * 0.1f;
-                textRenderer.drawCenteredText(window, "PUYO PUYO", "title", 48, 
+                textRenderer.drawCenteredText(target, "PUYO PUYO", "title", 48, 
                     sf::Vector2f(currentSize.x/2, 80 * display.scaleFactor), 
                     sf::Color(255, 100, 255), TextRenderer::GLOWING, pulse);
                     
-                textRenderer.drawCenteredText(window, "ENHANCED PRO", "ui", 20, 
+                textRenderer.drawCenteredText(target, "ENHANCED PRO", "ui", 20, 
                     sf::Vector2f(currentSize.x/2, 120 * display.scaleFactor), 
                     sf::Color::Cyan, TextRenderer::SHADOWED);
                 
                 // 깜빡이는 시작 안내
                 float blink = sin(backgroundTime * 4.0f);
                 if(blink > 0) {
-                    textRenderer.drawCenteredText(window, "Press SPACE to Start", "ui", 18, 
+                    textRenderer.drawCenteredText(target, "Press SPACE to Start", "ui", 18, 
                         sf::Vector2f(currentSize.x/2, 170 * display.scaleFactor), 
                         sf::Color::Yellow, TextRenderer::RETRO);
                 }
+                if(savedGame && savedGame->resumable) {
+                    textRenderer.drawCenteredText(target, "R: Resume Game (Score " + to_string(savedGame->saved.score) +
+                        ", Lv " + to_string(savedGame->saved.level) + ")", "ui", 14,
+                        sf::Vector2f(currentSize.x/2, 195 * display.scaleFactor),
+                        sf::Color(120, 255, 160), TextRenderer::SHADOWED);
+                }
                 
                 // 컨트롤 안내 - 중앙 정렬
                 vector<string> controls = {
@@ -877,25 +1575,26 @@ int main() {
                     "Down: Soft Drop",
                     "ESC: Pause/Menu"
                 };
+                if(scoreBoard && scoreBoard->available()) controls.push_back("L: Leaderboard");
                 
-                textRenderer.drawText(window, "Controls:", "ui", 16, 
+                textRenderer.drawText(target, "Controls:", "ui", 16, 
                     sf::Vector2f(50, 220), sf::Color::Cyan, TextRenderer::NORMAL, 1.0f, gameOffset);
                 
                 for(size_t i = 0; i < controls.size(); i++) {
-                    textRenderer.drawText(window, controls[i], "ui", 12, 
+                    textRenderer.drawText(target, controls[i], "ui", 12, 
                         sf::Vector2f(50, 245 + i * 18), sf::Color::White, TextRenderer::NORMAL, 1.0f, gameOffset);
                 }
             }
         } 
         else if(gameState == PAUSED) {
             if(fontsLoaded) {
-                textRenderer.drawCenteredText(window, "PAUSED", "title", 40, 
+                textRenderer.drawCenteredText(target, "PAUSED", "title", 40, 
                     sf::Vector2f(currentSize.x/2, currentSize.y/2 - 60), 
                     sf::Color::Yellow, TextRenderer::OUTLINED);
-                textRenderer.drawCenteredText(window, "ESC: Continue", "ui", 16, 
+                textRenderer.drawCenteredText(target, "ESC: Continue", "ui", 16, 
                     sf::Vector2f(currentSize.x/2, currentSize.y/2 - 20), 
                     sf::Color::White);
-                textRenderer.drawCenteredText(window, "R: Restart", "ui", 16, 
+                textRenderer.drawCenteredText(target, "R: Restart", "ui", 16, 
                     sf::Vector2f(currentSize.x/2, currentSize.y/2), 
                     sf::Color::White);
             }
@@ -903,23 +1602,26 @@ int main() {
         else if(gameState == GAME_OVER) {
             if(fontsLoaded) {
                 float gameOverPulse = 1.0f + sin(backgroundTime * 5.0f) * 0.15f;
-                textRenderer.drawCenteredText(window, "GAME OVER", "title", 40, 
+                bool puzzleCleared = puzzle && puzzle->active && puzzle->status == PuzzleSession::CLEARED;
+                const char* title = !(puzzle && puzzle->active) ? "GAME OVER" :
+                                    puzzleCleared ? "PUZZLE CLEAR!" : "PUZZLE FAILED";
+                textRenderer.drawCenteredText(target, title, "title", 40, 
                     sf::Vector2f(currentSize.x/2, 100 * display.scaleFactor), 
-                    sf::Color::Red, TextRenderer::GLOWING, gameOverPulse);
+                    puzzleCleared ? sf::Color::Green : sf::Color::Red, TextRenderer::GLOWING, gameOverPulse);
                 
-                textRenderer.drawCenteredText(window, "Final Statistics:", "ui", 18, 
+                textRenderer.drawCenteredText(target, "Final Statistics:", "ui", 18, 
                     sf::Vector2f(currentSize.x/2, 150 * display.scaleFactor), 
                     sf::Color::Cyan);
                 
-                textRenderer.drawCenteredText(window, "Score: " + to_string(board.score), "score", 16, 
+                textRenderer.drawCenteredText(target, "Score: " + to_string(board.score), "score", 16, 
                     sf::Vector2f(currentSize.x/2, 175 * display.scaleFactor), 
                     sf::Color::White);
                 
-                textRenderer.drawCenteredText(window, "Level: " + to_string(board.level) + "/25", "ui", 16, 
+                textRenderer.drawCenteredText(target, "Level: " + to_string(board.level) + "/25", "ui", 16, 
                     sf::Vector2f(currentSize.x/2, 195 * display.scaleFactor), 
                     sf::Color::Cyan);
                 
-                textRenderer.drawCenteredText(window, "Lines: " + to_string(board.totalLinesCleared), "ui", 16, 
+                textRenderer.drawCenteredText(target, "Lines: " + to_string(board.totalLinesCleared), "ui", 16, 
                     sf::Vector2f(currentSize.x/2, 215 * display.scaleFactor), 
                     sf::Color::White);
                 
@@ -932,18 +1634,79 @@ int main() {
                 else if(board.score >= 10000) { grade = "B"; gradeColor = sf::Color::Cyan; }
                 else if(board.score >= 5000) { grade = "C"; gradeColor = sf::Color::Green; }
                 
-                textRenderer.drawCenteredText(window, "Grade: " + grade, "title", 18, 
+                textRenderer.drawCenteredText(target, "Grade: " + grade, "title", 18, 
                     sf::Vector2f(currentSize.x/2, 245 * display.scaleFactor), 
                     gradeColor, TextRenderer::GLOWING, 1.2f);
                 
-                textRenderer.drawCenteredText(window, "R: Restart", "ui", 18, 
-                    sf::Vector2f(currentSize.x/2, 280 * display.scaleFactor), 
+                // 기록된 게임이면 전체 순위
+                float optionsY = 280 * display.scaleFactor;
+                if(scoreBoard && scoreBoard->lastRank > 0) {
+                    textRenderer.drawCenteredText(target, "Rank #" + to_string(scoreBoard->lastRank) + " of " +
+                        to_string(scoreBoard->store.count()) + "  (Max Chain " + to_string(scoreBoard->maxChain) + ")", "ui", 14, 
+                        sf::Vector2f(currentSize.x/2, 270 * display.scaleFactor), 
+                        scoreBoard->lastRank <= ScoreBoard::TOP_ROWS ? sf::Color::Magenta : sf::Color::Cyan);
+                    optionsY += 15 * display.scaleFactor;
+                }
+                
+                textRenderer.drawCenteredText(target, "R: Restart", "ui", 18, 
+                    sf::Vector2f(currentSize.x/2, optionsY), 
                     sf::Color::Yellow);
-                textRenderer.drawCenteredText(window, "ESC: Menu", "ui", 18, 
-                    sf::Vector2f(currentSize.x/2, 305 * display.scaleFactor), 
+                textRenderer.drawCenteredText(target, "ESC: Menu", "ui", 18, 
+                    sf::Vector2f(currentSize.x/2, optionsY + 25 * display.scaleFactor), 
                     sf::Color::Yellow);
             }
         } 
+        else if(gameState == LEADERBOARD) {
+            if(fontsLoaded && scoreBoard) {
+                textRenderer.drawCenteredText(target, "LEADERBOARD", "title", 32, 
+                    sf::Vector2f(currentSize.x/2, 50 * display.scaleFactor), 
+                    sf::Color(255, 100, 255), TextRenderer::GLOWING);
+                
+                // 순위표: 점수 / 레벨 / 최대 연쇄 / 플레이어
+                float rowY = 95 * display.scaleFactor;
+                float leftX = currentSize.x/2 - 170 * display.scaleFactor;
+                textRenderer.drawText(target, "RANK  SCORE    LV  CHAIN  PLAYER", "ui", 12, 
+                    sf::Vector2f(leftX, rowY), sf::Color::Cyan);
+                rowY += 22 * display.scaleFactor;
+                
+                char line[96];
+                for(size_t i = 0; i < scoreBoard->top.size(); i++) {
+                    const scores::GameRecord& g = scoreBoard->top[i].game;
+                    snprintf(line, sizeof(line), "%2zu.  %-8u %2u  %3u    %s", i + 1, g.score, g.level, g.maxChain,
+                             scores::playerName(g).c_str());
+                    bool mine = scoreBoard->lastRank > 0 && scoreBoard->top[i].record == scoreBoard->lastRecord;
+                    textRenderer.drawText(target, line, "ui", 12, sf::Vector2f(leftX, rowY), 
+                        mine ? sf::Color::Yellow : i == 0 ? sf::Color::Magenta : sf::Color::White);
+                    rowY += 18 * display.scaleFactor;
+                }
+                if(scoreBoard->top.empty()) {
+                    textRenderer.drawText(target, "No games recorded yet", "ui", 12, 
+                        sf::Vector2f(leftX, rowY), sf::Color(160, 160, 160));
+                    rowY += 18 * display.scaleFactor;
+                }
+                
+                // 내 최근 기록
+                rowY += 14 * display.scaleFactor;
+                textRenderer.drawText(target, "RECENT - " + scoreBoard->player, "ui", 12, 
+                    sf::Vector2f(leftX, rowY), sf::Color::Cyan);
+                rowY += 20 * display.scaleFactor;
+                for(const scores::Ranked& r : scoreBoard->history) {
+                    snprintf(line, sizeof(line), "%-8u LV %-2u  CHAIN %-2u  %u:%02u", r.game.score, r.game.level,
+                             r.game.maxChain, r.game.durationMs / 60000, r.game.durationMs / 1000 % 60);
+                    textRenderer.drawText(target, line, "ui", 10, sf::Vector2f(leftX, rowY), sf::Color::White);
+                    rowY += 15 * display.scaleFactor;
+                }
+                
+                snprintf(line, sizeof(line), "%llu games  |  loaded in %.2f ms",
+                         (unsigned long long)scoreBoard->store.count(), scoreBoard->loadMillis);
+                textRenderer.drawCenteredText(target, line, "ui", 10, 
+                    sf::Vector2f(currentSize.x/2, currentSize.y - 45 * display.scaleFactor), 
+                    sf::Color(100, 100, 120));
+                textRenderer.drawCenteredText(target, "ESC: Menu", "ui", 16, 
+                    sf::Vector2f(currentSize.x/2, currentSize.y - 22 * display.scaleFactor), 
+                    sf::Color::Yellow);
+            }
+        }
         else {
             // 게임 플레이 화면 - 스케일링 적용
             sf::RectangleShape tile(sf::Vector2f(display.cellSize - 2, display.cellSize - 2));
@@ -958,7 +1721,7 @@ int main() {
                         x * display.cellSize + 1 + shakeOffset.x + gameOffset.x, 
                         y * display.cellSize + 1 + shakeOffset.y + gameOffset.y
                     );
-                    window.draw(tile);
+                    drawCounted(target, tile);
                     
                     // 하이라이트와 그림자 효과
                     if(board.g[y][x] != EMPTY) {
@@ -968,7 +1731,7 @@ int main() {
                             x * display.cellSize + display.cellSize/3.0f + shakeOffset.x + gameOffset.x, 
                             y * display.cellSize + display.cellSize/4.0f + shakeOffset.y + gameOffset.y
                         );
-                        window.draw(highlight);
+                        drawCounted(target, highlight);
                         
                         sf::RectangleShape shadow(sf::Vector2f(display.cellSize - 4, display.cellSize - 4));
                         sf::Color shadowColor = tileColor;
@@ -978,23 +1741,54 @@ int main() {
                             x * display.cellSize + 3 + shakeOffset.x + gameOffset.x, 
                             y * display.cellSize + 3 + shakeOffset.y + gameOffset.y
                         );
-                        window.draw(shadow);
+                        drawCounted(target, shadow);
                     }
                 }
             }
 
+            // 연쇄 잠재력 트리거 위치 (반투명 표시)
+            if(alive && board.chainAnalyzer.hasBest()) {
+                const chain::Trigger& trigger = board.chainAnalyzer.best();
+                sf::Color ghostColor = board.getPuyoColor(trigger.color);
+                ghostColor.a = static_cast<sf::Uint8>(60 + 40 * sin(backgroundTime * 4.0f));
+                sf::CircleShape ghost(display.cellSize / 2.0f - 4);
+                ghost.setFillColor(sf::Color::Transparent);
+                ghost.setOutlineThickness(2 * display.scaleFactor);
+                ghost.setOutlineColor(ghostColor);
+                int top = chain::landingRow(board.g, trigger.column);
+                for(int i = 0; i < trigger.extra; i++) {
+                    ghost.setPosition(
+                        trigger.column * display.cellSize + 4 + shakeOffset.x + gameOffset.x,
+                        (top - i) * display.cellSize + 4 + shakeOffset.y + gameOffset.y
+                    );
+                    drawCounted(target, ghost);
+                }
+            }
+
+            // 패턴 힌트: 추천 배치 위치에 반투명 뿌요
+            if(alive && hint && hint->visible()) {
+                float fade = std::min(1.0f, hint->timer / 0.5f);
+                for(int i = 0; i < 2; i++) {
+                    sf::Color hintColor = board.getPuyoColor(hint->colors[i]);
+                    hintColor.a = static_cast<sf::Uint8>(110 * fade);
+                    sf::RectangleShape cell(sf::Vector2f(display.cellSize - 6, display.cellSize - 6));
+                    cell.setFillColor(hintColor);
+                    cell.setOutlineThickness(1 * display.scaleFactor);
+                    cell.setOutlineColor(sf::Color(255, 255, 255, static_cast<sf::Uint8>(160 * fade)));
+                    cell.setPosition(
+                        hint->cells[i].x * display.cellSize + 3 + shakeOffset.x + gameOffset.x,
+                        hint->cells[i].y * display.cellSize + 3 + shakeOffset.y + gameOffset.y
+                    );
+                    drawCounted(target, cell);
+                }
+            }
+
             // 현재 조각 그리기
             if(alive) {
                 auto drawPuyo = [&](int x, int y, Color c, bool isPivot = false) {
                     if(inBounds(x, y)) {
-                        float scale = 1.0f;
-                        if(cur.animationTimer < 1.0f) {
-                            scale = 0.5f + (cur.animationTimer * 0.5f);
-                        }
-                        
-                        if(isPivot) {
-                            scale += sin(backgroundTime * 10.0f) * 0.05f;
-                        }
+                        float scale = board.pieceScale();
+                        if(isPivot) scale += board.pivotPulse();
                         
                         sf::RectangleShape puyoTile(sf::Vector2f(
                             (display.cellSize - 2) * scale, 
@@ -1008,7 +1802,7 @@ int main() {
                             x * display.cellSize + 1 + offsetX + shakeOffset.x + gameOffset.x, 
                             y * display.cellSize + 1 + offsetY + shakeOffset.y + gameOffset.y
                         );
-                        window.draw(puyoTile);
+                        drawCounted(target, puyoTile);
                         
                         sf::CircleShape activeGlow(display.cellSize / 4.0f * scale);
                         activeGlow.setFillColor(sf::Color(255, 255, 255, 100));
@@ -1016,7 +1810,7 @@ int main() {
                             x * display.cellSize + display.cellSize/3.0f + shakeOffset.x + gameOffset.x, 
                             y * display.cellSize + display.cellSize/3.0f + shakeOffset.y + gameOffset.y
                         );
-                        window.draw(activeGlow);
+                        drawCounted(target, activeGlow);
                     }
                 };
                 
@@ -1025,7 +1819,7 @@ int main() {
             }
 
             // 파티클 렌더링
-            sf::CircleShape particleShape;
+            sf::CircleShape particleShape(0.0f, board.budget.particlePointCount());
             for(const auto& particle : board.particles) {
                 particleShape.setRadius(particle.size);
                 particleShape.setFillColor(particle.color);
@@ -1033,17 +1827,19 @@ int main() {
                     particle.position.x - particle.size + shakeOffset.x + gameOffset.x, 
                     particle.position.y - particle.size + shakeOffset.y + gameOffset.y
                 );
-                window.draw(particleShape);
+                drawCounted(target, particleShape);
             }
 
             // 점수 이펙트 렌더링
             if(fontsLoaded) {
+                const tween::Timeline& timeline = board.timeline;
                 for(const auto& effect : board.scoreEffects) {
-                    float bounce = sin(effect.bounce) * 3.0f;
-                    textRenderer.drawText(window, "+" + to_string(effect.score), "score", 14, 
-                        sf::Vector2f(effect.position.x, effect.position.y + bounce), 
-                        effect.color, TextRenderer::OUTLINED, effect.scale, 
-                        sf::Vector2f(shakeOffset.x + gameOffset.x, shakeOffset.y + gameOffset.y));
+                    sf::Color color = effect.color;
+                    color.a = static_cast<sf::Uint8>(std::max(0.0f, timeline.value(effect.alpha)));
+                    digitRenderer.drawNumber(target, effect.score, "score", 14, 
+                        sf::Vector2f(effect.position.x, effect.position.y + timeline.value(effect.rise) + timeline.value(effect.bounce)), 
+                        color, TextRenderer::OUTLINED, std::max(0.1f, timeline.value(effect.scale)), 
+                        sf::Vector2f(shakeOffset.x + gameOffset.x, shakeOffset.y + gameOffset.y), "+");
                 }
             }
 
@@ -1051,31 +1847,44 @@ int main() {
             sf::RectangleShape uiPanel(sf::Vector2f(display.uiWidth, currentSize.y));
             uiPanel.setFillColor(sf::Color(15, 15, 25, 220));
             uiPanel.setPosition(display.gameWidth + gameOffset.x + 10, gameOffset.y);
-            window.draw(uiPanel);
+            drawCounted(target, uiPanel);
 
             sf::RectangleShape uiHeader(sf::Vector2f(display.uiWidth, 4 * display.scaleFactor));
             uiHeader.setFillColor(sf::Color::Cyan);
             uiHeader.setPosition(display.gameWidth + gameOffset.x + 10, gameOffset.y);
-            window.draw(uiHeader);
+            drawCounted(target, uiHeader);
 
             // UI 정보 - 향상된 폰트 적용
             if(fontsLoaded) {
                 float uiX = display.gameWidth + gameOffset.x + 20;
                 float yPos = gameOffset.y + 15;
+
+                // 퍼즐 목표와 남은 조각
+                if(puzzle && puzzle->active) {
+                    digitRenderer.drawNumber(target, puzzle->current.targetChain, "ui", 14, 
+                        sf::Vector2f(uiX, yPos), sf::Color::Magenta, TextRenderer::SHADOWED,
+                        1.0f, sf::Vector2f(0, 0), "GOAL: ", " CHAIN");
+                    yPos += 22 * display.scaleFactor;
+                    digitRenderer.drawNumber(target, puzzle->piecesLeft(), "ui", 10, 
+                        sf::Vector2f(uiX, yPos), sf::Color::White, TextRenderer::NORMAL,
+                        1.0f, sf::Vector2f(0, 0), "Pieces left: ");
+                    yPos += 22 * display.scaleFactor;
+                }
                 
-                textRenderer.drawText(window, "SCORE", "ui", 14, sf::Vector2f(uiX, yPos), sf::Color::Cyan, TextRenderer::SHADOWED);
+                textRenderer.drawText(target, "SCORE", "ui", 14, sf::Vector2f(uiX, yPos), sf::Color::Cyan, TextRenderer::SHADOWED);
                 yPos += 25 * display.scaleFactor;
                 
-                textRenderer.drawText(window, to_string(board.score), "score", 20, sf::Vector2f(uiX, yPos), sf::Color::White, TextRenderer::OUTLINED);
+                digitRenderer.drawNumber(target, board.score, "score", 20, sf::Vector2f(uiX, yPos), sf::Color::White, TextRenderer::OUTLINED);
                 yPos += 40 * display.scaleFactor;
 
-                textRenderer.drawText(window, "LEVEL", "ui", 14, sf::Vector2f(uiX, yPos), sf::Color::Yellow, TextRenderer::SHADOWED);
+                textRenderer.drawText(target, "LEVEL", "ui", 14, sf::Vector2f(uiX, yPos), sf::Color::Yellow, TextRenderer::SHADOWED);
                 yPos += 25 * display.scaleFactor;
                 
                 sf::Color levelColor = board.level < 8 ? sf::Color::White : 
                                      board.level < 15 ? sf::Color::Yellow : 
                                      board.level < 20 ? sf::Color(255, 165, 0) : sf::Color::Red;
-                textRenderer.drawText(window, to_string(board.level) + "/25", "ui", 18, sf::Vector2f(uiX, yPos), levelColor, TextRenderer::OUTLINED);
+                digitRenderer.drawNumber(target, board.level, "ui", 18, sf::Vector2f(uiX, yPos), levelColor, TextRenderer::OUTLINED,
+                    1.0f, sf::Vector2f(0, 0), "", "/25");
                 yPos += 30 * display.scaleFactor;
                 
                 // 레벨 프로그레스 바
@@ -1088,47 +1897,90 @@ int main() {
                     sf::RectangleShape progressBG(sf::Vector2f(180 * display.scaleFactor, 8 * display.scaleFactor));
                     progressBG.setFillColor(sf::Color(40, 40, 50));
                     progressBG.setPosition(uiX, yPos);
-                    window.draw(progressBG);
+                    drawCounted(target, progressBG);
                     
                     sf::RectangleShape progressBar(sf::Vector2f(180 * display.scaleFactor * progress, 8 * display.scaleFactor));
                     progressBar.setFillColor(levelColor);
                     progressBar.setPosition(uiX, yPos);
-                    window.draw(progressBar);
+                    drawCounted(target, progressBar);
                     yPos += 20 * display.scaleFactor;
                     
                     int remainingScore = nextLevelScore - board.score;
-                    textRenderer.drawText(window, "Next: " + to_string(remainingScore), "ui", 10, 
-                        sf::Vector2f(uiX, yPos), sf::Color(160, 160, 160));
+                    digitRenderer.drawNumber(target, remainingScore, "ui", 10, 
+                        sf::Vector2f(uiX, yPos), sf::Color(160, 160, 160), TextRenderer::NORMAL,
+                        1.0f, sf::Vector2f(0, 0), "Next: ");
                 } else {
-                    textRenderer.drawText(window, "MAX LEVEL!", "title", 12, 
+                    textRenderer.drawText(target, "MAX LEVEL!", "title", 12, 
                         sf::Vector2f(uiX, yPos), sf::Color::Red, TextRenderer::GLOWING);
                 }
                 yPos += 25 * display.scaleFactor;
 
                 // 콤보와 연쇄 표시
-                if(board.comboTimer > 0 && board.combo > 1) {
+                if(board.comboShowing() && board.combo > 1) {
                     sf::Color comboColor = board.combo < 5 ? sf::Color::Yellow :
                                          board.combo < 10 ? sf::Color(255, 165, 0) : 
                                          board.combo < 15 ? sf::Color::Red : sf::Color::Magenta;
-                    float comboScale = 1.0f + sin(backgroundTime * 8.0f) * 0.1f;
-                    textRenderer.drawText(window, to_string(board.combo) + " COMBO!", "retro", 14, 
-                        sf::Vector2f(uiX, yPos), comboColor, TextRenderer::GLOWING, comboScale);
+                    digitRenderer.drawNumber(target, board.combo, "retro", 14, 
+                        sf::Vector2f(uiX, yPos), comboColor, TextRenderer::GLOWING, board.comboScale(),
+                        sf::Vector2f(0, 0), "", " COMBO!");
                     yPos += 28 * display.scaleFactor;
                 }
 
-                if(board.chainDisplayTimer > 0 && board.currentChain > 1) {
+                if(board.chainShowing() && board.currentChain > 1) {
                     sf::Color chainColor = board.currentChain < 3 ? sf::Color::Green :
                                          board.currentChain < 5 ? sf::Color::Yellow : 
                                          board.currentChain < 8 ? sf::Color::Red : sf::Color::Magenta;
-                    float scale = 1.2f + (board.chainDisplayTimer / 2.5f) * 0.4f;
-                    textRenderer.drawText(window, to_string(board.currentChain) + " CHAIN!", "retro", 16, 
-                        sf::Vector2f(uiX, yPos), chainColor, TextRenderer::GLOWING, scale);
+                    digitRenderer.drawNumber(target, board.currentChain, "retro", 16, 
+                        sf::Vector2f(uiX, yPos), chainColor, TextRenderer::GLOWING, board.chainScale(),
+                        sf::Vector2f(0, 0), "", " CHAIN!");
                     yPos += 35 * display.scaleFactor;
                 }
 
+                // 연쇄 잠재력: 한 열에 같은 색을 1~3개 더 놓았을 때의 최대 연쇄
+                if(board.chainAnalyzer.hasBest()) {
+                    const chain::Trigger& trigger = board.chainAnalyzer.best();
+                    textRenderer.drawText(target, "POTENTIAL", "ui", 12, sf::Vector2f(uiX, yPos), sf::Color::Cyan, TextRenderer::SHADOWED);
+                    yPos += 20 * display.scaleFactor;
+                    digitRenderer.drawNumber(target, trigger.outcome.chain, "ui", 12, 
+                        sf::Vector2f(uiX, yPos), board.getPuyoColor(trigger.color), TextRenderer::OUTLINED,
+                        1.0f, sf::Vector2f(0, 0), "", " CHAIN");
+                    yPos += 18 * display.scaleFactor;
+                    digitRenderer.drawNumber(target, trigger.scoreGained, "ui", 10, 
+                        sf::Vector2f(uiX, yPos), sf::Color::White, TextRenderer::NORMAL,
+                        1.0f, sf::Vector2f(0, 0), "+");
+                    yPos += 18 * display.scaleFactor;
+                }
+
+                // 패턴 힌트 정보 (정석 이름, 진행도)
+                if(hint && hint->visible()) {
+                    yPos += 10 * display.scaleFactor;
+                    textRenderer.drawText(target, "HINT", "ui", 12, sf::Vector2f(uiX, yPos), sf::Color::Cyan, TextRenderer::SHADOWED);
+                    yPos += 20 * display.scaleFactor;
+                    textRenderer.drawText(target, hint->name, "ui", 10, sf::Vector2f(uiX, yPos), sf::Color::White);
+                    yPos += 16 * display.scaleFactor;
+                    textRenderer.drawText(target, to_string(hint->filled) + "/" + to_string(hint->total) + "  " +
+                        to_string(hint->chain) + " CHAIN", "ui", 10, sf::Vector2f(uiX, yPos), sf::Color(180, 180, 200));
+                    yPos += 18 * display.scaleFactor;
+                    if(!hint->keys.empty()) {
+                        textRenderer.drawText(target, "Keys: " + hint->keys, "ui", 10, sf::Vector2f(uiX, yPos), sf::Color::Yellow);
+                        yPos += 16 * display.scaleFactor;
+                    }
+                }
+
+                // CPU 자동 플레이: 마지막 결정의 탐색 깊이
+                if(cpu && cpu->enabled) {
+                    yPos += 10 * display.scaleFactor;
+                    textRenderer.drawText(target, "CPU", "ui", 12, sf::Vector2f(uiX, yPos), sf::Color::Magenta, TextRenderer::SHADOWED);
+                    yPos += 20 * display.scaleFactor;
+                    string info = cpu->thinking ? "thinking..." :
+                        "depth " + to_string(cpu->decided.depth) + "  " + to_string(cpu->decided.samples) + " samples";
+                    textRenderer.drawText(target, info, "ui", 10, sf::Vector2f(uiX, yPos), sf::Color(180, 180, 200));
+                    yPos += 18 * display.scaleFactor;
+                }
+
                 // 다음 뿌요 미리보기
                 yPos += 15 * display.scaleFactor;
-                textRenderer.drawText(window, "NEXT", "ui", 12, sf::Vector2f(uiX, yPos), sf::Color::Cyan, TextRenderer::SHADOWED);
+                textRenderer.drawText(target, "NEXT", "ui", 12, sf::Vector2f(uiX, yPos), sf::Color::Cyan, TextRenderer::SHADOWED);
                 yPos += 25 * display.scaleFactor;
                 
                 sf::RectangleShape nextBG(sf::Vector2f(60 * display.scaleFactor, 60 * display.scaleFactor));
@@ -1136,24 +1988,25 @@ int main() {
                 nextBG.setOutlineThickness(1 * display.scaleFactor);
                 nextBG.setOutlineColor(sf::Color(70, 70, 80));
                 nextBG.setPosition(uiX, yPos);
-                window.draw(nextBG);
+                drawCounted(target, nextBG);
                 
                 sf::RectangleShape nextTile(sf::Vector2f(22 * display.scaleFactor, 22 * display.scaleFactor));
                 
                 nextTile.setFillColor(board.getPuyoColor(nextPair.c1));
                 nextTile.setPosition(uiX + 19 * display.scaleFactor, yPos + 10 * display.scaleFactor);
-                window.draw(nextTile);
+                drawCounted(target, nextTile);
 
                 nextTile.setFillColor(board.getPuyoColor(nextPair.c2));
                 nextTile.setPosition(uiX + 19 * display.scaleFactor, yPos + 35 * display.scaleFactor);
-                window.draw(nextTile);
+                drawCounted(target, nextTile);
                 yPos += 80 * display.scaleFactor;
 
                 // 통계 정보
-                textRenderer.drawText(window, "STATISTICS", "ui", 12, sf::Vector2f(uiX, yPos), sf::Color::Cyan, TextRenderer::SHADOWED);
+                textRenderer.drawText(target, "STATISTICS", "ui", 12, sf::Vector2f(uiX, yPos), sf::Color::Cyan, TextRenderer::SHADOWED);
                 yPos += 20 * display.scaleFactor;
-                textRenderer.drawText(window, "Groups: " + to_string(board.totalLinesCleared), "ui", 10, 
-                    sf::Vector2f(uiX, yPos), sf::Color::White);
+                digitRenderer.drawNumber(target, board.totalLinesCleared, "ui", 10, 
+                    sf::Vector2f(uiX, yPos), sf::Color::White, TextRenderer::NORMAL,
+                    1.0f, sf::Vector2f(0, 0), "Groups: ");
                 yPos += 18 * display.scaleFactor;
 
                 // 속도 표시
@@ -1161,19 +2014,20 @@ int main() {
                 int speedPercent = static_cast<int>((1.2f - speed) / 1.2f * 100);
                 sf::Color speedColor = speedPercent < 50 ? sf::Color::Green :
                                      speedPercent < 80 ? sf::Color::Yellow : sf::Color::Red;
-                textRenderer.drawText(window, "Speed: " + to_string(speedPercent) + "%", "ui", 10, 
-                    sf::Vector2f(uiX, yPos), speedColor);
+                digitRenderer.drawNumber(target, speedPercent, "ui", 10, 
+                    sf::Vector2f(uiX, yPos), speedColor, TextRenderer::NORMAL,
+                    1.0f, sf::Vector2f(0, 0), "Speed: ", "%");
                 yPos += 25 * display.scaleFactor;
 
                 // 레벨업 효과
-                if(board.levelUpEffect > 0) {
-                    textRenderer.drawText(window, "LEVEL UP!", "title", 16, sf::Vector2f(uiX, yPos), 
+                if(board.levelUpShowing()) {
+                    textRenderer.drawText(target, "LEVEL UP!", "title", 16, sf::Vector2f(uiX, yPos), 
                         sf::Color::Yellow, TextRenderer::GLOWING);
                 }
 
                 // 컨트롤 안내 - 하단
                 float controlsY = currentSize.y - 120 * display.scaleFactor;
-                textRenderer.drawText(window, "CONTROLS", "ui", 10, sf::Vector2f(uiX, controlsY), 
+                textRenderer.drawText(target, "CONTROLS", "ui", 10, sf::Vector2f(uiX, controlsY), 
                     sf::Color(100, 100, 120));
                 controlsY += 18 * display.scaleFactor;
                 
@@ -1184,9 +2038,11 @@ int main() {
                     {"↓", "Soft Drop"},
                     {"ESC", "Pause"}
                 };
+                if(hint && hint->available()) controls.push_back({"H", "Hint"});
+                controls.push_back({"C", cpu && cpu->enabled ? "CPU Off" : "CPU Play"});
                 
                 for(const auto& control : controls) {
-                    textRenderer.drawText(window, control.first + ": " + control.second, "ui", 8, 
+                    textRenderer.drawText(target, control.first + ": " + control.second, "ui", 8, 
                         sf::Vector2f(uiX, controlsY), sf::Color(100, 100, 120));
                     controlsY += 13 * display.scaleFactor;
                 }
@@ -1199,17 +2055,727 @@ int main() {
             border.setOutlineThickness(3 * display.scaleFactor);
             border.setSize(sf::Vector2f(display.gameWidth, display.gameHeight));
             border.setPosition(gameOffset.x + shakeOffset.x, gameOffset.y + shakeOffset.y);
-            window.draw(border);
+            drawCounted(target, border);
             
             // 상단 마스크
             sf::RectangleShape topMask(sf::Vector2f(display.gameWidth, 60 * display.scaleFactor));
             topMask.setFillColor(sf::Color(12, 12, 20, 150));
             topMask.setPosition(gameOffset.x + shakeOffset.x, gameOffset.y + shakeOffset.y);
-            window.draw(topMask);
+            drawCounted(target, topMask);
+        }
+    }
+};
+
+// ---- 헤드리스 렌더링 벤치마크 / 골든 프레임 ----
+struct BenchOptions {
+    int frames = 300;
+    int resolutionMultiple = 1;
+    string goldenDir;        // 지정 시 각 장면의 기준 프레임을 PNG로 저장
+    string compareDir;       // 지정 시 저장된 PNG와 비교
+    int goldenFrame = 60;    // 골든 이미지로 사용할 프레임 번호
+};
+
+// 두 이미지의 채널 차이가 허용치를 넘는 픽셀 비율
+float imageDifference(const sf::Image& a, const sf::Image& b) {
+    if(a.getSize() != b.getSize()) return 1.0f;
+    const sf::Uint8* pa = a.getPixelsPtr();
+    const sf::Uint8* pb = b.getPixelsPtr();
+    size_t pixelCount = static_cast<size_t>(a.getSize().x) * a.getSize().y;
+    size_t differing = 0;
+    for(size_t i = 0; i < pixelCount; i++) {
+        for(int c = 0; c < 4; c++) {
+            if(std::abs(static_cast<int>(pa[i * 4 + c]) - static_cast<int>(pb[i * 4 + c])) > 16) {
+                differing++;
+                break;
+            }
         }
+    }
+    return pixelCount > 0 ? static_cast<float>(differing) / pixelCount : 0.0f;
+}
 
-        window.display();
+int runBenchmark(const BenchOptions& options) {
+    // 창을 열지 않고 오프스크린 타깃에만 렌더링 (고정 시드로 결정적인 프레임)
+    rng().seed(12345);
+
+    DisplaySettings display;
+    FontManager fontManager;
+    bool fontsLoaded = fontManager.loadAllFonts();
+
+    sf::RenderTexture target;
+    if(!target.create(BASE_WINDOW_WIDTH * options.resolutionMultiple,
+                      BASE_WINDOW_HEIGHT * options.resolutionMultiple)) {
+        fprintf(stderr, "bench: failed to create render texture\n");
+        return 1;
     }
+    display.updateScale(target.getSize().x, target.getSize().y);
+
+    GlowCache glowCache;
+    TextRenderer textRenderer(fontManager, display, glowCache);
+    DigitRenderer digitRenderer(fontManager, display, glowCache);
+    GameRenderer gameRenderer(display, textRenderer, digitRenderer);
+    EffectBudget effectBudget;
+    Board board(display, effectBudget);
+
+    PuyoPair cur = makeSpawnPair(rng());
+    PuyoPair nextPair = makeSpawnPair(rng());
+    cur.pivot = {2, 4};
+
+    struct Scene {
+        const char* name;
+        GameState state;
+        std::function<void(int)> step; // 프레임마다 장면 상태를 갱신
+    };
+
+    auto fillBoard = [&](int fromRow) {
+        board.clear();
+        for(int y = fromRow; y < ROWS; y++) {
+            for(int x = 0; x < COLS; x++) {
+                board.g[y][x] = static_cast<Color>((x + y * 2) % (COLOR_COUNT - 1) + 1);
+            }
+        }
+    };
+
+    vector<Scene> scenes = {
+        {"menu", MENU, [&](int frame) {
+            if(frame == 0) board.clear();
+        }},
+        {"board", PLAYING, [&](int frame) {
+            if(frame == 0) {
+                fillBoard(2);
+                board.score = 12345;
+                board.level = 10;
+            }
+        }},
+        {"chainfx", PLAYING, [&](int frame) {
+            if(frame == 0) fillBoard(6);
+            // 연쇄 이펙트 부하: 실제 연쇄 처리 없이 6프레임마다 다음 단계의 폭발/점수/배너를 띄워 1~10연쇄를 반복
+            if(frame % 6 == 0) {
+                int chainIndex = (frame / 6) % 10 + 1;
+                int column = chainIndex % COLS;
+                for(int i = 0; i < 4; i++) {
+                    board.createExplosionEffect(column, 8 + i % 4, static_cast<Color>(chainIndex % 5 + 1));
+                }
+                board.createScoreEffect(column, 8, board.calculateScore(4, chainIndex, 1), chainIndex);
+                board.showChain(chainIndex);
+                board.combo = chainIndex;
+                board.showCombo();
+            }
+        }},
+        {"gameover", GAME_OVER, [&](int frame) {
+            if(frame == 0) {
+                fillBoard(1);
+                board.score = 54321;
+                board.level = 25;
+                board.totalLinesCleared = 321;
+            }
+        }}
+    };
+
+    const float dt = 1.0f / 60.0f;
+    int failures = 0;
+    printf("%-10s %8s %10s %10s %10s\n", "scene", "frames", "mean_ms", "p99_ms", "max_ms");
+
+    for(auto& scene : scenes) {
+        vector<double> frameTimes;
+        frameTimes.reserve(options.frames);
+        float backgroundTime = 0.0f;
+
+        for(int frame = 0; frame < options.frames; frame++) {
+            effectBudget.beginFrame();
+            scene.step(frame);
+            board.updateEffects(dt);
+            backgroundTime += dt;
+
+            sf::Clock frameClock;
+            gameRenderer.render(target, board, scene.state, cur, nextPair, true, backgroundTime, fontsLoaded);
+            target.display();
+            glFinish(); // GPU 작업 완료까지 포함해서 측정
+            frameTimes.push_back(frameClock.getElapsedTime().asMicroseconds() / 1000.0);
+
+            if(frame == options.goldenFrame && (!options.goldenDir.empty() || !options.compareDir.empty())) {
+                sf::Image image = target.getTexture().copyToImage();
+                string fileName = string(scene.name) + ".png";
+                if(!options.goldenDir.empty()) {
+                    string path = options.goldenDir + "/" + fileName;
+                    if(!image.saveToFile(path)) {
+                        fprintf(stderr, "golden: cannot write %s\n", path.c_str());
+                        failures++;
+                    }
+                }
+                if(!options.compareDir.empty()) {
+                    sf::Image golden;
+                    float diff = golden.loadFromFile(options.compareDir + "/" + fileName)
+                               ? imageDifference(image, golden) : 1.0f;
+                    if(diff > 0.01f) {
+                        fprintf(stderr, "golden mismatch: %s (%.2f%% pixels differ)\n", scene.name, diff * 100.0f);
+                        failures++;
+                    }
+                }
+            }
+        }
+
+        double total = 0.0;
+        for(double t : frameTimes) total += t;
+        vector<double> sorted = frameTimes;
+        std::sort(sorted.begin(), sorted.end());
+        double mean = sorted.empty() ? 0.0 : total / sorted.size();
+        double p99 = sorted.empty() ? 0.0 : sorted[static_cast<size_t>(std::ceil(sorted.size() * 0.99)) - 1];
+        double worst = sorted.empty() ? 0.0 : sorted.back();
+        printf("%-10s %8d %10.3f %10.3f %10.3f\n", scene.name, options.frames, mean, p99, worst);
+    }
+
+    return failures > 0 ? 1 : 0;
+}
+
+int main(int argc, char* argv[]) {
+    StartupProfiler startup;
+
+    // 명령행 옵션: --fixed-res[=N] 이면 기본 해상도의 N배로 고정 렌더링 후 스케일 출력
+    // --bench: 창 없이 장면별 프레임 시간을 측정 (--frames=N, --golden=DIR, --golden-compare=DIR)
+    int fixedResMultiple = 0;
+    bool benchMode = false;
+    BenchOptions benchOptions;
+    // --puzzle=FILE[:N]: 퍼즐 팩의 N번 문제 (생략하면 날짜로 고른 오늘의 문제)
+    // --patterns=FILE: 힌트용 패턴 라이브러리 (기본 patterns.bin, 없으면 힌트 없음)
+    // --spectate[=PATH]: 관전 스트림을 공유 메모리 링에 씀 (puyo_spectate로 관전)
+    string puzzlePath;
+    string patternsPath = "patterns.bin";
+    string spectatePath;
+    // --scores=PREFIX: 점수 기록 파일 (기본 puyo_scores.*), --player=NAME: 기록할 이름 (기본 로그인 이름)
+    string scoresPrefix = "puyo_scores";
+    string playerName;
+    // --cpu: CPU 자동 플레이로 시작 (게임 중 C 키로 전환), --cpu-threads=N: 탐색 워커 수,
+    // --cpu-budget=FRACTION[:MAXMS]: 레벨별 생각 시간 = 바닥까지 떨어지는 시간 * FRACTION (최대 MAXMS),
+    // --cpu-weights=FILE: 튜너가 만든 가중치
+    bool cpuAtStart = false;
+    CpuPlayer cpu;
+    string cpuWeightsPath;
+    // --idle-fps=N: 대기 화면 애니메이션 빈도 (기본 10, 0이면 항상 60 FPS로 그림)
+    IdleGovernor idleGovernor;
+    // --metrics=PORT: 127.0.0.1:PORT/metrics 에 Prometheus 형식 계측을 노출
+    int metricsPort = 0;
+    // --checkpoint=FILE: 진행 중인 게임 체크포인트 (기본 puyo_checkpoint.bin, 빈 값이면 끔)
+    string checkpointPath = "puyo_checkpoint.bin";
+    for(int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if(arg == "--fixed-res") {
+            fixedResMultiple = 1;
+        } else if(arg.rfind("--fixed-res=", 0) == 0) {
+            fixedResMultiple = std::max(1, atoi(arg.c_str() + 12));
+        } else if(arg == "--bench") {
+            benchMode = true;
+        } else if(arg.rfind("--frames=", 0) == 0) {
+            benchOptions.frames = std::max(1, atoi(arg.c_str() + 9));
+        } else if(arg.rfind("--golden=", 0) == 0) {
+            benchOptions.goldenDir = arg.substr(9);
+        } else if(arg.rfind("--golden-compare=", 0) == 0) {
+            benchOptions.compareDir = arg.substr(17);
+        } else if(arg.rfind("--puzzle=", 0) == 0) {
+            puzzlePath = arg.substr(9);
+        } else if(arg.rfind("--patterns=", 0) == 0) {
+            patternsPath = arg.substr(11);
+        } else if(arg == "--spectate") {
+            spectatePath = stream::DEFAULT_PATH;
+        } else if(arg.rfind("--spectate=", 0) == 0) {
+            spectatePath = arg.substr(11);
+        } else if(arg.rfind("--scores=", 0) == 0) {
+            scoresPrefix = arg.substr(9);
+        } else if(arg.rfind("--player=", 0) == 0) {
+            playerName = arg.substr(9);
+        } else if(arg == "--cpu") {
+            cpuAtStart = true;
+        } else if(arg.rfind("--cpu-threads=", 0) == 0) {
+            cpu.threads = std::max(1, atoi(arg.c_str() + 14));
+        } else if(arg.rfind("--cpu-budget=", 0) == 0) {
+            cpu.budget.fraction = std::max(0.0f, static_cast<float>(atof(arg.c_str() + 13)));
+            size_t colon = arg.find(':');
+            if(colon != string::npos) cpu.budget.maxSeconds = std::max(1, atoi(arg.c_str() + colon + 1)) / 1000.0f;
+        } else if(arg.rfind("--cpu-weights=", 0) == 0) {
+            cpuWeightsPath = arg.substr(14);
+        } else if(arg.rfind("--idle-fps=", 0) == 0) {
+            idleGovernor.idleFps = std::max(0.0f, static_cast<float>(atof(arg.c_str() + 11)));
+        } else if(arg.rfind("--metrics=", 0) == 0) {
+            metricsPort = atoi(arg.c_str() + 10);
+        } else if(arg.rfind("--checkpoint=", 0) == 0) {
+            checkpointPath = arg.substr(13);
+        }
+    }
+
+    if(benchMode) {
+        benchOptions.resolutionMultiple = std::max(1, fixedResMultiple);
+        benchOptions.goldenFrame = std::min(benchOptions.goldenFrame, benchOptions.frames - 1);
+        return runBenchmark(benchOptions);
+    }
+
+    // 초기 윈도우 설정
+    DisplaySettings display;
+    FontManager fontManager;
     
+    // 폰트 로딩: 내장 폰트는 즉시, 나머지는 메뉴가 그려지는 동안 백그라운드에서
+    fontManager.loadEmbeddedFonts();
+    startup.mark("embedded fonts");
+    fontManager.loadSystemFontsAsync();
+    bool fontsLoaded = fontManager.isLoaded();
+    
+    sf::RenderWindow window(sf::VideoMode(display.windowWidth, display.windowHeight), 
+                           "Enhanced Puyo Puyo Pro - Responsive", 
+                           sf::Style::Titlebar | sf::Style::Close | sf::Style::Resize);
+    window.setFramerateLimit(60);
+    window.setVerticalSyncEnabled(true);
+    startup.mark("window created");
+    bool firstFrameShown = false;
+
+    // 고정 해상도 모드: 장면을 오프스크린에 한 번 그리고 레터박스 스프라이트로 출력
+    sf::RenderTexture offscreen;
+    bool fixedRes = false;
+    if(fixedResMultiple > 0) {
+        fixedRes = offscreen.create(BASE_WINDOW_WIDTH * fixedResMultiple, BASE_WINDOW_HEIGHT * fixedResMultiple);
+        if(fixedRes) {
+            offscreen.setSmooth(true);
+            display.updateScale(offscreen.getSize().x, offscreen.getSize().y);
+        }
+    }
+    sf::RenderTarget& target = fixedRes ? static_cast<sf::RenderTarget&>(offscreen) : window;
+    sf::Vector2u lastWindowSize(0, 0);
+
+    EffectBudget effectBudget;
+    Board board(display, effectBudget);
+    GameState gameState = MENU;
+    GlowCache glowCache;
+    TextRenderer textRenderer(fontManager, display, glowCache);
+    DigitRenderer digitRenderer(fontManager, display, glowCache);
+    GameRenderer gameRenderer(display, textRenderer, digitRenderer);
+
+    PuzzleSession puzzleSession;
+    if(!puzzlePath.empty()) {
+        int requested = -1;
+        size_t colon = puzzlePath.rfind(':');
+        if(colon != string::npos && colon + 1 < puzzlePath.size() && isdigit(static_cast<unsigned char>(puzzlePath[colon + 1]))) {
+            requested = atoi(puzzlePath.c_str() + colon + 1);
+            puzzlePath = puzzlePath.substr(0, colon);
+        }
+        vector<puzzle::Puzzle> pack;
+        if(puzzle::loadPack(puzzlePath, pack) && !pack.empty()) {
+            int day = static_cast<int>(time(nullptr) / 86400);
+            puzzleSession.index = (requested >= 0 ? requested : day) % static_cast<int>(pack.size());
+            puzzleSession.current = pack[puzzleSession.index];
+            puzzleSession.active = true;
+            gameRenderer.puzzle = &puzzleSession;
+        } else {
+            fprintf(stderr, "puzzle: cannot load %s\n", puzzlePath.c_str());
+        }
+    }
+
+    PatternHint patternHint;
+    if(patternHint.library.open(patternsPath)) {
+        gameRenderer.hint = &patternHint;
+        startup.mark("pattern library mapped");
+    }
+
+    if(!cpuWeightsPath.empty() && !cpu.weights.load(cpuWeightsPath)) {
+        fprintf(stderr, "cpu: cannot load weights %s\n", cpuWeightsPath.c_str());
+    }
+    if(patternHint.available()) cpu.library = &patternHint.library;
+    gameRenderer.cpu = &cpu;
+    if(cpuAtStart) cpu.setEnabled(true);
+
+    ScoreBoard scoreBoard;
+    if(scoreBoard.store.open(scoresPrefix)) {
+        const char* user = getenv("USER") ? getenv("USER") : getenv("USERNAME");
+        scoreBoard.player = !playerName.empty() ? playerName : user ? user : "player";
+        gameRenderer.scoreBoard = &scoreBoard;
+        startup.mark("score index mapped");
+    } else {
+        fprintf(stderr, "scores: cannot open %s.log\n", scoresPrefix.c_str());
+    }
+
+    // 퍼즐은 정해진 판이라 체크포인트를 쓰지 않음
+    GameCheckpoint savedGame;
+    if(!checkpointPath.empty() && !puzzleSession.active) {
+        if(savedGame.open(checkpointPath)) {
+            gameRenderer.savedGame = &savedGame;
+            startup.mark("checkpoint mapped");
+        } else {
+            fprintf(stderr, "checkpoint: cannot map %s\n", checkpointPath.c_str());
+        }
+    }
+
+    stream::SpectatorWriter spectator;
+    if(!spectatePath.empty()) {
+        if(spectator.open(spectatePath)) startup.mark("spectator ring mapped");
+        else fprintf(stderr, "spectate: cannot map %s\n", spectatePath.c_str());
+    }
+
+    // 계측: 뜨거운 경로에서는 기록만 하고, 노출기 스레드가 긁힐 때 합침
+    metrics::Registry registry;
+    metrics::Histogram& frameTime = registry.histogram("puyo_frame_seconds", "Update and render time per frame, excluding vsync");
+    metrics::Histogram& tickTime = registry.histogram("puyo_tick_seconds", "Game logic time per frame while playing");
+    metrics::Histogram& chainTime = registry.histogram("puyo_chain_resolve_seconds", "Time to resolve the chain after a lock");
+    metrics::Counter& framesTotal = registry.counter("puyo_frames_total", "Frames rendered");
+    metrics::Counter& gamesTotal = registry.counter("puyo_games_total", "Games finished");
+    metrics::Gauge& particleGauge = registry.gauge("puyo_particles", "Live particles");
+    metrics::Gauge& tweenGauge = registry.gauge("puyo_tweens", "Running tweens on the effect timeline");
+    metrics::Gauge& frameDraws = registry.gauge("puyo_draw_calls_per_frame", "Draw calls in the last frame");
+    metrics::Gauge& frameAllocations = registry.gauge("puyo_allocations_per_frame", "operator new calls (all threads) during the last frame");
+    metrics::Gauge& idleGauge = registry.gauge("puyo_idle", "1 while the idle screen is sleeping between frames");
+    metrics::Histogram& checkpointTime = registry.histogram("puyo_checkpoint_write_seconds", "Time to copy the game state into the checkpoint slot");
+    registry.expose("puyo_draw_calls_total", "Draw calls", drawCalls());
+    registry.expose("puyo_allocations_total", "operator new calls", metrics::allocations());
+    metrics::HttpExporter metricsHttp;
+    if(metricsPort > 0) {
+        if(metricsHttp.start(registry, metricsPort)) startup.mark("metrics endpoint up");
+        else fprintf(stderr, "metrics: cannot listen on 127.0.0.1:%d\n", metricsPort);
+    }
+    uint64_t lastDraws = drawCalls().value(), lastAllocations = metrics::allocations().value();
+
+    // 게임 진행 난수 (시드 + 사용 횟수로 재현 가능)
+    PuyoRng gameRng(static_cast<uint32_t>(time(nullptr)));
+    PuyoPair cur = makeSpawnPair(gameRng);
+    PuyoPair nextPair = makeSpawnPair(gameRng);
+    bool alive = true;
+
+    float fallTimer = 0.f;
+    InputState leftInput, rightInput, downInput, rotateInput, rotateCCWInput;
+
+    sf::Clock clock;
+    float backgroundTime = 0.0f;
+
+    auto resetGame = [&](){
+        board.clear();
+        gameRng.reseed(static_cast<uint32_t>(rng()()));
+        cur = makeSpawnPair(gameRng);
+        nextPair = makeSpawnPair(gameRng);
+        if(puzzleSession.active) {
+            board.g = puzzleSession.current.board;
+            puzzleSession.placed = 0;
+            puzzleSession.status = PuzzleSession::RUNNING;
+            cur = puzzleSession.piece(0);
+            nextPair = puzzleSession.piece(1);
+        }
+        board.chainAnalyzer.update(board);
+        board.spawnPiece();
+        patternHint.hide();
+        scoreBoard.beginGame();
+        savedGame.beginGame(static_cast<uint64_t>(time(nullptr)) << 32 | gameRng.seed);
+        cpu.begin(board, cur, nextPair);
+        alive = true;
+        fallTimer = 0;
+        gameState = PLAYING;
+        spectator.event(stream::EV_RESET);
+    };
+
+    // 체크포인트에 쓸 논리 상태
+    auto checkpointState = [&]() {
+        checkpoint::GameSnapshot s{};
+        s.gameId = savedGame.gameId;
+        s.rngSeed = gameRng.seed;
+        s.rngDraws = gameRng.draws;
+        s.score = board.score;
+        s.level = board.level;
+        s.combo = board.combo;
+        s.linesCleared = board.totalLinesCleared;
+        s.maxChain = scoreBoard.maxChain;
+        s.playTime = scoreBoard.playTime;
+        s.fallTimer = fallTimer;
+        for(int y = 0; y < ROWS; y++)
+            for(int x = 0; x < COLS; x++) s.grid[y][x] = static_cast<uint8_t>(board.g[y][x]);
+        s.curX = static_cast<int8_t>(cur.pivot.x);
+        s.curY = static_cast<int8_t>(cur.pivot.y);
+        s.curOrientation = static_cast<uint8_t>(moves::orientationIndex(cur.sub));
+        s.curC1 = cur.c1;
+        s.curC2 = cur.c2;
+        s.nextC1 = nextPair.c1;
+        s.nextC2 = nextPair.c2;
+        s.byCpu = cpu.enabled ? 1 : 0;
+        return s;
+    };
+
+    // 저장된 게임으로 돌아감: 일시정지 상태로 시작 (ESC로 계속)
+    auto resumeGame = [&]() {
+        const checkpoint::GameSnapshot& s = savedGame.saved;
+        board.clear();
+        for(int y = 0; y < ROWS; y++)
+            for(int x = 0; x < COLS; x++) board.g[y][x] = static_cast<Color>(s.grid[y][x]);
+        board.score = static_cast<int>(s.score);
+        board.level = s.level;
+        board.combo = s.combo;
+        board.totalLinesCleared = s.linesCleared;
+        board.chainAnalyzer.update(board);
+        gameRng.restore(s.rngSeed, s.rngDraws);
+        cur = PuyoPair();
+        cur.pivot = { s.curX, s.curY };
+        cur.sub = orientationOffset(s.curOrientation % NUM_ORIENTATIONS);
+        cur.c1 = static_cast<Color>(s.curC1);
+        cur.c2 = static_cast<Color>(s.curC2);
+        nextPair = PuyoPair();
+        nextPair.pivot = { COLS/2, 0 };
+        nextPair.sub = { 0, -1 };
+        nextPair.c1 = static_cast<Color>(s.nextC1);
+        nextPair.c2 = static_cast<Color>(s.nextC2);
+        board.spawnPiece();
+        patternHint.hide();
+        scoreBoard.beginGame();
+        scoreBoard.replay = savedGame.savedLocks;
+        scoreBoard.maxChain = s.maxChain;
+        scoreBoard.playTime = s.playTime;
+        scoreBoard.replayComplete = s.replayComplete != 0;
+        savedGame.beginGame(s.gameId);
+        cpu.setEnabled(s.byCpu != 0);
+        cpu.begin(board, cur, nextPair);
+        alive = true;
+        fallTimer = s.fallTimer;
+        gameState = PAUSED;
+        spectator.event(stream::EV_RESET);
+    };
+
+    // 관전 스트림에 넘길 현재 상태
+    auto spectatorState = [&]() {
+        stream::State s;
+        s.g = board.g;
+        s.score = static_cast<uint32_t>(board.score);
+        s.level = static_cast<uint8_t>(board.level);
+        s.chain = static_cast<uint8_t>(board.chain);
+        s.gameState = static_cast<uint8_t>(gameState);
+        if(alive && gameState != MENU) {
+            s.px = static_cast<int8_t>(cur.pivot.x);
+            s.py = static_cast<int8_t>(cur.pivot.y);
+            for(int o = 0; o < NUM_ORIENTATIONS; o++) {
+                Vec2 v = orientationOffset(o);
+                if(v.x == cur.sub.x && v.y == cur.sub.y) s.orientation = static_cast<uint8_t>(o);
+            }
+            s.c1 = cur.c1;
+            s.c2 = cur.c2;
+            s.n1 = nextPair.c1;
+            s.n2 = nextPair.c2;
+        }
+        return s;
+    };
+
+    while(window.isOpen()) {
+        // 윈도우 크기 변경 감지 및 스케일 업데이트 (고정 해상도 모드에서는 스케일 고정)
+        sf::Vector2u windowSize = window.getSize();
+        if(!fixedRes && windowSize != lastWindowSize) {
+            display.updateScale(windowSize.x, windowSize.y);
+        }
+        lastWindowSize = windowSize;
+        sf::Vector2u currentSize = target.getSize();
+
+        if(fontManager.pollAsyncFonts()) {
+            fontsLoaded = fontManager.isLoaded();
+            startup.mark("system fonts ready");
+            idleGovernor.onInput();
+        }
+
+        sf::Event e;
+        while(window.pollEvent(e)) {
+            if(e.type == sf::Event::Closed) window.close();
+            if(e.type != sf::Event::MouseMoved) idleGovernor.onInput();
+            
+            if(e.type == sf::Event::KeyPressed) {
+                if(gameState == MENU) {
+                    if(e.key.code == sf::Keyboard::Space || e.key.code == sf::Keyboard::Return) {
+                        resetGame();
+                    } else if(e.key.code == sf::Keyboard::R && savedGame.resumable) {
+                        resumeGame();
+                    } else if(e.key.code == sf::Keyboard::L && scoreBoard.available()) {
+                        scoreBoard.refresh();
+                        gameState = LEADERBOARD;
+                    } else if(e.key.code == sf::Keyboard::Escape) {
+                        window.close();
+                    }
+                } else if(gameState == LEADERBOARD) {
+                    if(e.key.code == sf::Keyboard::Escape || e.key.code == sf::Keyboard::L) {
+                        gameState = MENU;
+                    }
+                } else if(gameState == GAME_OVER) {
+                    if(e.key.code == sf::Keyboard::R) {
+                        resetGame();
+                    } else if(e.key.code == sf::Keyboard::Escape) {
+                        gameState = MENU;
+                    }
+                } else if(gameState == PLAYING) {
+                    if(e.key.code == sf::Keyboard::Escape) {
+                        gameState = PAUSED;
+                    } else if(e.key.code == sf::Keyboard::H && alive) {
+                        patternHint.request(board, cur);
+                    } else if(e.key.code == sf::Keyboard::C && alive) {
+                        cpu.setEnabled(!cpu.enabled);
+                        cpu.begin(board, cur, nextPair);
+                    }
+                } else if(gameState == PAUSED) {
+                    if(e.key.code == sf::Keyboard::Escape) {
+                        gameState = PLAYING;
+                    } else if(e.key.code == sf::Keyboard::R) {
+                        resetGame();
+                    }
+                }
+            }
+        }
+
+        // 대기 화면: 다음 저속 프레임 전이면 그리지 않고 잠 (게임 중이거나 이펙트가 남아 있으면 전속)
+        if(idleGovernor.rest(gameState != PLAYING && !board.effectsActive() && !patternHint.visible())) continue;
+
+        float dt = clock.restart().asSeconds();
+        if(idleGovernor.consumeWake()) dt = std::min(dt, effectBudget.frameBudget);
+        sf::Clock workClock; // vsync 대기를 뺀 프레임 작업 시간
+        uint64_t frameStart = metrics::nowNanos();
+        effectBudget.beginFrame();
+        backgroundTime += dt;
+
+        // 게임 로직
+        if(gameState == PLAYING && alive) {
+            metrics::ScopedTimer tickTimer(tickTime);
+            scoreBoard.playTime += dt;
+            
+            leftInput.update(dt, sf::Keyboard::isKeyPressed(sf::Keyboard::Left));
+            rightInput.update(dt, sf::Keyboard::isKeyPressed(sf::Keyboard::Right));
+            downInput.update(dt, sf::Keyboard::isKeyPressed(sf::Keyboard::Down));
+            rotateInput.update(dt, sf::Keyboard::isKeyPressed(sf::Keyboard::Up) || 
+                              sf::Keyboard::isKeyPressed(sf::Keyboard::Z));
+            rotateCCWInput.update(dt, sf::Keyboard::isKeyPressed(sf::Keyboard::X) ||
+                                 sf::Keyboard::isKeyPressed(sf::Keyboard::A));
+
+            // CPU 자동 플레이 중에는 키 대신 CPU가 조작 (탐색은 워커 스레드, 여기서는 결과만 읽음)
+            bool human = !cpu.enabled;
+            cpu.update(dt, board, cur);
+
+            if(human && leftInput.shouldTrigger() && canMove(board, cur, -1, 0)) {
+                cur.pivot.x -= 1;
+            }
+            if(human && rightInput.shouldTrigger() && canMove(board, cur, +1, 0)) {
+                cur.pivot.x += 1;
+            }
+
+            // 벽 차기까지 실패하면 회전하지 않음 (겹친 채로 회전되던 문제)
+            if(human && rotateInput.shouldTrigger()) {
+                tryRotate(board, cur, true);
+            }
+            
+            if(human && rotateCCWInput.shouldTrigger()) {
+                tryRotate(board, cur, false);
+            }
+
+            bool locked = false;
+            fallTimer += dt;
+            float curInterval = board.getFallSpeed();
+            
+            if((human && downInput.shouldTrigger()) || cpu.wantsDrop()) {
+                curInterval = 0.02f;
+            }
+
+            if(fallTimer >= curInterval) {
+                fallTimer = 0.f;
+                
+                if(canMove(board, cur, 0, +1)) {
+                    cur.pivot.y += 1;
+                } else {
+                    board.lock(cur);
+                    patternHint.hide();
+
+                    uint64_t chainStart = metrics::nowNanos();
+                    int chainIndex = 1;
+                    while(true) {
+                        int removed = board.popGroupsAndScore(chainIndex);
+                        if(removed <= 0) break;
+                        spectator.event(stream::EV_POP, static_cast<uint8_t>(chainIndex),
+                                        static_cast<uint16_t>(removed), static_cast<uint32_t>(board.lastPoints));
+                        if(board.leveledUp) spectator.event(stream::EV_LEVEL_UP, static_cast<uint8_t>(board.level));
+                        board.applyGravity();
+                        chainIndex++;
+                    }
+                    board.chainAnalyzer.update(board);
+                    chainTime.record(metrics::nowNanos() - chainStart);
+                    scoreBoard.onLock(cur, chainIndex - 1);
+
+                    if(puzzleSession.active) {
+                        if(puzzleSession.onPlaced(chainIndex - 1)) {
+                            alive = false;
+                            gameState = GAME_OVER;
+                        } else {
+                            cur = nextPair;
+                            nextPair = puzzleSession.piece(puzzleSession.placed + 1);
+                        }
+                    } else {
+                        cur = nextPair;
+                        nextPair = makeSpawnPair(gameRng);
+                    }
+                    board.spawnPiece();
+                    cpu.begin(board, cur, nextPair);
+
+                    if(alive && board.isGameOver()) {
+                        puzzleSession.status = PuzzleSession::FAILED;
+                        alive = false;
+                        gameState = GAME_OVER;
+                    }
+                    if(!alive) {
+                        spectator.event(stream::EV_GAME_OVER);
+                        gamesTotal.add();
+                        // 퍼즐은 정해진 판이라 순위에 넣지 않음
+                        if(!puzzleSession.active) scoreBoard.recordGame(board, gameRng.seed, cpu.enabled);
+                        savedGame.finishGame();
+                        cpu.cancel();
+                    } else {
+                        locked = true;
+                    }
+                }
+            }
+
+            // 체크포인트: 매핑된 슬롯에 복사만 함 (디스크 쓰기는 flusher 스레드)
+            if(alive && savedGame.available() && savedGame.due(locked)) {
+                uint64_t saveStart = metrics::nowNanos();
+                savedGame.save(checkpointState(), scoreBoard.replay);
+                checkpointTime.record(metrics::nowNanos() - saveStart);
+            }
+        }
+
+        board.updateEffects(dt);
+        patternHint.update(dt);
+        if(spectator.isOpen()) spectator.publish(spectatorState());
+
+        // 렌더링
+        gameRenderer.render(target, board, gameState, cur, nextPair, alive, backgroundTime, fontsLoaded);
+
+        if(fixedRes) {
+            offscreen.display();
+
+            // 종횡비를 유지한 채 창 크기에 맞추고 남는 영역은 레터박스
+            float presentScale = std::min(
+                static_cast<float>(windowSize.x) / currentSize.x,
+                static_cast<float>(windowSize.y) / currentSize.y);
+            sf::Sprite frame(offscreen.getTexture());
+            frame.setScale(presentScale, presentScale);
+            frame.setPosition(
+                std::floor((windowSize.x - currentSize.x * presentScale) / 2.0f),
+                std::floor((windowSize.y - currentSize.y * presentScale) / 2.0f));
+
+            window.setView(sf::View(sf::FloatRect(0, 0, static_cast<float>(windowSize.x), static_cast<float>(windowSize.y))));
+            window.clear(sf::Color::Black);
+            drawCounted(window, frame);
+        }
+
+        float workTime = workClock.getElapsedTime().asSeconds();
+        effectBudget.recordFrame(workTime);
+        glowCache.enabled = effectBudget.glowEnabled();
+        idleGovernor.frameRendered(workTime);
+        frameTime.record(metrics::nowNanos() - frameStart);
+        framesTotal.add();
+        particleGauge.set(static_cast<int64_t>(board.particles.size()));
+        tweenGauge.set(static_cast<int64_t>(board.timeline.size()));
+        idleGauge.set(idleGovernor.isIdle() ? 1 : 0);
+        uint64_t draws = drawCalls().value(), allocations = metrics::allocations().value();
+        frameDraws.set(static_cast<int64_t>(draws - lastDraws));
+        frameAllocations.set(static_cast<int64_t>(allocations - lastAllocations));
+        lastDraws = draws;
+        lastAllocations = allocations;
+
+        window.display();
+        if(!firstFrameShown) {
+            firstFrameShown = true;
+            startup.mark("first frame");
+        }
+    }
+
+    savedGame.shutdown();
+    idleGovernor.report();
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,139 @@
+#pragma once
+// ---- 메모리 맵 파일 (POSIX mmap / Win32 파일 매핑) ----
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#ifdef _WIN32
+#  ifndef WIN32_LEAN_AND_MEAN
+#    define WIN32_LEAN_AND_MEAN
+#  endif
+#  ifndef NOMINMAX
+#    define NOMINMAX
+#  endif
+#  include <windows.h>
+#else
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+class MappedFile {
+public:
+    enum Mode { READ_ONLY, READ_WRITE };
+
+private:
+    std::uint8_t* ptr = nullptr;
+    size_t length = 0;
+    Mode mode = READ_ONLY;
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#else
+    int fd = -1;
+#endif
+
+public:
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other) noexcept { *this = static_cast<MappedFile&&>(other); }
+
+    MappedFile& operator=(MappedFile&& other) noexcept {
+        if(this != &other) {
+            close();
+            ptr = other.ptr; length = other.length; mode = other.mode;
+#ifdef _WIN32
+            file = other.file; mapping = other.mapping;
+            other.file = INVALID_HANDLE_VALUE; other.mapping = nullptr;
+#else
+            fd = other.fd;
+            other.fd = -1;
+#endif
+            other.ptr = nullptr; other.length = 0;
+        }
+        return *this;
+    }
+
+    ~MappedFile() { close(); }
+
+    // READ_WRITE에서 size > 0이면 파일을 만들고 해당 크기로 맞춤
+    bool open(const std::string& path, Mode openMode = READ_ONLY, size_t size = 0) {
+        close();
+        mode = openMode;
+        bool writable = openMode == READ_WRITE;
+#ifdef _WIN32
+        file = CreateFileA(path.c_str(), writable ? (GENERIC_READ | GENERIC_WRITE) : GENERIC_READ,
+                           FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+                           writable ? OPEN_ALWAYS : OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if(file == INVALID_HANDLE_VALUE) return false;
+
+        LARGE_INTEGER fileSize;
+        if(!GetFileSizeEx(file, &fileSize)) { close(); return false; }
+        length = static_cast<size_t>(fileSize.QuadPart);
+        if(writable && size > 0 && length != size) {
+            LARGE_INTEGER newSize;
+            newSize.QuadPart = static_cast<LONGLONG>(size);
+            if(!SetFilePointerEx(file, newSize, nullptr, FILE_BEGIN) || !SetEndOfFile(file)) { close(); return false; }
+            length = size;
+        }
+        if(length == 0) { close(); return false; }
+
+        mapping = CreateFileMappingA(file, nullptr, writable ? PAGE_READWRITE : PAGE_READONLY, 0, 0, nullptr);
+        if(!mapping) { close(); return false; }
+        ptr = static_cast<std::uint8_t*>(MapViewOfFile(mapping, writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, length));
+        if(!ptr) { close(); return false; }
+#else
+        fd = ::open(path.c_str(), writable ? (O_RDWR | O_CREAT) : O_RDONLY, 0644);
+        if(fd < 0) return false;
+
+        struct stat st;
+        if(fstat(fd, &st) != 0) { close(); return false; }
+        length = static_cast<size_t>(st.st_size);
+        if(writable && size > 0 && length != size) {
+            if(ftruncate(fd, static_cast<off_t>(size)) != 0) { close(); return false; }
+            length = size;
+        }
+        if(length == 0) { close(); return false; }
+
+        void* mapped = mmap(nullptr, length, writable ? (PROT_READ | PROT_WRITE) : PROT_READ, MAP_SHARED, fd, 0);
+        if(mapped == MAP_FAILED) { close(); return false; }
+        ptr = static_cast<std::uint8_t*>(mapped);
+#endif
+        return true;
+    }
+
+    // 변경 내용을 디스크로 내보냄 (async면 요청만 하고 바로 반환)
+    void flush(bool async = true) {
+        if(!ptr || mode != READ_WRITE) return;
+#ifdef _WIN32
+        FlushViewOfFile(ptr, 0);
+        if(!async) FlushFileBuffers(file);
+#else
+        msync(ptr, length, async ? MS_ASYNC : MS_SYNC);
+#endif
+    }
+
+    void close() {
+#ifdef _WIN32
+        if(ptr) UnmapViewOfFile(ptr);
+        if(mapping) CloseHandle(mapping);
+        if(file != INVALID_HANDLE_VALUE) CloseHandle(file);
+        mapping = nullptr;
+        file = INVALID_HANDLE_VALUE;
+#else
+        if(ptr) munmap(ptr, length);
+        if(fd >= 0) ::close(fd);
+        fd = -1;
+#endif
+        ptr = nullptr;
+        length = 0;
+    }
+
+    bool isOpen() const { return ptr != nullptr; }
+    std::uint8_t* data() { return ptr; }
+    const std::uint8_t* data() const { return ptr; }
+    size_t size() const { return length; }
+};
@@ -0,0 +1,229 @@
+#pragma once
+// ---- CPU 평가 함수 (특징 * 가중치) : 게임 CPU, 튜너, 데이터 도구 공용 ----
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <string>
+
+#include "puyo_core.hpp"
+#include "puyo_chain.hpp"
+#include "puyo_patterns.hpp"
+
+namespace ai {
+
+enum Feature {
+    F_SCORE_GAINED,     // 이번 배치로 얻은 점수 (/1000)
+    F_CHAIN_POTENTIAL,  // 한 개를 더 놓아 터뜨릴 수 있는 최대 연쇄 수
+    F_CONNECT_2,        // 같은 색 2개짜리 그룹 수
+    F_CONNECT_3,        // 같은 색 3개짜리 그룹 수
+    F_MAX_HEIGHT,       // 가장 높은 열
+    F_BUMPINESS,        // 이웃 열 높이 차이 합
+    F_DANGER,           // 게임 오버 줄(1행) 근처 셀 수
+    F_SPAWN_BLOCKED,    // 스폰 열 높이 (막히면 바로 패배)
+    F_PATTERN_MATCH,    // 패턴 라이브러리 일치 가치 (완성도 * 연쇄 수, 라이브러리가 없으면 0)
+    FEATURE_COUNT
+};
+
+static const char* const FEATURE_NAMES[FEATURE_COUNT] = {
+    "score_gained", "chain_potential", "connect_2", "connect_3",
+    "max_height", "bumpiness", "danger", "spawn_blocked", "pattern_match"
+};
+
+using Features = std::array<float, FEATURE_COUNT>;
+
+// 가중치 파일 첫 줄: "puyo_weights 버전 특징수" (특징이 바뀐 옛 파일을 잘못 읽지 않도록)
+static const int WEIGHTS_VERSION = 1;
+
+struct EvalWeights {
+    Features w{};
+
+    // 손으로 맞춘 기본값 (튜너의 시작점)
+    static EvalWeights defaults() {
+        EvalWeights e;
+        e.w = {{ 1.0f, 0.6f, 0.05f, 0.2f, -0.1f, -0.05f, -1.5f, -0.4f, 0.3f }};
+        return e;
+    }
+
+    float evaluate(const Features& f) const {
+        float v = 0.0f;
+        for(int i = 0; i < FEATURE_COUNT; i++) v += w[i] * f[i];
+        return v;
+    }
+
+    // 헤더 줄 + "이름 값" 줄 단위 텍스트
+    bool save(const std::string& path) const {
+        FILE* fp = std::fopen(path.c_str(), "w");
+        if(!fp) return false;
+        std::fprintf(fp, "puyo_weights %d %d\n", WEIGHTS_VERSION, FEATURE_COUNT);
+        for(int i = 0; i < FEATURE_COUNT; i++) std::fprintf(fp, "%s %.9g\n", FEATURE_NAMES[i], w[i]);
+        return std::fclose(fp) == 0;
+    }
+
+    // 헤더가 없거나 버전/특징 수가 다르거나 빠진 특징이 있으면 false (w는 그대로)
+    bool load(const std::string& path) {
+        FILE* fp = std::fopen(path.c_str(), "r");
+        if(!fp) return false;
+        int version = 0, count = 0;
+        bool ok = std::fscanf(fp, " puyo_weights %d %d", &version, &count) == 2 &&
+                  version == WEIGHTS_VERSION && count == FEATURE_COUNT;
+        Features loaded = w;
+        int seen = 0;
+        char name[64];
+        float value;
+        while(ok && std::fscanf(fp, "%63s %f", name, &value) == 2) {
+            int i = 0;
+            while(i < FEATURE_COUNT && std::string(name) != FEATURE_NAMES[i]) i++;
+            ok = i < FEATURE_COUNT && !(seen & (1 << i));
+            if(ok) {
+                loaded[i] = value;
+                seen |= 1 << i;
+            }
+        }
+        std::fclose(fp);
+        if(!ok || seen != (1 << FEATURE_COUNT) - 1) return false;
+        w = loaded;
+        return true;
+    }
+};
+
+template<class R>
+inline int columnHeight(const BasicBoard<R>& b, int x) {
+    int y = 0;
+    while(y < ROWS && b.g[y][x] == EMPTY) y++;
+    return ROWS - y;
+}
+
+// 각 열 맨 위에 한 개를 더 놓았을 때의 최대 연쇄 수 (연쇄 분석기의 빠른 시뮬레이션 사용)
+template<class R>
+inline int chainPotential(const BasicBoard<R>& b) {
+    return chain::maxTriggerChain(b.g, 1);
+}
+
+// 연결 그룹 크기별 개수 (4 이상은 이미 터졌으므로 2, 3만 셈)
+template<class R>
+inline void countGroups(const BasicBoard<R>& b, int& pairs, int& triples) {
+    pairs = 0;
+    triples = 0;
+    std::array<std::array<bool, COLS>, ROWS> vis{};
+    Vec2 stack[ROWS * COLS];
+    for(int y = 0; y < ROWS; y++) {
+        for(int x = 0; x < COLS; x++) {
+            if(b.g[y][x] == EMPTY || vis[y][x]) continue;
+            Color c = b.g[y][x];
+            int size = 0, top = 0;
+            stack[top++] = {x, y};
+            vis[y][x] = true;
+            while(top > 0) {
+                Vec2 v = stack[--top];
+                size++;
+                const int dx[4] = {1, -1, 0, 0};
+                const int dy[4] = {0, 0, 1, -1};
+                for(int i = 0; i < 4; i++) {
+                    int nx = v.x + dx[i], ny = v.y + dy[i];
+                    if(inBounds(nx, ny) && !vis[ny][nx] && b.g[ny][nx] == c) {
+                        vis[ny][nx] = true;
+                        stack[top++] = {nx, ny};
+                    }
+                }
+            }
+            if(size == 2) pairs++;
+            else if(size == 3) triples++;
+        }
+    }
+}
+
+template<class R>
+inline Features computeFeatures(const BasicBoard<R>& b, typename R::Score scoreGained,
+                                const patterns::PatternLibrary* library = nullptr) {
+    Features f{};
+    f[F_SCORE_GAINED] = static_cast<float>(scoreGained) / 1000.0f;
+    f[F_CHAIN_POTENTIAL] = static_cast<float>(chainPotential(b));
+
+    int pairs, triples;
+    countGroups(b, pairs, triples);
+    f[F_CONNECT_2] = static_cast<float>(pairs);
+    f[F_CONNECT_3] = static_cast<float>(triples);
+
+    int maxHeight = 0, bump = 0, prev = -1;
+    for(int x = 0; x < COLS; x++) {
+        int h = columnHeight(b, x);
+        maxHeight = std::max(maxHeight, h);
+        if(prev >= 0) bump += std::abs(h - prev);
+        prev = h;
+    }
+    f[F_MAX_HEIGHT] = static_cast<float>(maxHeight);
+    f[F_BUMPINESS] = static_cast<float>(bump);
+
+    int danger = 0;
+    for(int y = 2; y <= 4; y++)
+        for(int x = 0; x < COLS; x++)
+            if(b.g[y][x] != EMPTY) danger += 5 - y;
+    f[F_DANGER] = static_cast<float>(danger);
+    f[F_SPAWN_BLOCKED] = static_cast<float>(columnHeight(b, COLS/2));
+
+    if(library && library->isOpen()) {
+        float value = 0.0f;
+        library->bestMatch(b.g, &value);
+        f[F_PATTERN_MATCH] = value;
+    }
+    return f;
+}
+
+// 배치 24가지 중 평가값이 가장 높은 것 (모두 패배면 0)
+template<class R>
+inline int choosePlacement(const BasicBoard<R>& board, const PuyoPair& cur, const EvalWeights& weights,
+                           const patterns::PatternLibrary* library = nullptr) {
+    int best = 0;
+    float bestValue = -1e30f;
+    for(int action = 0; action < NUM_PLACEMENTS; action++) {
+        // 같은 색 쌍은 위/아래, 좌/우 배치가 같은 결과
+        if(cur.c1 == cur.c2 && action / COLS >= 2) break;
+
+        BasicBoard<R> trial = board;
+        typename R::Score before = trial.score;
+        dropPlacement(trial, cur, action / COLS, action % COLS);
+        trial.resolveChains();
+        if(trial.isGameOver()) continue;
+
+        float value = weights.evaluate(computeFeatures(trial, trial.score - before, library));
+        if(value > bestValue) {
+            bestValue = value;
+            best = action;
+        }
+    }
+    return best;
+}
+
+struct GameResult {
+    std::int64_t score = 0;
+    int moves = 0;
+    int maxChain = 0;
+    bool survived = false;
+};
+
+// 헤드리스 한 판 (같은 시드면 같은 뿌요 순서: 튜너의 공통 난수용). Board로 규칙을 고름
+template<class Board = BoardCore>
+inline GameResult playGame(const EvalWeights& weights, std::uint32_t seed, int maxMoves,
+                           const patterns::PatternLibrary* library = nullptr) {
+    GameResult r;
+    PuyoRng rng(seed);
+    Board board;
+    PuyoPair cur = makeSpawnPair(rng);
+    PuyoPair next = makeSpawnPair(rng);
+    for(r.moves = 0; r.moves < maxMoves; r.moves++) {
+        int action = choosePlacement(board, cur, weights, library);
+        dropPlacement(board, cur, action / COLS, action % COLS);
+        r.maxChain = std::max(r.maxChain, board.resolveChains());
+        if(board.isGameOver()) {
+            r.score = board.score;
+            return r;
+        }
+        cur = next;
+        next = makeSpawnPair(rng);
+    }
+    r.score = board.score;
+    r.survived = true;
+    return r;
+}
+
+} // namespace ai
@@ -0,0 +1,285 @@
+#pragma once
+// ---- 연쇄 잠재력 분석기 ----
+// resolve(): 바뀐 셀(추가/낙하)에서만 그룹을 찾는 빠른 연쇄 시뮬레이션.
+//            안정된 보드(4개 이상 그룹 없음)에서 출발하면 BoardCore::resolveChains와 결과가 같음
+// ChainAnalyzer: 열/색/개수별 트리거 결과를 보관하고, 잠금 후 바뀐 열에 닿는 항목만 다시 계산
+#include <chrono>
+#include <cstring>
+
+#include "puyo_core.hpp"
+
+namespace chain {
+
+using Grid = std::array<std::array<Color, COLS>, ROWS>;
+using Rules = BoardCore::Rules;    // 게임과 같은 규칙으로 점수 계산
+
+static const int MAX_STEPS = BoardCore::MAX_CELLS / 4;
+static const int MAX_EXTRA = 3;                 // 트리거로 쌓아 보는 최대 개수
+static const int NUM_COLORS = COLOR_COUNT - 1;
+
+struct ChainOutcome {
+    int chain = 0;
+    int score = 0;                 // 연쇄 후 점수 (레벨업 보너스 포함)
+    int level = 1;
+    std::uint8_t columnMask = 0;   // 시뮬레이션이 읽거나 바꾼 열
+    std::array<std::uint8_t, MAX_STEPS> removed{};
+    std::array<std::uint8_t, MAX_STEPS> groups{};
+    std::array<std::uint8_t, MAX_STEPS> colors{};
+    std::array<std::uint8_t, MAX_STEPS> groupBonus{};
+
+    ChainStep step(int i) const { return ChainStep{removed[i], i + 1, groups[i], colors[i], groupBonus[i]}; }
+};
+
+inline std::uint8_t neighborColumns(int x) {
+    std::uint8_t m = static_cast<std::uint8_t>(1u << x);
+    if(x > 0) m |= static_cast<std::uint8_t>(1u << (x - 1));
+    if(x < COLS - 1) m |= static_cast<std::uint8_t>(1u << (x + 1));
+    return m;
+}
+
+// 단계별 요약으로 점수만 다시 계산 (보드 점수/레벨이 바뀌었을 때)
+inline int replayScore(const ChainOutcome& o, int score, int level) {
+    for(int step = 0; step < o.chain; step++) {
+        score += BoardCore::stepScore(o.step(step), level);
+        BoardCore::applyLevelUp(score, level);
+    }
+    return score;
+}
+
+// seeds == nullptr이면 모든 셀을 검사 (안정 여부를 모르는 보드)
+inline ChainOutcome resolve(Grid& g, const Vec2* seeds, int seedCount, int score, int level) {
+    ChainOutcome out;
+    out.score = score;
+    out.level = level;
+
+    Vec2 dirty[BoardCore::MAX_CELLS];
+    int dirtyCount = 0;
+    if(seeds) {
+        for(int i = 0; i < seedCount; i++) dirty[dirtyCount++] = seeds[i];
+    } else {
+        for(int y = 0; y < ROWS; y++)
+            for(int x = 0; x < COLS; x++)
+                dirty[dirtyCount++] = {x, y};
+    }
+
+    Vec2 popped[BoardCore::MAX_CELLS];
+    Vec2 stack[BoardCore::MAX_CELLS];
+    while(dirtyCount > 0 && out.chain < MAX_STEPS) {
+        bool visited[ROWS][COLS];
+        std::memset(visited, 0, sizeof(visited));
+        int poppedCount = 0;
+        int groupCount = 0;
+        int groupBonus = 0;
+        unsigned colorMask = 0;
+
+        for(int d = 0; d < dirtyCount; d++) {
+            int x = dirty[d].x, y = dirty[d].y;
+            out.columnMask |= neighborColumns(x);
+            if(g[y][x] == EMPTY || visited[y][x]) continue;
+
+            Color c = g[y][x];
+            int start = poppedCount;
+            int top = 0;
+            stack[top++] = {x, y};
+            visited[y][x] = true;
+            while(top > 0) {
+                Vec2 v = stack[--top];
+                popped[poppedCount++] = v;
+                out.columnMask |= neighborColumns(v.x);
+                if(v.x > 0 && !visited[v.y][v.x-1] && g[v.y][v.x-1] == c) { visited[v.y][v.x-1] = true; stack[top++] = {v.x-1, v.y}; }
+                if(v.x < COLS-1 && !visited[v.y][v.x+1] && g[v.y][v.x+1] == c) { visited[v.y][v.x+1] = true; stack[top++] = {v.x+1, v.y}; }
+                if(v.y > 0 && !visited[v.y-1][v.x] && g[v.y-1][v.x] == c) { visited[v.y-1][v.x] = true; stack[top++] = {v.x, v.y-1}; }
+                if(v.y < ROWS-1 && !visited[v.y+1][v.x] && g[v.y+1][v.x] == c) { visited[v.y+1][v.x] = true; stack[top++] = {v.x, v.y+1}; }
+            }
+            if(poppedCount - start >= 4) {
+                groupCount++;
+                groupBonus += Rules::groupBonus(poppedCount - start);
+                colorMask |= 1u << c;
+            } else {
+                poppedCount = start;
+            }  // 4개 미만이면 제거 목록에서 되돌림
+        }
+        if(poppedCount == 0) break;
+
+        int step = out.chain++;
+        out.removed[step] = static_cast<std::uint8_t>(poppedCount);
+        out.groups[step] = static_cast<std::uint8_t>(groupCount);
+        int colorCount = 0;
+        for(unsigned m = colorMask; m; m &= m - 1) colorCount++;
+        out.colors[step] = static_cast<std::uint8_t>(colorCount);
+        out.groupBonus[step] = static_cast<std::uint8_t>(groupBonus);
+        out.score += BoardCore::stepScore(out.step(step), out.level);
+        BoardCore::applyLevelUp(out.score, out.level);
+
+        for(int i = 0; i < poppedCount; i++) g[popped[i].y][popped[i].x] = EMPTY;
+
+        // 중력: BoardCore::applyGravity처럼 모든 열을 정리하고, 움직인 셀만 다음 단계 검사 대상
+        dirtyCount = 0;
+        for(int x = 0; x < COLS; x++) {
+            int write = ROWS - 1;
+            for(int y = ROWS - 1; y >= 0; y--) {
+                if(g[y][x] == EMPTY) continue;
+                if(y != write) {
+                    g[write][x] = g[y][x];
+                    g[y][x] = EMPTY;
+                    dirty[dirtyCount++] = {x, write};
+                    out.columnMask |= static_cast<std::uint8_t>(1u << x);
+                }
+                write--;
+            }
+        }
+    }
+    return out;
+}
+
+// 열 x에서 가장 위의 빈 칸 (가득 찼으면 -1)
+inline int landingRow(const Grid& g, int x) {
+    int y = 0;
+    while(y < ROWS && g[y][x] == EMPTY) y++;
+    return y - 1;
+}
+
+// 빈 칸 위에 뿌요가 떠 있는 열 (중력이 한 번이라도 돌면 움직이는 열)
+inline std::uint8_t floatingColumns(const Grid& g) {
+    std::uint8_t mask = 0;
+    for(int x = 0; x < COLS; x++) {
+        bool seenPuyo = false;
+        for(int y = 0; y < ROWS; y++) {
+            if(g[y][x] != EMPTY) seenPuyo = true;
+            else if(seenPuyo) { mask |= static_cast<std::uint8_t>(1u << x); break; }
+        }
+    }
+    return mask;
+}
+
+struct Trigger {
+    int column = 0;
+    Color color = RED;
+    int extra = 1;            // 열 위에 쌓는 개수
+    bool placeable = false;   // 1행 아래에 모두 들어가는지
+    ChainOutcome outcome;
+    int scoreGained = 0;      // 현재 보드 점수/레벨 기준
+};
+
+// 열 x에 색 c를 extra개 쌓았을 때의 연쇄
+inline Trigger evaluateTrigger(const Grid& g, int x, Color c, int extra, int score, int level) {
+    Trigger t;
+    t.column = x;
+    t.color = c;
+    t.extra = extra;
+    t.outcome.score = score;
+    t.outcome.level = level;
+    t.outcome.columnMask = neighborColumns(x);
+
+    int top = landingRow(g, x);
+    if(top - (extra - 1) < 1) return t;
+    t.placeable = true;
+
+    // 쌓을 칸과 이웃한 같은 색이 없으면 4개를 채울 수 없음 (extra < 4)
+    bool touches = false;
+    for(int i = 0; i < extra && !touches; i++) {
+        int y = top - i;
+        if(x > 0 && g[y][x-1] == c) touches = true;
+        if(x < COLS-1 && g[y][x+1] == c) touches = true;
+    }
+    if(top + 1 < ROWS && g[top+1][x] == c) touches = true;
+    if(!touches && extra < 4) return t;
+
+    Grid trial = g;
+    Vec2 seeds[MAX_EXTRA];
+    for(int i = 0; i < extra; i++) {
+        trial[top - i][x] = c;
+        seeds[i] = {x, top - i};
+    }
+    t.outcome = resolve(trial, seeds, extra, score, level);
+    t.outcome.columnMask |= neighborColumns(x);
+    t.scoreGained = t.outcome.score - score;
+    return t;
+}
+
+// 증분이 필요 없는 곳(AI 후보 보드 평가 등)에서 쓰는 한 번 계산
+inline int maxTriggerChain(const Grid& g, int extra) {
+    int best = 0;
+    for(int x = 0; x < COLS; x++)
+        for(int c = 1; c < COLOR_COUNT; c++)
+            best = std::max(best, evaluateTrigger(g, x, static_cast<Color>(c), extra, 0, 1).outcome.chain);
+    return best;
+}
+
+class ChainAnalyzer {
+private:
+    Trigger table[COLS][NUM_COLORS][MAX_EXTRA];
+    Grid snapshot{};
+    std::uint8_t snapshotFloating = 0;
+    bool valid = false;
+    int bestIndex = -1;
+
+public:
+    // 마지막 update 통계 (HUD/디버그용)
+    int lastRecomputed = 0;
+    float lastMicros = 0.0f;
+
+    void reset() {
+        valid = false;
+        bestIndex = -1;
+    }
+
+    // 잠금/연쇄가 끝난 안정 상태의 보드로 호출
+    void update(const BoardCore& b) {
+        auto start = std::chrono::steady_clock::now();
+
+        std::uint8_t changed = 0;
+        for(int y = 0; y < ROWS; y++)
+            for(int x = 0; x < COLS; x++)
+                if(!valid || snapshot[y][x] != b.g[y][x]) changed |= static_cast<std::uint8_t>(1u << x);
+
+        // 바뀐 열이 떠 있는 뿌요를 갖거나 가졌다면, 연쇄가 한 번이라도 일어난 트리거는 그 열의 중력 결과에 의존
+        std::uint8_t floating = floatingColumns(b.g);
+        bool gravityChanged = (changed & (floating | snapshotFloating)) != 0;
+
+        lastRecomputed = 0;
+        bestIndex = -1;
+        int bestChain = -1, bestScore = -1;
+        for(int x = 0; x < COLS; x++) {
+            for(int c = 0; c < NUM_COLORS; c++) {
+                for(int k = 0; k < MAX_EXTRA; k++) {
+                    Trigger& t = table[x][c][k];
+                    bool stale = !valid || (t.outcome.columnMask & changed) != 0 ||
+                                 (t.outcome.chain > 0 && gravityChanged);
+                    if(stale) {
+                        t = evaluateTrigger(b.g, x, static_cast<Color>(c + 1), k + 1, b.score, b.level);
+                        lastRecomputed++;
+                    } else {
+                        t.scoreGained = replayScore(t.outcome, b.score, b.level) - b.score;
+                    }
+
+                    if(t.placeable && t.outcome.chain > 0 &&
+                       (t.outcome.chain > bestChain || (t.outcome.chain == bestChain && t.scoreGained > bestScore))) {
+                        bestChain = t.outcome.chain;
+                        bestScore = t.scoreGained;
+                        bestIndex = (x * NUM_COLORS + c) * MAX_EXTRA + k;
+                    }
+                }
+            }
+        }
+
+        snapshot = b.g;
+        snapshotFloating = floating;
+        valid = true;
+        lastMicros = std::chrono::duration<float, std::micro>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    bool hasBest() const { return valid && bestIndex >= 0; }
+
+    // 가장 긴 연쇄 (같으면 점수가 큰 쪽, 그다음 적게 쌓는 쪽)
+    const Trigger& best() const {
+        int i = bestIndex < 0 ? 0 : bestIndex;
+        return table[i / (NUM_COLORS * MAX_EXTRA)][(i / MAX_EXTRA) % NUM_COLORS][i % MAX_EXTRA];
+    }
+
+    const Trigger& at(int column, Color color, int extra) const {
+        return table[column][color - 1][extra - 1];
+    }
+};
+
+} // namespace chain
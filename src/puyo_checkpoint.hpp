@@ -0,0 +1,240 @@
+#pragma once
+// ---- 진행 중인 게임 체크포인트 (정전/비정상 종료 후 이어하기) ----
+// 파일 = 헤더 64바이트 + 슬롯 2개. 쓰기는 항상 오래된 슬롯에: 번호를 0으로 지우고, 상태를 쓰고,
+// 체크섬을 쓰고, 마지막에 새 번호를 씀. 쓰다가 죽으면 그 슬롯은 체크섬이 맞지 않아 버려지고
+// 다른 슬롯(직전 상태)이 남음. 읽을 때는 체크섬이 맞는 슬롯 중 번호가 큰 쪽.
+// 매핑된 메모리에 복사만 하므로 프레임을 막지 않음. 디스크로 내보내기는 flusher 스레드가 주기적으로
+//
+// 잠금 기록(리플레이)은 게임 중에 늘기만 하므로 슬롯에 이미 있는 부분은 다시 쓰지 않고,
+// 체크섬도 이어서 계산한 해시를 씀 (쓰기 비용이 게임 길이와 무관)
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "mapped_file.hpp"
+#include "puyo_core.hpp"
+
+namespace checkpoint {
+
+static const char MAGIC[8] = {'P', 'U', 'Y', 'O', 'C', 'K', 'P', '1'};
+static const std::uint32_t VERSION = 1;
+static const std::uint32_t MAX_LOCKS = 16384;   // 넘으면 리플레이는 불완전 (이어한 게임은 순위에 넣지 않음)
+
+// 논리 상태 (이펙트/렌더링 제외). 빈 틈 없는 고정 배치 - 슬롯에 그대로 씀
+struct GameSnapshot {
+    std::uint64_t gameId;          // 게임마다 다름 (같은 게임이면 잠금 기록을 이어서 씀)
+    std::uint64_t rngDraws;        // PuyoRng 시드 + 사용 횟수로 다음 조각들까지 복원
+    std::int64_t score;
+    std::uint32_t rngSeed;
+    std::int32_t level;
+    std::int32_t combo;
+    std::int32_t linesCleared;
+    std::int32_t maxChain;
+    float playTime;
+    float fallTimer;
+    std::uint32_t lockCount;
+    std::uint8_t grid[ROWS][COLS];
+    std::int8_t curX, curY;
+    std::uint8_t curOrientation, curC1, curC2, nextC1, nextC2;
+    std::uint8_t byCpu;
+    std::uint8_t replayComplete;
+    std::uint8_t reserved[3];
+};
+static_assert(sizeof(GameSnapshot) == 144, "checkpoint layout must not have padding");
+
+struct Header {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t slotSize;
+    std::uint8_t reserved[48];
+};
+static_assert(sizeof(Header) == 64, "checkpoint header is 64 bytes");
+
+struct Slot {
+    std::uint64_t sequence;        // 0: 비었거나 쓰는 중
+    std::uint64_t checksum;
+    GameSnapshot state;
+    std::uint16_t locks[MAX_LOCKS];
+};
+
+static const size_t FILE_SIZE = sizeof(Header) + 2 * sizeof(Slot);
+
+static const std::uint64_t LOCK_HASH_SEED = 0x243F6A8885A308D3ull;
+
+inline std::uint64_t hashLock(std::uint64_t h, std::uint16_t lock) {
+    return (h ^ lock) * 0x100000001B3ull;
+}
+
+// 8바이트씩 섞는 체크섬 (슬롯 고정부 144바이트 + 잠금 해시)
+inline std::uint64_t checksumOf(std::uint64_t sequence, const GameSnapshot& s, std::uint64_t lockHash) {
+    std::uint64_t h = 0x9E3779B97F4A7C15ull ^ sequence;
+    const std::uint8_t* p = reinterpret_cast<const std::uint8_t*>(&s);
+    for(size_t i = 0; i < sizeof(GameSnapshot); i += 8) {
+        std::uint64_t w;
+        std::memcpy(&w, p + i, 8);
+        h = (h ^ w) * 0xFF51AFD7ED558CCDull;
+        h ^= h >> 32;
+    }
+    return h ^ (lockHash * 0xC4CEB9FE1A85EC53ull);
+}
+
+class CheckpointFile {
+private:
+    MappedFile file;
+    std::uint64_t sequence = 0;
+    int newest = -1;               // 마지막으로 유효하게 쓴 슬롯 (쓰기 경로에서 다시 검증하지 않도록 기억)
+    // 슬롯에 온전히 들어 있는 잠금 기록 (game이 0이면 없음)
+    std::uint64_t slotGame[2] = {0, 0};
+    std::uint32_t slotLocks[2] = {0, 0};
+
+    // 이번 게임 잠금 기록의 이어서 계산한 해시
+    std::uint64_t hashGame = 0;
+    std::uint32_t hashedLocks = 0;
+    std::uint64_t lockHash = LOCK_HASH_SEED;
+
+    std::thread flusher;
+    std::mutex flushMutex;
+    std::condition_variable flushWake;
+    bool stopping = false;
+
+    Slot* slot(int i) { return reinterpret_cast<Slot*>(file.data() + sizeof(Header)) + i; }
+    const Slot* slot(int i) const { return reinterpret_cast<const Slot*>(file.data() + sizeof(Header)) + i; }
+
+    static bool valid(const Slot& s) {
+        if(s.sequence == 0 || s.state.lockCount > MAX_LOCKS) return false;
+        std::uint64_t h = LOCK_HASH_SEED;
+        for(std::uint32_t i = 0; i < s.state.lockCount; i++) h = hashLock(h, s.locks[i]);
+        return checksumOf(s.sequence, s.state, h) == s.checksum;
+    }
+
+    const Slot* latest() const {
+        const Slot* best = nullptr;
+        for(int i = 0; i < 2; i++) {
+            const Slot* s = slot(i);
+            if(valid(*s) && (!best || s->sequence > best->sequence)) best = s;
+        }
+        return best;
+    }
+
+public:
+    CheckpointFile() = default;
+    CheckpointFile(const CheckpointFile&) = delete;
+    CheckpointFile& operator=(const CheckpointFile&) = delete;
+    ~CheckpointFile() { close(); }
+
+    // 없으면 만들고, 헤더가 다르면 (다른 버전) 비운 채로 다시 씀
+    bool open(const std::string& path) {
+        close();
+        if(!file.open(path, MappedFile::READ_WRITE, FILE_SIZE)) return false;
+        Header* header = reinterpret_cast<Header*>(file.data());
+        if(std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0 || header->version != VERSION ||
+           header->slotSize != sizeof(Slot)) {
+            std::memset(file.data(), 0, file.size());
+            std::memcpy(header->magic, MAGIC, sizeof(MAGIC));
+            header->version = VERSION;
+            header->slotSize = sizeof(Slot);
+            file.flush(false);
+        }
+        for(int i = 0; i < 2; i++) {
+            const Slot* s = slot(i);
+            bool ok = valid(*s);
+            slotGame[i] = ok ? s->state.gameId : 0;
+            slotLocks[i] = ok ? s->state.lockCount : 0;
+            if(ok && s->sequence > sequence) {
+                sequence = s->sequence;
+                newest = i;
+            }
+        }
+        return true;
+    }
+
+    // 디스크로 내보내는 스레드 (쓰기 경로는 매핑된 메모리에 복사만 함)
+    void startFlusher(float seconds) {
+        if(!file.isOpen() || flusher.joinable()) return;
+        stopping = false;
+        flusher = std::thread([this, seconds] {
+            std::unique_lock<std::mutex> lock(flushMutex);
+            while(!flushWake.wait_for(lock, std::chrono::duration<float>(seconds), [&] { return stopping; })) {
+                lock.unlock();
+                file.flush(false);
+                lock.lock();
+            }
+        });
+    }
+
+    void close() {
+        if(flusher.joinable()) {
+            {
+                std::lock_guard<std::mutex> lock(flushMutex);
+                stopping = true;
+            }
+            flushWake.notify_all();
+            flusher.join();
+        }
+        if(file.isOpen()) file.flush(false);
+        file.close();
+    }
+
+    bool isOpen() const { return file.isOpen(); }
+
+    // 이어할 수 있는 최근 상태 (없으면 false)
+    bool load(GameSnapshot& state, std::vector<std::uint16_t>& locks) const {
+        if(!file.isOpen()) return false;
+        const Slot* s = latest();
+        if(!s) return false;
+        state = s->state;
+        locks.assign(s->locks, s->locks + s->state.lockCount);
+        return true;
+    }
+
+    // 오래된 슬롯에 씀. state.lockCount/replayComplete는 locks로 채움
+    void save(GameSnapshot state, const std::vector<std::uint16_t>& locks) {
+        if(!file.isOpen()) return;
+        int target = newest == 0 ? 1 : 0;
+        Slot& t = *slot(target);
+
+        std::uint32_t count = static_cast<std::uint32_t>(std::min<size_t>(locks.size(), MAX_LOCKS));
+        state.lockCount = count;
+        state.replayComplete = locks.size() <= MAX_LOCKS ? 1 : 0;
+
+        // 같은 게임의 앞부분이 이미 이 슬롯에 있으면 새 잠금만 복사
+        std::uint32_t keep = slotGame[target] == state.gameId ? std::min(slotLocks[target], count) : 0;
+        if(hashGame != state.gameId || hashedLocks > count) {
+            hashGame = state.gameId;
+            hashedLocks = 0;
+            lockHash = LOCK_HASH_SEED;
+        }
+        for(; hashedLocks < count; hashedLocks++) lockHash = hashLock(lockHash, locks[hashedLocks]);
+
+        t.sequence = 0;
+        slotGame[target] = 0;
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+        if(count > keep) std::memcpy(t.locks + keep, locks.data() + keep, (count - keep) * sizeof(std::uint16_t));
+        t.state = state;
+        std::uint64_t next = ++sequence;
+        t.checksum = checksumOf(next, state, lockHash);
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+        t.sequence = next;
+        slotGame[target] = state.gameId;
+        slotLocks[target] = count;
+        newest = target;
+    }
+
+    // 게임이 끝나면 이어할 것이 없음
+    void clear() {
+        if(!file.isOpen()) return;
+        slot(0)->sequence = 0;
+        slot(1)->sequence = 0;
+        slotGame[0] = slotGame[1] = 0;
+        newest = -1;
+        hashGame = 0;
+    }
+};
+
+} // namespace checkpoint
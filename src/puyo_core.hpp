@@ -0,0 +1,427 @@
+#pragma once
+// ---- 게임 규칙 코어 (SFML 없이 사용 가능: 게임, 헤드리스 도구, 파이썬 바인딩 공용) ----
+#include <array>
+#include <vector>
+#include <queue>
+#include <random>
+#include <algorithm>
+#include <cstdint>
+
+static const int COLS = 6;
+static const int ROWS = 12;
+
+// 셀 상태 (1바이트 - 보드 메모리를 그대로 외부에 노출할 수 있도록)
+enum Color : std::uint8_t { EMPTY=0, RED, GREEN, BLUE, YELLOW, PURPLE, COLOR_COUNT };
+
+// 2차원 좌표
+struct Vec2 { int x, y; };
+
+// 뿌요쌍 구조체
+struct PuyoPair {
+    Vec2 pivot;
+    Vec2 sub;
+    Color c1, c2;
+};
+
+inline bool inBounds(int x, int y) { return x >= 0 && x < COLS && y >= 0 && y < ROWS; }
+
+// 시드와 사용 횟수를 함께 기록하는 난수 생성기 (리플레이/체크포인트 복원용)
+struct PuyoRng {
+    using result_type = std::mt19937::result_type;
+
+    std::mt19937 engine;
+    std::uint32_t seed = 0;
+    std::uint64_t draws = 0;
+
+    explicit PuyoRng(std::uint32_t s = 5489u) { reseed(s); }
+
+    void reseed(std::uint32_t s) {
+        seed = s;
+        engine.seed(s);
+        draws = 0;
+    }
+
+    // 같은 시드에서 같은 횟수만큼 진행시켜 상태 복원
+    void restore(std::uint32_t s, std::uint64_t drawCount) {
+        reseed(s);
+        engine.discard(drawCount);
+        draws = drawCount;
+    }
+
+    static constexpr result_type min() { return std::mt19937::min(); }
+    static constexpr result_type max() { return std::mt19937::max(); }
+
+    result_type operator()() {
+        ++draws;
+        return engine();
+    }
+};
+
+template<class Rng>
+Color randomColor(Rng& gen) {
+    std::uniform_int_distribution<int> dist(1, COLOR_COUNT-1);
+    return static_cast<Color>(dist(gen));
+}
+
+template<class Rng>
+PuyoPair makeSpawnPair(Rng& gen) {
+    PuyoPair p;
+    p.pivot = { COLS/2, 0 };
+    p.sub = { 0, -1 };
+    p.c1 = randomColor(gen);
+    p.c2 = randomColor(gen);
+    return p;
+}
+
+// 연쇄 한 단계의 요약 (규칙의 점수 계산 입력)
+struct ChainStep {
+    int removed = 0;       // 제거된 뿌요 수
+    int chainIndex = 1;    // 몇 번째 연쇄인지 (1부터)
+    int groupCount = 0;    // 제거된 그룹 수
+    int colorCount = 0;    // 제거된 색 가짓수
+    int groupBonus = 0;    // 그룹 크기 보너스 합 (Rules::groupBonus)
+};
+
+// ---- 규칙 정책 (컴파일 타임 표) ----
+// BasicBoard<Rules>가 규칙마다 따로 인스턴스화되므로 점수/속도 계산에 실행 중 분기가 없음.
+// 규칙 타입이 갖춰야 할 것: Score, NAME, stepScore, groupBonus, levelFor, levelUpBonus, fallSpeed
+namespace rules {
+
+static constexpr int MAX_LEVEL = 25;
+static constexpr int MAX_CHAIN = ROWS * COLS / 4;   // 한 보드에서 나올 수 있는 최대 연쇄
+
+// 레벨별 낙하 간격 (초)
+static constexpr float FALL_SPEEDS[MAX_LEVEL] = {
+    1.2f, 1.0f, 0.85f, 0.7f, 0.6f, 0.5f, 0.42f, 0.36f, 0.3f, 0.25f,
+    0.22f, 0.19f, 0.16f, 0.14f, 0.12f, 0.1f, 0.085f, 0.07f, 0.06f, 0.05f,
+    0.04f, 0.035f, 0.03f, 0.025f, 0.02f
+};
+
+constexpr float fallSpeedForLevel(int level) {
+    return FALL_SPEEDS[level < 1 ? 0 : level > MAX_LEVEL ? MAX_LEVEL - 1 : level - 1];
+}
+
+constexpr int clampChain(int chainIndex) {
+    return chainIndex < 0 ? 0 : chainIndex > MAX_CHAIN ? MAX_CHAIN : chainIndex;
+}
+
+// 기존 규칙의 연쇄 보너스 2^(n-1) * 120 (시프트 대신 64비트 표: 긴 연쇄에서도 넘치지 않음)
+constexpr std::array<std::int64_t, MAX_CHAIN + 1> makeEnhancedChainBonus() {
+    std::array<std::int64_t, MAX_CHAIN + 1> t{};
+    for(int i = 2; i <= MAX_CHAIN; i++) t[i] = (std::int64_t(1) << (i - 1)) * 120;
+    return t;
+}
+
+// 기존 게임 규칙: 제거 수^2 * 20 + 연쇄/색/대량/레벨 보너스, 1200점마다 레벨 업 (+레벨 * 150)
+template<class ScoreT>
+struct BasicEnhancedRules {
+    using Score = ScoreT;
+    static constexpr const char* NAME = "enhanced";
+    static constexpr int LEVEL_SCORE = 1200;
+    static constexpr int LEVEL_UP_BONUS = 150;
+    static constexpr std::array<std::int64_t, MAX_CHAIN + 1> CHAIN_BONUS = makeEnhancedChainBonus();
+
+    static constexpr int groupBonus(int) { return 0; }
+
+    static constexpr Score stepScore(const ChainStep& s, int level) {
+        Score base = static_cast<Score>(s.removed) * s.removed * 20;
+        Score chainBonus = static_cast<Score>(CHAIN_BONUS[clampChain(s.chainIndex)]);
+        Score colorBonus = s.groupCount > 1 ? static_cast<Score>(s.groupCount) * s.groupCount * 100 : 0;
+        Score massBonus = s.removed >= 10 ? static_cast<Score>(s.removed - 9) * 80 : 0;
+        return base + chainBonus + colorBonus + massBonus + static_cast<Score>(level) * 10;
+    }
+
+    static constexpr int levelFor(Score score) {
+        return static_cast<int>(std::min<Score>(MAX_LEVEL, score / LEVEL_SCORE + 1));
+    }
+    static constexpr Score levelUpBonus(int level) { return static_cast<Score>(level) * LEVEL_UP_BONUS; }
+    static constexpr float fallSpeed(int level) { return fallSpeedForLevel(level); }
+};
+
+using EnhancedRules = BasicEnhancedRules<int>;
+using Enhanced64Rules = BasicEnhancedRules<std::int64_t>;   // 같은 규칙, 64비트 점수 (장시간 플레이)
+
+// 뿌요뿌요 통 방식: 10 * 제거 수 * (연쇄 파워 + 색 보너스 + 그룹 보너스), 배율은 1~999
+// 레벨 보너스 점수는 없고, 속도만 5000점마다 올라감
+struct TsuRules {
+    using Score = std::int64_t;
+    static constexpr const char* NAME = "tsu";
+    static constexpr int LEVEL_SCORE = 5000;
+    static constexpr std::array<int, 20> CHAIN_POWER = {{
+        0, 0, 8, 16, 32, 64, 96, 128, 160, 192, 224, 256, 288, 320, 352, 384, 416, 448, 480, 512 }};
+    static constexpr std::array<int, 6> COLOR_BONUS = {{ 0, 0, 3, 6, 12, 24 }};
+    static constexpr std::array<int, 12> GROUP_BONUS = {{ 0, 0, 0, 0, 0, 2, 3, 4, 5, 6, 7, 10 }};
+
+    static constexpr int groupBonus(int size) { return GROUP_BONUS[size < 11 ? size : 11]; }
+
+    static constexpr Score stepScore(const ChainStep& s, int) {
+        int power = CHAIN_POWER[s.chainIndex < 19 ? s.chainIndex : 19] +
+                    COLOR_BONUS[s.colorCount < 5 ? s.colorCount : 5] + s.groupBonus;
+        power = power < 1 ? 1 : power > 999 ? 999 : power;
+        return static_cast<Score>(10) * s.removed * power;
+    }
+
+    static constexpr int levelFor(Score score) {
+        return static_cast<int>(std::min<Score>(MAX_LEVEL, score / LEVEL_SCORE + 1));
+    }
+    static constexpr Score levelUpBonus(int) { return 0; }
+    static constexpr float fallSpeed(int level) { return fallSpeedForLevel(level); }
+};
+
+// 표가 손으로 고친 뒤에도 기존 값과 같은지 컴파일 때 확인
+static_assert(EnhancedRules::stepScore(ChainStep{4, 1, 1, 1, 0}, 1) == 330, "enhanced single pop");
+static_assert(EnhancedRules::stepScore(ChainStep{4, 3, 1, 1, 0}, 2) == 320 + 480 + 20, "enhanced 3 chain");
+static_assert(Enhanced64Rules::stepScore(ChainStep{4, MAX_CHAIN, 1, 1, 0}, 1) > (std::int64_t(1) << 23), "64-bit chain");
+static_assert(TsuRules::stepScore(ChainStep{4, 1, 1, 1, 0}, 1) == 40, "tsu single pop");
+static_assert(TsuRules::stepScore(ChainStep{8, 2, 2, 2, 0}, 1) == 10 * 8 * 11, "tsu two colors");
+static_assert(fallSpeedForLevel(25) == 0.02f && fallSpeedForLevel(99) == 0.02f, "speed table");
+
+} // namespace rules
+
+// 보드 규칙 (이펙트/렌더링과 무관한 논리 상태만 보관)
+template<class RuleSet>
+struct BasicBoard {
+    using Rules = RuleSet;
+    using Score = typename Rules::Score;
+    static const int MAX_CELLS = ROWS * COLS;
+
+    std::array<std::array<Color, COLS>, ROWS> g{};
+    Score score = 0;
+    int chain = 0;
+    int level = 1;
+    int totalLinesCleared = 0;
+    int combo = 0;
+
+    // 마지막 popGroupsAndScore 결과 (이펙트 생성용)
+    std::array<Vec2, MAX_CELLS> poppedCells{};
+    std::array<Color, MAX_CELLS> poppedColors{};
+    int poppedCount = 0;
+    Score lastPoints = 0;
+    bool leveledUp = false;
+
+    BasicBoard() { clear(); }
+
+    void clear() {
+        for(int y = 0; y < ROWS; ++y)
+            for(int x = 0; x < COLS; ++x)
+                g[y][x] = EMPTY;
+        score = 0; chain = 0; level = 1; totalLinesCleared = 0; combo = 0;
+        poppedCount = 0; lastPoints = 0; leveledUp = false;
+    }
+
+    bool isEmpty(int x, int y) const {
+        return inBounds(x, y) && g[y][x] == EMPTY;
+    }
+
+    bool collision(const PuyoPair& p) const {
+        if(!inBounds(p.pivot.x, p.pivot.y) || g[p.pivot.y][p.pivot.x] != EMPTY) return true;
+        int sx = p.pivot.x + p.sub.x;
+        int sy = p.pivot.y + p.sub.y;
+        if(!inBounds(sx, sy) || g[sy][sx] != EMPTY) return true;
+        return false;
+    }
+
+    void lock(const PuyoPair& p) {
+        if(inBounds(p.pivot.x, p.pivot.y)) {
+            g[p.pivot.y][p.pivot.x] = p.c1;
+        }
+        int sx = p.pivot.x + p.sub.x;
+        int sy = p.pivot.y + p.sub.y;
+        if(inBounds(sx, sy)) {
+            g[sy][sx] = p.c2;
+        }
+    }
+
+    void applyGravity() {
+        for(int x = 0; x < COLS; ++x) {
+            int write = ROWS - 1;
+            for(int y = ROWS - 1; y >= 0; --y) {
+                if(g[y][x] != EMPTY) {
+                    Color c = g[y][x];
+                    g[y][x] = EMPTY;
+                    g[write][x] = c;
+                    write--;
+                }
+            }
+        }
+    }
+
+    // 한 연쇄 단계의 점수 (연쇄 분석기와 공용)
+    static Score stepScore(const ChainStep& step, int level) {
+        return Rules::stepScore(step, level);
+    }
+
+    // 점수에 따른 레벨 상승과 보너스 (올랐으면 true)
+    static bool applyLevelUp(Score& score, int& level) {
+        int newLevel = Rules::levelFor(score);
+        if(newLevel > level) {
+            level = newLevel;
+            score += Rules::levelUpBonus(level);
+            return true;
+        }
+        return false;
+    }
+
+    // 그룹 크기를 모를 때의 근사 (이펙트 미리보기용: 그룹마다 다른 색, 크기 보너스 없음)
+    Score calculateScore(int removed, int chainIndex, int groupCount) const {
+        return stepScore(ChainStep{removed, chainIndex, groupCount, groupCount, 0}, level);
+    }
+
+    // 4개 이상 연결된 그룹을 제거하고 점수 반영 (제거된 셀은 poppedCells에 기록)
+    int popGroupsAndScore(int chainIndex) {
+        std::vector<std::vector<bool>> vis(ROWS, std::vector<bool>(COLS, false));
+        int removedTotal = 0;
+        int groupCount = 0;
+        int groupBonus = 0;
+        unsigned colorMask = 0;
+        poppedCount = 0;
+        lastPoints = 0;
+        leveledUp = false;
+
+        for(int y = 0; y < ROWS; ++y) {
+            for(int x = 0; x < COLS; ++x) {
+                if(g[y][x] == EMPTY || vis[y][x]) continue;
+                Color c = g[y][x];
+
+                std::vector<Vec2> group;
+                std::queue<Vec2> q;
+                q.push({x, y});
+                vis[y][x] = true;
+
+                while(!q.empty()) {
+                    auto [cx, cy] = q.front(); q.pop();
+                    group.push_back({cx, cy});
+                    const int dx[4] = {1, -1, 0, 0};
+                    const int dy[4] = {0, 0, 1, -1};
+                    for(int i = 0; i < 4; ++i) {
+                        int nx = cx + dx[i], ny = cy + dy[i];
+                        if(inBounds(nx, ny) && !vis[ny][nx] && g[ny][nx] == c) {
+                            vis[ny][nx] = true;
+                            q.push({nx, ny});
+                        }
+                    }
+                }
+
+                if(static_cast<int>(group.size()) >= 4) {
+                    for(auto &v : group) {
+                        g[v.y][v.x] = EMPTY;
+                        poppedCells[poppedCount] = v;
+                        poppedColors[poppedCount] = c;
+                        poppedCount++;
+                    }
+                    removedTotal += static_cast<int>(group.size());
+                    groupCount++;
+                    groupBonus += Rules::groupBonus(static_cast<int>(group.size()));
+                    colorMask |= 1u << c;
+                }
+            }
+        }
+
+        if(removedTotal > 0) {
+            int colorCount = 0;
+            for(unsigned m = colorMask; m; m &= m - 1) colorCount++;
+            lastPoints = stepScore(ChainStep{removedTotal, chainIndex, groupCount, colorCount, groupBonus}, level);
+            score += lastPoints;
+            combo++;
+            totalLinesCleared += groupCount;
+
+            leveledUp = applyLevelUp(score, level);
+        } else {
+            combo = 0;
+        }
+
+        return removedTotal;
+    }
+
+    // 잠금 이후 연쇄를 끝까지 처리 (반환값: 연쇄 수)
+    int resolveChains() {
+        int chainIndex = 1;
+        while(true) {
+            int removed = popGroupsAndScore(chainIndex);
+            if(removed <= 0) break;
+            applyGravity();
+            chainIndex++;
+        }
+        return chainIndex - 1;
+    }
+
+    float getFallSpeed() const { return Rules::fallSpeed(level); }
+
+    bool isGameOver() const {
+        for(int x = 0; x < COLS; ++x) {
+            if(g[1][x] != EMPTY) return true;
+        }
+        return false;
+    }
+};
+
+// 게임, 도구, 파이썬 바인딩이 쓰는 기본 규칙
+using BoardCore = BasicBoard<rules::EnhancedRules>;
+using Board64 = BasicBoard<rules::Enhanced64Rules>;
+using TsuBoard = BasicBoard<rules::TsuRules>;
+
+// 회전 함수들
+inline Vec2 rotateCW(const Vec2& v) { return Vec2{ -v.y, v.x }; }
+inline Vec2 rotateCCW(const Vec2& v) { return Vec2{ v.y, -v.x }; }
+
+template<class R>
+inline bool wallKick(const BasicBoard<R>& b, PuyoPair& p) {
+    if(!b.collision(p)) return true;
+
+    static const Vec2 kickTests[] = {{-1, 0}, {1, 0}, {-2, 0}, {2, 0}, {0, -1}};
+
+    for(const auto& kick : kickTests) {
+        PuyoPair test = p;
+        test.pivot.x += kick.x;
+        test.pivot.y += kick.y;
+        if(!b.collision(test)) {
+            p = test;
+            return true;
+        }
+    }
+    return false;
+}
+
+// 회전 + 벽 차기. 차기까지 실패하면 p는 그대로 (게임, 서버, 이동 생성기 공용 규칙)
+template<class R>
+inline bool tryRotate(const BasicBoard<R>& b, PuyoPair& p, bool clockwise) {
+    PuyoPair t = p;
+    t.sub = clockwise ? rotateCW(t.sub) : rotateCCW(t.sub);
+    if(!wallKick(b, t)) return false;
+    p = t;
+    return true;
+}
+
+template<class R>
+inline bool canMove(const BasicBoard<R>& b, const PuyoPair& p, int dx, int dy) {
+    PuyoPair t = p;
+    t.pivot.x += dx; t.pivot.y += dy;
+    return !b.collision(t);
+}
+
+// ---- 배치(placement) 단위 조작: 헤드리스 도구/봇 공용 ----
+static const int NUM_ORIENTATIONS = 4;
+static const int NUM_PLACEMENTS = NUM_ORIENTATIONS * COLS;
+
+// 방향 0: 위, 1: 오른쪽, 2: 아래, 3: 왼쪽 (pivot 기준 sub 위치)
+inline Vec2 orientationOffset(int orientation) {
+    static const Vec2 offsets[NUM_ORIENTATIONS] = {{0, -1}, {1, 0}, {0, 1}, {-1, 0}};
+    return offsets[orientation & 3];
+}
+
+// 스폰 위치에서 입력(한 칸 낙하 -> 회전 -> 좌우 이동 -> 하드 드롭)을 흉내 내어
+// 목표 방향/열에 최대한 가깝게 놓고 잠금. 최종 위치를 반환
+template<class R>
+inline PuyoPair dropPlacement(BasicBoard<R>& b, PuyoPair p, int orientation, int column) {
+    if(canMove(b, p, 0, +1)) p.pivot.y += 1;
+
+    int rotations = orientation & 3;
+    for(int i = 0; i < rotations; i++) tryRotate(b, p, true);
+
+    while(p.pivot.x < column && canMove(b, p, +1, 0)) p.pivot.x++;
+    while(p.pivot.x > column && canMove(b, p, -1, 0)) p.pivot.x--;
+    while(canMove(b, p, 0, +1)) p.pivot.y++;
+
+    b.lock(p);
+    return p;
+}
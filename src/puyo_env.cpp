@@ -0,0 +1,510 @@
+// ---- 파이썬 확장 모듈: 배치 벡터 환경 (puyo_env) ----
+// 빌드: README의 "Python バインディング" 항목 참고
+//
+//   import numpy as np, puyo_env
+//   env = puyo_env.VecEnv(1024, seed=1, threads=8)
+//   boards = np.asarray(env.boards)        # (N, ROWS, COLS) uint8, 엔진 메모리를 그대로 참조
+//   env.reset()
+//   env.step(np.random.randint(0, puyo_env.NUM_PLACEMENTS, 1024, dtype=np.int32))
+//   rewards = np.asarray(env.rewards)      # (N,) float32
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "puyo_core.hpp"
+
+namespace {
+
+// 환경 하나의 상태. 보드 메모리는 env.boards 버퍼로 그대로 노출됨
+struct EnvSlot {
+    BoardCore board;
+    PuyoPair cur;
+    PuyoPair next;
+    PuyoRng rng;
+    std::uint64_t episode = 0;   // 이 환경에서 시작한 에피소드 수 (시드 키)
+    bool done = false;
+};
+
+// 고정 워커 스레드 풀 (step마다 스레드를 만들지 않음)
+class WorkerPool {
+private:
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable finished;
+    std::function<void(size_t)> task;
+    size_t taskCount = 0;
+    std::atomic<size_t> nextIndex{0};
+    size_t running = 0;
+    size_t generation = 0;
+    bool stopping = false;
+    std::mutex dispatch;       // run은 재진입 불가: 여러 파이썬 스레드가 같은 환경을 부르면 차례로
+
+    void workerLoop() {
+        size_t seenGeneration = 0;
+        while(true) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [&] { return stopping || generation != seenGeneration; });
+                if(stopping) return;
+                seenGeneration = generation;
+            }
+            drain();
+            std::lock_guard<std::mutex> lock(mutex);
+            if(--running == 0) finished.notify_one();
+        }
+    }
+
+    void drain() {
+        for(size_t i = nextIndex.fetch_add(1); i < taskCount; i = nextIndex.fetch_add(1)) {
+            task(i);
+        }
+    }
+
+public:
+    explicit WorkerPool(size_t threadCount) {
+        for(size_t i = 0; i < threadCount; i++) {
+            workers.emplace_back([this] { workerLoop(); });
+        }
+    }
+
+    ~WorkerPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for(auto& worker : workers) worker.join();
+    }
+
+    // 0..count-1 인덱스를 워커와 호출 스레드가 나눠서 처리
+    void run(size_t count, std::function<void(size_t)> fn) {
+        std::lock_guard<std::mutex> serial(dispatch);
+        if(workers.empty() || count < 64) {
+            for(size_t i = 0; i < count; i++) fn(i);
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            task = std::move(fn);
+            taskCount = count;
+            nextIndex = 0;
+            running = workers.size();
+            generation++;
+        }
+        wake.notify_all();
+        drain();
+        std::unique_lock<std::mutex> lock(mutex);
+        finished.wait(lock, [&] { return running == 0; });
+    }
+};
+
+struct VecEnvObject;
+
+// 버퍼 프로토콜 뷰 객체: 소유 환경을 참조로 붙잡아 두고 내부 메모리를 그대로 노출
+struct BufferViewObject {
+    PyObject_HEAD
+    PyObject* owner;
+    void* data;
+    int ndim;
+    Py_ssize_t shape[3];
+    Py_ssize_t strides[3];
+    Py_ssize_t itemsize;
+    const char* format;
+    bool readonly;
+};
+
+struct VecEnvObject {
+    PyObject_HEAD
+    std::vector<EnvSlot>* slots;
+    std::vector<float>* rewards;
+    std::vector<std::uint8_t>* dones;
+    std::vector<std::uint8_t>* pairs;     // (N, 4): cur.c1, cur.c2, next.c1, next.c2
+    std::vector<std::int32_t>* chains;    // 직전 step의 연쇄 수
+    WorkerPool* pool;
+    std::uint32_t baseSeed;
+};
+
+PyTypeObject* BufferViewType = nullptr;
+PyTypeObject* VecEnvType = nullptr;
+
+inline std::uint64_t splitmix64(std::uint64_t x) {
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+// (기준 시드, 환경 번호, 에피소드 번호)마다 다른 시드. 자동 리셋과 reset()이 같은 수열을 쓰므로
+// 환경 사이에도, 한 환경의 에피소드 사이에도 겹치지 않음
+std::uint32_t episodeSeed(std::uint32_t base, size_t index, std::uint64_t episode) {
+    std::uint64_t key = splitmix64(splitmix64(base) ^ static_cast<std::uint64_t>(index));
+    return static_cast<std::uint32_t>(splitmix64(key + episode) >> 32);
+}
+
+// 다음 에피소드 시작
+void resetSlot(EnvSlot& slot, std::uint32_t base, size_t index) {
+    slot.board.clear();
+    slot.rng.reseed(episodeSeed(base, index, slot.episode++));
+    slot.cur = makeSpawnPair(slot.rng);
+    slot.next = makeSpawnPair(slot.rng);
+    slot.done = false;
+}
+
+void writePairs(const EnvSlot& slot, std::uint8_t* out) {
+    out[0] = slot.cur.c1;
+    out[1] = slot.cur.c2;
+    out[2] = slot.next.c1;
+    out[3] = slot.next.c2;
+}
+
+// 배치 하나 진행: 게임 코드와 같은 규칙(dropPlacement -> 연쇄 -> 다음 쌍 -> 게임오버 판정)
+void stepSlot(VecEnvObject* env, size_t i, int action) {
+    EnvSlot& slot = (*env->slots)[i];
+    float& reward = (*env->rewards)[i];
+    std::int32_t& chain = (*env->chains)[i];
+
+    if(slot.done) {
+        resetSlot(slot, env->baseSeed, i);
+        reward = 0.0f;
+        chain = 0;
+    } else {
+        int placement = std::min(std::max(action, 0), NUM_PLACEMENTS - 1);
+        int before = slot.board.score;
+        dropPlacement(slot.board, slot.cur, placement / COLS, placement % COLS);
+        chain = slot.board.resolveChains();
+        slot.cur = slot.next;
+        slot.next = makeSpawnPair(slot.rng);
+        slot.done = slot.board.isGameOver();
+        reward = static_cast<float>(slot.board.score - before);
+    }
+
+    (*env->dones)[i] = slot.done ? 1 : 0;
+    writePairs(slot, &(*env->pairs)[i * 4]);
+}
+
+// ---- BufferView ----
+
+int BufferView_getbuffer(PyObject* self, Py_buffer* view, int flags) {
+    auto* obj = reinterpret_cast<BufferViewObject*>(self);
+    if((flags & PyBUF_WRITABLE) && obj->readonly) {
+        PyErr_SetString(PyExc_BufferError, "buffer is read-only");
+        return -1;
+    }
+    view->obj = self;
+    Py_INCREF(self);
+    view->buf = obj->data;
+    view->itemsize = obj->itemsize;
+    view->len = obj->itemsize;
+    for(int d = 0; d < obj->ndim; d++) view->len *= obj->shape[d];
+    view->readonly = obj->readonly ? 1 : 0;
+    view->ndim = obj->ndim;
+    view->format = (flags & PyBUF_FORMAT) ? const_cast<char*>(obj->format) : nullptr;
+    view->shape = obj->shape;
+    view->strides = obj->strides;
+    view->suboffsets = nullptr;
+    view->internal = nullptr;
+    return 0;
+}
+
+void BufferView_dealloc(PyObject* self) {
+    auto* obj = reinterpret_cast<BufferViewObject*>(self);
+    Py_XDECREF(obj->owner);
+    PyTypeObject* type = Py_TYPE(self);
+    type->tp_free(self);
+    Py_DECREF(type);
+}
+
+PyType_Slot BufferViewSlots[] = {
+    {Py_bf_getbuffer, reinterpret_cast<void*>(BufferView_getbuffer)},
+    {Py_tp_dealloc, reinterpret_cast<void*>(BufferView_dealloc)},
+    {Py_tp_doc, const_cast<char*>("Zero-copy view over environment memory (use numpy.asarray).")},
+    {0, nullptr}
+};
+
+PyType_Spec BufferViewSpec = {
+    "puyo_env.BufferView", sizeof(BufferViewObject), 0, Py_TPFLAGS_DEFAULT, BufferViewSlots
+};
+
+PyObject* makeView(PyObject* owner, void* data, const char* format, Py_ssize_t itemsize,
+                   std::initializer_list<Py_ssize_t> shape, std::initializer_list<Py_ssize_t> strides,
+                   bool readonly) {
+    auto* view = PyObject_New(BufferViewObject, BufferViewType);
+    if(!view) return nullptr;
+    Py_INCREF(owner);
+    view->owner = owner;
+    view->data = data;
+    view->format = format;
+    view->itemsize = itemsize;
+    view->readonly = readonly;
+    view->ndim = static_cast<int>(shape.size());
+    int d = 0;
+    for(Py_ssize_t s : shape) view->shape[d++] = s;
+    d = 0;
+    for(Py_ssize_t s : strides) view->strides[d++] = s;
+    PyObject* mv = PyMemoryView_FromObject(reinterpret_cast<PyObject*>(view));
+    Py_DECREF(view);
+    return mv;
+}
+
+// ---- VecEnv ----
+
+int VecEnv_init(PyObject* self, PyObject* args, PyObject* kwargs) {
+    auto* env = reinterpret_cast<VecEnvObject*>(self);
+    static const char* keywords[] = {"num_envs", "seed", "threads", nullptr};
+    Py_ssize_t numEnvs = 0;
+    unsigned long seed = 0;
+    int threads = 0;
+    if(!PyArg_ParseTupleAndKeywords(args, kwargs, "n|ki", const_cast<char**>(keywords),
+                                    &numEnvs, &seed, &threads)) {
+        return -1;
+    }
+    // 이미 내보낸 버퍼 뷰가 옛 메모리를 가리킬 수 있으므로 다시 초기화하지 않음
+    if(env->slots) {
+        PyErr_SetString(PyExc_RuntimeError, "VecEnv is already initialized");
+        return -1;
+    }
+    if(numEnvs <= 0) {
+        PyErr_SetString(PyExc_ValueError, "num_envs must be positive");
+        return -1;
+    }
+    if(threads <= 0) {
+        threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    }
+
+    size_t n = static_cast<size_t>(numEnvs);
+    env->slots = new std::vector<EnvSlot>(n);
+    env->rewards = new std::vector<float>(n, 0.0f);
+    env->dones = new std::vector<std::uint8_t>(n, 0);
+    env->pairs = new std::vector<std::uint8_t>(n * 4, 0);
+    env->chains = new std::vector<std::int32_t>(n, 0);
+    env->pool = new WorkerPool(static_cast<size_t>(threads - 1));
+    env->baseSeed = static_cast<std::uint32_t>(seed);
+
+    for(size_t i = 0; i < n; i++) {
+        resetSlot((*env->slots)[i], env->baseSeed, i);
+        writePairs((*env->slots)[i], &(*env->pairs)[i * 4]);
+    }
+    return 0;
+}
+
+PyObject* VecEnv_new(PyTypeObject* type, PyObject*, PyObject*) {
+    auto* env = reinterpret_cast<VecEnvObject*>(type->tp_alloc(type, 0));
+    if(env) {
+        env->slots = nullptr;
+        env->rewards = nullptr;
+        env->dones = nullptr;
+        env->pairs = nullptr;
+        env->chains = nullptr;
+        env->pool = nullptr;
+    }
+    return reinterpret_cast<PyObject*>(env);
+}
+
+void VecEnv_dealloc(PyObject* self) {
+    auto* env = reinterpret_cast<VecEnvObject*>(self);
+    delete env->pool;
+    delete env->slots;
+    delete env->rewards;
+    delete env->dones;
+    delete env->pairs;
+    delete env->chains;
+    PyTypeObject* type = Py_TYPE(self);
+    type->tp_free(self);
+    Py_DECREF(type);
+}
+
+bool checkInitialized(VecEnvObject* env) {
+    if(!env->slots) {
+        PyErr_SetString(PyExc_RuntimeError, "VecEnv is not initialized");
+        return false;
+    }
+    return true;
+}
+
+// reset(seed=None): 모든 환경 초기화
+PyObject* VecEnv_reset(PyObject* self, PyObject* args, PyObject* kwargs) {
+    auto* env = reinterpret_cast<VecEnvObject*>(self);
+    if(!checkInitialized(env)) return nullptr;
+    static const char* keywords[] = {"seed", nullptr};
+    PyObject* seedObj = Py_None;
+    if(!PyArg_ParseTupleAndKeywords(args, kwargs, "|O", const_cast<char**>(keywords), &seedObj)) {
+        return nullptr;
+    }
+    // 시드를 주면 에피소드 번호도 처음부터 (같은 시드 = 같은 에피소드 수열)
+    bool reseed = seedObj != Py_None;
+    if(reseed) {
+        env->baseSeed = static_cast<std::uint32_t>(PyLong_AsUnsignedLongMask(seedObj));
+        if(PyErr_Occurred()) return nullptr;
+    }
+
+    size_t n = env->slots->size();
+    Py_BEGIN_ALLOW_THREADS
+    env->pool->run(n, [env, reseed](size_t i) {
+        EnvSlot& slot = (*env->slots)[i];
+        if(reseed) slot.episode = 0;
+        resetSlot(slot, env->baseSeed, i);
+        (*env->rewards)[i] = 0.0f;
+        (*env->dones)[i] = 0;
+        (*env->chains)[i] = 0;
+        writePairs((*env->slots)[i], &(*env->pairs)[i * 4]);
+    });
+    Py_END_ALLOW_THREADS
+    Py_RETURN_NONE;
+}
+
+// step(actions): actions는 길이 N의 정수 버퍼 (int32/int64). 끝난 환경은 다음 step에서 리셋
+PyObject* VecEnv_step(PyObject* self, PyObject* arg) {
+    auto* env = reinterpret_cast<VecEnvObject*>(self);
+    if(!checkInitialized(env)) return nullptr;
+
+    Py_buffer actions;
+    if(PyObject_GetBuffer(arg, &actions, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) < 0) return nullptr;
+
+    size_t n = env->slots->size();
+    bool is32 = actions.itemsize == 4;
+    bool is64 = actions.itemsize == 8;
+    const char* format = actions.format ? actions.format : "B";
+    if(*format == '@' || *format == '=' || *format == '<') format++;
+    bool integral = *format == 'i' || *format == 'l' || *format == 'q';
+    if(!integral || (!is32 && !is64) || static_cast<size_t>(actions.len / actions.itemsize) != n) {
+        PyBuffer_Release(&actions);
+        PyErr_SetString(PyExc_ValueError, "actions must be a contiguous int32/int64 buffer of length num_envs");
+        return nullptr;
+    }
+
+    const void* data = actions.buf;
+    Py_BEGIN_ALLOW_THREADS
+    env->pool->run(n, [env, data, is32](size_t i) {
+        int action = is32 ? static_cast<const std::int32_t*>(data)[i]
+                          : static_cast<int>(static_cast<const std::int64_t*>(data)[i]);
+        stepSlot(env, i, action);
+    });
+    Py_END_ALLOW_THREADS
+
+    PyBuffer_Release(&actions);
+    Py_RETURN_NONE;
+}
+
+PyObject* VecEnv_get_boards(PyObject* self, void*) {
+    auto* env = reinterpret_cast<VecEnvObject*>(self);
+    if(!checkInitialized(env)) return nullptr;
+    EnvSlot* first = env->slots->data();
+    return makeView(self, &first->board.g[0][0], "B", 1,
+                    {static_cast<Py_ssize_t>(env->slots->size()), ROWS, COLS},
+                    {static_cast<Py_ssize_t>(sizeof(EnvSlot)), COLS, 1}, true);
+}
+
+PyObject* VecEnv_get_pairs(PyObject* self, void*) {
+    auto* env = reinterpret_cast<VecEnvObject*>(self);
+    if(!checkInitialized(env)) return nullptr;
+    return makeView(self, env->pairs->data(), "B", 1,
+                    {static_cast<Py_ssize_t>(env->slots->size()), 4}, {4, 1}, true);
+}
+
+PyObject* VecEnv_get_rewards(PyObject* self, void*) {
+    auto* env = reinterpret_cast<VecEnvObject*>(self);
+    if(!checkInitialized(env)) return nullptr;
+    return makeView(self, env->rewards->data(), "f", sizeof(float),
+                    {static_cast<Py_ssize_t>(env->slots->size())}, {sizeof(float)}, true);
+}
+
+PyObject* VecEnv_get_dones(PyObject* self, void*) {
+    auto* env = reinterpret_cast<VecEnvObject*>(self);
+    if(!checkInitialized(env)) return nullptr;
+    return makeView(self, env->dones->data(), "B", 1,
+                    {static_cast<Py_ssize_t>(env->slots->size())}, {1}, true);
+}
+
+PyObject* VecEnv_get_chains(PyObject* self, void*) {
+    auto* env = reinterpret_cast<VecEnvObject*>(self);
+    if(!checkInitialized(env)) return nullptr;
+    return makeView(self, env->chains->data(), "i", sizeof(std::int32_t),
+                    {static_cast<Py_ssize_t>(env->slots->size())}, {sizeof(std::int32_t)}, true);
+}
+
+PyObject* VecEnv_scores(PyObject* self, PyObject*) {
+    auto* env = reinterpret_cast<VecEnvObject*>(self);
+    if(!checkInitialized(env)) return nullptr;
+    PyObject* list = PyList_New(static_cast<Py_ssize_t>(env->slots->size()));
+    if(!list) return nullptr;
+    for(size_t i = 0; i < env->slots->size(); i++) {
+        PyList_SET_ITEM(list, static_cast<Py_ssize_t>(i), PyLong_FromLong((*env->slots)[i].board.score));
+    }
+    return list;
+}
+
+Py_ssize_t VecEnv_len(PyObject* self) {
+    auto* env = reinterpret_cast<VecEnvObject*>(self);
+    return env->slots ? static_cast<Py_ssize_t>(env->slots->size()) : 0;
+}
+
+PyMethodDef VecEnvMethods[] = {
+    {"reset", reinterpret_cast<PyCFunction>(reinterpret_cast<void(*)(void)>(VecEnv_reset)), METH_VARARGS | METH_KEYWORDS,
+     "reset(seed=None): reset every environment."},
+    {"step", VecEnv_step, METH_O,
+     "step(actions): place one pair in every environment (action = orientation * COLS + column)."},
+    {"scores", VecEnv_scores, METH_NOARGS, "scores(): current score of every environment."},
+    {nullptr, nullptr, 0, nullptr}
+};
+
+PyGetSetDef VecEnvGetSet[] = {
+    {"boards", VecEnv_get_boards, nullptr, "(N, ROWS, COLS) uint8 board cells, zero-copy.", nullptr},
+    {"pairs", VecEnv_get_pairs, nullptr, "(N, 4) uint8 current and next pair colours.", nullptr},
+    {"rewards", VecEnv_get_rewards, nullptr, "(N,) float32 score gained by the last step.", nullptr},
+    {"dones", VecEnv_get_dones, nullptr, "(N,) uint8 game-over flags.", nullptr},
+    {"chains", VecEnv_get_chains, nullptr, "(N,) int32 chain length of the last step.", nullptr},
+    {nullptr, nullptr, nullptr, nullptr, nullptr}
+};
+
+PyType_Slot VecEnvSlots[] = {
+    {Py_tp_new, reinterpret_cast<void*>(VecEnv_new)},
+    {Py_tp_init, reinterpret_cast<void*>(VecEnv_init)},
+    {Py_tp_dealloc, reinterpret_cast<void*>(VecEnv_dealloc)},
+    {Py_tp_methods, VecEnvMethods},
+    {Py_tp_getset, VecEnvGetSet},
+    {Py_sq_length, reinterpret_cast<void*>(VecEnv_len)},
+    {Py_tp_doc, const_cast<char*>("VecEnv(num_envs, seed=0, threads=0): batched Puyo environments.")},
+    {0, nullptr}
+};
+
+PyType_Spec VecEnvSpec = {
+    "puyo_env.VecEnv", sizeof(VecEnvObject), 0, Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE, VecEnvSlots
+};
+
+PyModuleDef PuyoEnvModule = {
+    PyModuleDef_HEAD_INIT, "puyo_env", "Batched Puyo Puyo environments over the game rules.", -1,
+    nullptr, nullptr, nullptr, nullptr, nullptr
+};
+
+} // namespace
+
+PyMODINIT_FUNC PyInit_puyo_env(void) {
+    PyObject* module = PyModule_Create(&PuyoEnvModule);
+    if(!module) return nullptr;
+
+    BufferViewType = reinterpret_cast<PyTypeObject*>(PyType_FromSpec(&BufferViewSpec));
+    VecEnvType = reinterpret_cast<PyTypeObject*>(PyType_FromSpec(&VecEnvSpec));
+    if(!BufferViewType || !VecEnvType) {
+        Py_DECREF(module);
+        return nullptr;
+    }
+
+    Py_INCREF(VecEnvType);
+    if(PyModule_AddObject(module, "VecEnv", reinterpret_cast<PyObject*>(VecEnvType)) < 0) {
+        Py_DECREF(VecEnvType);
+        Py_DECREF(module);
+        return nullptr;
+    }
+    PyModule_AddIntConstant(module, "ROWS", ROWS);
+    PyModule_AddIntConstant(module, "COLS", COLS);
+    PyModule_AddIntConstant(module, "NUM_COLORS", COLOR_COUNT - 1);
+    PyModule_AddIntConstant(module, "NUM_PLACEMENTS", NUM_PLACEMENTS);
+    return module;
+}
@@ -0,0 +1,313 @@
+// ---- 학습 데이터 내보내기 도구 (헤드리스) ----
+// 여러 생산자 스레드가 봇으로 게임을 진행하며 레코드 묶음을 만들고,
+// 제한된 크기의 큐를 거쳐 기록 스레드 하나가 샤드 파일로 순차 기록함
+//
+//   ./puyo_export --out=shards --games=100000 --threads=8
+//   ./puyo_export --verify=shards/puyo-00000.bin
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "puyo_core.hpp"
+#include "puyo_shard.hpp"
+
+using namespace std;
+
+// 용량이 찬 동안 생산자를 막아 메모리 사용량을 묶어 두는 큐
+template<class T>
+class BoundedQueue {
+private:
+    deque<T> items;
+    size_t capacity;
+    bool closed = false;
+    mutex m;
+    condition_variable notFull;
+    condition_variable notEmpty;
+
+public:
+    explicit BoundedQueue(size_t cap) : capacity(max<size_t>(1, cap)) {}
+
+    bool push(T&& item) {
+        unique_lock<mutex> lock(m);
+        notFull.wait(lock, [&] { return closed || items.size() < capacity; });
+        if(closed) return false;
+        items.push_back(std::move(item));
+        notEmpty.notify_one();
+        return true;
+    }
+
+    // 큐가 닫히고 비었으면 false
+    bool pop(T& out) {
+        unique_lock<mutex> lock(m);
+        notEmpty.wait(lock, [&] { return closed || !items.empty(); });
+        if(items.empty()) return false;
+        out = std::move(items.front());
+        items.pop_front();
+        notFull.notify_one();
+        return true;
+    }
+
+    void close() {
+        lock_guard<mutex> lock(m);
+        closed = true;
+        notFull.notify_all();
+        notEmpty.notify_all();
+    }
+};
+
+struct ExportOptions {
+    string outDir = ".";
+    string prefix = "puyo";
+    uint64_t games = 1000;
+    int threads = 0;
+    uint64_t shardRecords = 1u << 20;
+    size_t batchRecords = 4096;
+    size_t queueBatches = 64;
+    uint32_t seed = 1;
+    double epsilon = 0.1;
+    int maxMoves = 1000;
+    string verifyPath;
+};
+
+// 탐욕 봇: 배치 24가지를 모두 시험해 (획득 점수 - 높이 벌점)이 가장 큰 것을 고름.
+// epsilon 확률로 무작위 배치를 골라 데이터 분포를 넓힘
+template<class Rng>
+int chooseGreedyPlacement(const BoardCore& board, const PuyoPair& cur, double epsilon, Rng& gen) {
+    uniform_real_distribution<double> coin(0.0, 1.0);
+    if(coin(gen) < epsilon) {
+        uniform_int_distribution<int> any(0, NUM_PLACEMENTS - 1);
+        return any(gen);
+    }
+
+    int best = 0;
+    double bestValue = -1e18;
+    for(int action = 0; action < NUM_PLACEMENTS; action++) {
+        BoardCore trial = board;
+        int before = trial.score;
+        dropPlacement(trial, cur, action / COLS, action % COLS);
+        trial.resolveChains();
+        if(trial.isGameOver()) continue;
+
+        double value = trial.score - before;
+        for(int x = 0; x < COLS; x++) {
+            int y = 0;
+            while(y < ROWS && trial.g[y][x] == EMPTY) y++;
+            int height = ROWS - y;
+            value -= height * height * 0.5;
+        }
+        value += coin(gen) * 0.01;  // 동점 분산
+        if(value > bestValue) {
+            bestValue = value;
+            best = action;
+        }
+    }
+    return best;
+}
+
+struct ExportStats {
+    atomic<uint64_t> gamesDone{0};
+    atomic<uint64_t> recordsMade{0};
+};
+
+void producerLoop(const ExportOptions& opt, atomic<uint64_t>& nextGame, BoundedQueue<vector<uint8_t>>& queue,
+                  ExportStats& stats) {
+    vector<uint8_t> batch;
+    batch.reserve(opt.batchRecords * shard::RECORD_SIZE);
+    shard::Record rec;
+
+    auto flush = [&]() {
+        if(batch.empty()) return true;
+        stats.recordsMade += batch.size() / shard::RECORD_SIZE;
+        bool ok = queue.push(std::move(batch));
+        batch = vector<uint8_t>();
+        batch.reserve(opt.batchRecords * shard::RECORD_SIZE);
+        return ok;
+    };
+
+    for(uint64_t gameIndex = nextGame.fetch_add(1); gameIndex < opt.games; gameIndex = nextGame.fetch_add(1)) {
+        // 게임 번호로 시드를 정함 (샤드 안의 게임 순서는 스레드 수에 따라 달라도 각 게임의 기록은 동일)
+        PuyoRng gameRng(opt.seed + static_cast<uint32_t>(gameIndex) * 2654435761u);
+        mt19937 botRng(gameRng.seed ^ 0x9e3779b9u);
+        BoardCore board;
+        PuyoPair cur = makeSpawnPair(gameRng);
+        PuyoPair next = makeSpawnPair(gameRng);
+
+        for(int move = 0; move < opt.maxMoves; move++) {
+            int action = chooseGreedyPlacement(board, cur, opt.epsilon, botRng);
+
+            rec.g = board.g;
+            rec.cur1 = cur.c1; rec.cur2 = cur.c2;
+            rec.next1 = next.c1; rec.next2 = next.c2;
+            rec.placement = action;
+            rec.level = board.level;
+            rec.gameIndex = static_cast<uint32_t>(gameIndex);
+
+            int before = board.score;
+            dropPlacement(board, cur, action / COLS, action % COLS);
+            rec.chain = board.resolveChains();
+            rec.scoreGained = static_cast<uint32_t>(board.score - before);
+            rec.gameOver = board.isGameOver();
+
+            size_t offset = batch.size();
+            batch.resize(offset + shard::RECORD_SIZE);
+            shard::encode(rec, batch.data() + offset);
+            if(batch.size() >= opt.batchRecords * shard::RECORD_SIZE && !flush()) return;
+
+            if(rec.gameOver) break;
+            cur = next;
+            next = makeSpawnPair(gameRng);
+        }
+        stats.gamesDone++;
+    }
+    flush();
+}
+
+int runExport(const ExportOptions& opt) {
+    int threadCount = opt.threads > 0 ? opt.threads : max(1u, thread::hardware_concurrency());
+    BoundedQueue<vector<uint8_t>> queue(opt.queueBatches);
+
+    // 출력 디렉터리가 없으면 만들고, 첫 샤드를 열어 쓸 수 있는지 먼저 확인
+    error_code ec;
+    if(!opt.outDir.empty()) filesystem::create_directories(opt.outDir, ec);
+    if(ec) {
+        fprintf(stderr, "[export] cannot create %s: %s\n", opt.outDir.c_str(), ec.message().c_str());
+        return 1;
+    }
+    shard::ShardWriter writer(opt.outDir, opt.prefix, opt.shardRecords);
+    if(!writer.open()) {
+        fprintf(stderr, "[export] cannot write shards in %s\n", opt.outDir.c_str());
+        return 1;
+    }
+    ExportStats stats;
+    atomic<uint64_t> nextGame{0};
+    atomic<bool> writeFailed{false};
+
+    auto start = chrono::steady_clock::now();
+
+    // 기록 스레드: 묶음 단위로 받아 큰 버퍼로 순차 기록
+    thread writerThread([&] {
+        vector<uint8_t> batch;
+        while(queue.pop(batch)) {
+            if(!writer.write(batch.data(), batch.size() / shard::RECORD_SIZE)) {
+                writeFailed = true;
+                queue.close();
+                return;
+            }
+        }
+        if(!writer.close()) writeFailed = true;
+    });
+
+    vector<thread> producers;
+    for(int i = 0; i < threadCount; i++) {
+        producers.emplace_back([&] { producerLoop(opt, nextGame, queue, stats); });
+    }
+
+    // 진행 상황 출력
+    while(stats.gamesDone < opt.games && !writeFailed) {
+        this_thread::sleep_for(chrono::milliseconds(500));
+        double elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        fprintf(stderr, "\r[export] games %llu/%llu  records %llu  (%.0f rec/s)",
+                (unsigned long long)stats.gamesDone.load(), (unsigned long long)opt.games,
+                (unsigned long long)stats.recordsMade.load(), stats.recordsMade / max(elapsed, 1e-9));
+    }
+
+    for(auto& t : producers) t.join();
+    queue.close();
+    writerThread.join();
+
+    double elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    fprintf(stderr, "\n");
+    if(writeFailed) {
+        fprintf(stderr, "[export] write failed in %s\n", opt.outDir.c_str());
+        return 1;
+    }
+    printf("games %llu, records %llu, shards %zu, %.2fs (%.0f rec/s, %.1f MB/s)\n",
+           (unsigned long long)opt.games, (unsigned long long)writer.recordsWritten(), writer.shardPaths().size(),
+           elapsed, writer.recordsWritten() / max(elapsed, 1e-9),
+           writer.recordsWritten() * shard::RECORD_SIZE / max(elapsed, 1e-9) / (1024.0 * 1024.0));
+    return 0;
+}
+
+// 샤드를 맵으로 열어 전체를 검사하고 무작위 표본 몇 개를 출력
+int runVerify(const ExportOptions& opt) {
+    shard::ShardReader reader;
+    if(!reader.open(opt.verifyPath)) {
+        fprintf(stderr, "[verify] cannot open shard: %s\n", opt.verifyPath.c_str());
+        return 1;
+    }
+
+    shard::Record rec;
+    uint64_t chainHistogram[20] = {};
+    uint64_t invalid = 0;
+    for(uint64_t i = 0; i < reader.size(); i++) {
+        reader.read(i, rec);
+        bool ok = rec.placement < NUM_PLACEMENTS && rec.cur1 > EMPTY && rec.cur1 < COLOR_COUNT &&
+                  rec.cur2 > EMPTY && rec.cur2 < COLOR_COUNT;
+        for(int y = 0; y < ROWS && ok; y++)
+            for(int x = 0; x < COLS; x++)
+                if(rec.g[y][x] >= COLOR_COUNT) ok = false;
+        if(!ok) invalid++;
+        chainHistogram[min(rec.chain, 19)]++;
+    }
+
+    printf("%s: %llu records, %llu invalid\n", opt.verifyPath.c_str(), (unsigned long long)reader.size(),
+           (unsigned long long)invalid);
+    for(int c = 0; c < 20; c++) {
+        if(chainHistogram[c]) printf("  chain %2d%s: %llu\n", c, c == 19 ? "+" : " ", (unsigned long long)chainHistogram[c]);
+    }
+
+    mt19937_64 gen(opt.seed);
+    for(int s = 0; s < 3 && reader.size() > 0; s++) {
+        uint64_t i = reader.sampleIndex(gen);
+        reader.read(i, rec);
+        printf("\n#%llu game %u  pair %d%d next %d%d  placement %d  chain %d  +%u%s\n", (unsigned long long)i,
+               rec.gameIndex, rec.cur1, rec.cur2, rec.next1, rec.next2, rec.placement, rec.chain, rec.scoreGained,
+               rec.gameOver ? "  (game over)" : "");
+        for(int y = 0; y < ROWS; y++) {
+            printf("  ");
+            for(int x = 0; x < COLS; x++) putchar(".RGBYP"[rec.g[y][x] < COLOR_COUNT ? rec.g[y][x] : 0]);
+            putchar('\n');
+        }
+    }
+    return invalid == 0 ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+    ExportOptions opt;
+    for(int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        auto value = [&](const char* name) -> const char* {
+            size_t n = strlen(name);
+            return strncmp(arg, name, n) == 0 && arg[n] == '=' ? arg + n + 1 : nullptr;
+        };
+        if(const char* v = value("--out")) opt.outDir = v;
+        else if(const char* v = value("--prefix")) opt.prefix = v;
+        else if(const char* v = value("--games")) opt.games = strtoull(v, nullptr, 10);
+        else if(const char* v = value("--threads")) opt.threads = atoi(v);
+        else if(const char* v = value("--shard-records")) opt.shardRecords = strtoull(v, nullptr, 10);
+        else if(const char* v = value("--batch")) opt.batchRecords = max<size_t>(1, strtoull(v, nullptr, 10));
+        else if(const char* v = value("--queue")) opt.queueBatches = strtoull(v, nullptr, 10);
+        else if(const char* v = value("--seed")) opt.seed = static_cast<uint32_t>(strtoul(v, nullptr, 10));
+        else if(const char* v = value("--epsilon")) opt.epsilon = atof(v);
+        else if(const char* v = value("--max-moves")) opt.maxMoves = atoi(v);
+        else if(const char* v = value("--verify")) opt.verifyPath = v;
+        else {
+            fprintf(stderr,
+                    "usage: %s [--out=DIR] [--prefix=NAME] [--games=N] [--threads=N] [--shard-records=N]\n"
+                    "          [--batch=N] [--queue=N] [--seed=N] [--epsilon=F] [--max-moves=N]\n"
+                    "       %s --verify=SHARD\n", argv[0], argv[0]);
+            return 2;
+        }
+    }
+
+    return opt.verifyPath.empty() ? runExport(opt) : runVerify(opt);
+}
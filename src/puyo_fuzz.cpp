@@ -0,0 +1,664 @@
+// ---- 연쇄 엔진 차분 퍼저 (헤드리스) ----
+// 무작위/악의적 보드와 조각 열을 만들어, 처음 구현 그대로의 연쇄 처리(아래 reference:
+// BFS로 그룹 찾기 -> 제거 -> 중력, 처음 점수 공식을 상수로 직접 계산)와 다른 엔진들을 한 수씩 나란히 진행시킴.
+// 기준은 rules:: 표를 쓰지 않으므로 표가 틀려도 어긋남으로 잡힘
+// 보드, 점수, 레벨, 연쇄 수, 게임 오버 중 하나라도 다르면 처음 어긋난 수를 보고하고
+// 수와 칸을 줄여 가며 최소 재현 케이스를 만들어 파일로 남김 (--repro로 다시 실행)
+//
+//   ./puyo_fuzz --cases=5000000 --threads=8
+//   ./puyo_fuzz --engine=resolve-seeded --mode=chain --moves=24
+//   ./puyo_fuzz --repro=fuzz_repro.txt
+//   ./puyo_fuzz --self-test               (일부러 틀린 엔진을 넣어 찾고 줄이는지 확인)
+//
+// 새 최적화 엔진은 Engine을 구현하고 makeEngines()에 추가
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "puyo_chain.hpp"
+
+using namespace std;
+
+using Grid = chain::Grid;
+
+struct FuzzOptions {
+    uint64_t cases = 1000000;
+    int threads = 0;
+    int moves = 16;
+    uint64_t seed = 1;
+    string mode = "mixed";       // random, chain, tall, mixed
+    string engine;               // 비우면 모든 엔진
+    string outPath = "fuzz_repro.txt";
+    string reproPath;
+    bool selfTest = false;
+};
+
+// 엔진 하나가 한 수 뒤에 보여 주는 상태 (엔진끼리 비교하는 값 전부)
+struct Snapshot {
+    Grid g{};
+    int64_t score = 0;
+    int level = 1;
+    int chain = 0;
+    bool gameOver = false;
+};
+
+class Engine {
+public:
+    virtual ~Engine() {}
+    virtual const char* name() const = 0;
+    virtual void reset(const Grid& start) = 0;          // 점수 0, 레벨 1에서 시작
+    virtual void step(const PuyoPair& placed, Snapshot& out) = 0;   // 잠금 + 연쇄 끝까지
+};
+
+// ---- 기준 엔진: 처음 구현 그대로의 알고리즘 (BoardCore가 최적화되어도 이쪽은 바꾸지 않음) ----
+// 전체 칸을 훑으며 BFS로 그룹을 찾고, 4개 이상이면 지우고, 모든 열에 중력.
+// 퍼저 속도를 위해 vector/queue 대신 고정 배열만 씀 (순서와 결과는 같음)
+namespace reference {
+
+struct State {
+    Grid g{};
+    int score = 0;
+    int level = 1;
+};
+
+// 처음 구현의 점수 공식 그대로 (rules::EnhancedRules와 독립: 표를 검증하는 쪽)
+inline int stepScore(int removed, int chainIndex, int groupCount, int level) {
+    std::int64_t base = static_cast<std::int64_t>(removed) * removed * 20;
+    std::int64_t chainBonus = chainIndex >= 2 ? (std::int64_t(1) << (chainIndex - 1)) * 120 : 0;
+    std::int64_t colorBonus = groupCount > 1 ? static_cast<std::int64_t>(groupCount) * groupCount * 100 : 0;
+    std::int64_t massBonus = removed >= 10 ? static_cast<std::int64_t>(removed - 9) * 80 : 0;
+    return static_cast<int>(base + chainBonus + colorBonus + massBonus + level * 10);
+}
+
+inline void lock(State& s, const PuyoPair& p) {
+    if(inBounds(p.pivot.x, p.pivot.y)) s.g[p.pivot.y][p.pivot.x] = p.c1;
+    int sx = p.pivot.x + p.sub.x, sy = p.pivot.y + p.sub.y;
+    if(inBounds(sx, sy)) s.g[sy][sx] = p.c2;
+}
+
+inline void applyGravity(State& s) {
+    for(int x = 0; x < COLS; ++x) {
+        int write = ROWS - 1;
+        for(int y = ROWS - 1; y >= 0; --y) {
+            if(s.g[y][x] != EMPTY) {
+                Color c = s.g[y][x];
+                s.g[y][x] = EMPTY;
+                s.g[write][x] = c;
+                write--;
+            }
+        }
+    }
+}
+
+inline int popGroupsAndScore(State& s, int chainIndex) {
+    bool vis[ROWS][COLS] = {};
+    Vec2 group[ROWS * COLS];   // BFS 큐 겸 그룹 목록
+    int removedTotal = 0, groupCount = 0;
+    for(int y = 0; y < ROWS; ++y) {
+        for(int x = 0; x < COLS; ++x) {
+            if(s.g[y][x] == EMPTY || vis[y][x]) continue;
+            Color c = s.g[y][x];
+            int head = 0, size = 0;
+            group[size++] = {x, y};
+            vis[y][x] = true;
+            while(head < size) {
+                Vec2 v = group[head++];
+                const int dx[4] = {1, -1, 0, 0};
+                const int dy[4] = {0, 0, 1, -1};
+                for(int i = 0; i < 4; ++i) {
+                    int nx = v.x + dx[i], ny = v.y + dy[i];
+                    if(inBounds(nx, ny) && !vis[ny][nx] && s.g[ny][nx] == c) {
+                        vis[ny][nx] = true;
+                        group[size++] = {nx, ny};
+                    }
+                }
+            }
+            if(size >= 4) {
+                for(int i = 0; i < size; i++) s.g[group[i].y][group[i].x] = EMPTY;
+                removedTotal += size;
+                groupCount++;
+            }
+        }
+    }
+    if(removedTotal > 0) {
+        s.score += stepScore(removedTotal, chainIndex, groupCount, s.level);
+        int newLevel = std::min(25, s.score / 1200 + 1);
+        if(newLevel > s.level) {
+            s.level = newLevel;
+            s.score += s.level * 150;
+        }
+    }
+    return removedTotal;
+}
+
+inline bool isGameOver(const State& s) {
+    for(int x = 0; x < COLS; ++x)
+        if(s.g[1][x] != EMPTY) return true;
+    return false;
+}
+
+// 4개 이상 그룹이 없는지 (증분 엔진은 안정된 보드에서 출발해야 함)
+inline bool isStable(const Grid& g) {
+    State s;
+    s.g = g;
+    return popGroupsAndScore(s, 1) == 0;
+}
+
+} // namespace reference
+
+class ReferenceEngine : public Engine {
+    reference::State s;
+
+public:
+    const char* name() const override { return "reference"; }
+    void reset(const Grid& start) override {
+        s = reference::State();
+        s.g = start;
+    }
+    void step(const PuyoPair& placed, Snapshot& out) override {
+        reference::lock(s, placed);
+        int chainIndex = 1;
+        while(reference::popGroupsAndScore(s, chainIndex) > 0) {
+            reference::applyGravity(s);
+            chainIndex++;
+        }
+        out.g = s.g;
+        out.score = s.score;
+        out.level = s.level;
+        out.chain = chainIndex - 1;
+        out.gameOver = reference::isGameOver(s);
+    }
+    const Grid& grid() const { return s.g; }
+};
+
+// 게임이 쓰는 보드 (BoardCore / Board64)
+template<class Board>
+class BoardEngine : public Engine {
+    const char* label;
+    Board b;
+
+public:
+    explicit BoardEngine(const char* n) : label(n) {}
+    const char* name() const override { return label; }
+    void reset(const Grid& start) override {
+        b.clear();
+        b.g = start;
+    }
+    void step(const PuyoPair& placed, Snapshot& out) override {
+        b.lock(placed);
+        out.chain = b.resolveChains();
+        out.g = b.g;
+        out.score = static_cast<int64_t>(b.score);
+        out.level = b.level;
+        out.gameOver = b.isGameOver();
+    }
+};
+
+// 연쇄 분석기의 빠른 시뮬레이션 (seeded: 놓인 두 칸만 검사, 아니면 전체 검사)
+class ResolveEngine : public Engine {
+    bool seeded;
+    Grid g{};
+    int score = 0, level = 1;
+
+public:
+    explicit ResolveEngine(bool s) : seeded(s) {}
+    const char* name() const override { return seeded ? "resolve-seeded" : "resolve-full"; }
+    void reset(const Grid& start) override {
+        g = start;
+        score = 0;
+        level = 1;
+    }
+    void step(const PuyoPair& placed, Snapshot& out) override {
+        Vec2 seeds[2];
+        int n = 0;
+        if(inBounds(placed.pivot.x, placed.pivot.y)) {
+            g[placed.pivot.y][placed.pivot.x] = placed.c1;
+            seeds[n++] = placed.pivot;
+        }
+        Vec2 sub = { placed.pivot.x + placed.sub.x, placed.pivot.y + placed.sub.y };
+        if(inBounds(sub.x, sub.y)) {
+            g[sub.y][sub.x] = placed.c2;
+            seeds[n++] = sub;
+        }
+        chain::ChainOutcome o = chain::resolve(g, seeded ? seeds : nullptr, n, score, level);
+        score = o.score;
+        level = o.level;
+        out.g = g;
+        out.score = score;
+        out.level = level;
+        out.chain = o.chain;
+        out.gameOver = false;
+        for(int x = 0; x < COLS; x++)
+            if(g[1][x] != EMPTY) out.gameOver = true;
+    }
+};
+
+// --self-test 전용: 3연쇄 이상의 점수 표가 1 모자란 일부러 틀린 규칙 (표 회귀를 기준 엔진이 잡는지 확인)
+struct BrokenRules : rules::EnhancedRules {
+    static constexpr Score stepScore(const ChainStep& s, int level) {
+        return rules::EnhancedRules::stepScore(s, level) - (s.chainIndex >= 3 ? 1 : 0);
+    }
+};
+
+vector<unique_ptr<Engine>> makeEngines(const FuzzOptions& opt) {
+    vector<unique_ptr<Engine>> all;
+    all.emplace_back(new BoardEngine<BoardCore>("board"));
+    all.emplace_back(new BoardEngine<Board64>("board64"));
+    all.emplace_back(new ResolveEngine(true));
+    all.emplace_back(new ResolveEngine(false));
+    if(opt.selfTest) all.emplace_back(new BoardEngine<BasicBoard<BrokenRules>>("broken-self-test"));
+    if(opt.engine.empty()) return all;
+    vector<unique_ptr<Engine>> picked;
+    for(auto& e : all)
+        if(opt.engine == e->name()) picked.push_back(std::move(e));
+    return picked;
+}
+
+// ---- 케이스: 시작 보드 + 조각(색, 배치 번호) 열. 배치 위치는 기준 보드에서 dropPlacement로 정함 ----
+struct Move {
+    Color c1, c2;
+    uint8_t action;   // 방향 * COLS + 열
+};
+
+struct Case {
+    Grid start{};
+    vector<Move> moves;
+};
+
+struct Divergence {
+    bool found = false;
+    int move = -1;
+    string engine;
+    string detail;
+};
+
+static const char COLOR_CHARS[COLOR_COUNT + 1] = ".RGBYP";
+
+static string describe(const Snapshot& want, const Snapshot& got) {
+    char buf[160];
+    if(want.chain != got.chain) snprintf(buf, sizeof(buf), "chain %d, reference %d", got.chain, want.chain);
+    else if(want.score != got.score)
+        snprintf(buf, sizeof(buf), "score %lld, reference %lld", (long long)got.score, (long long)want.score);
+    else if(want.level != got.level) snprintf(buf, sizeof(buf), "level %d, reference %d", got.level, want.level);
+    else if(want.gameOver != got.gameOver)
+        snprintf(buf, sizeof(buf), "game over %d, reference %d", got.gameOver, want.gameOver);
+    else if(want.g != got.g) {
+        for(int y = 0; y < ROWS; y++)
+            for(int x = 0; x < COLS; x++)
+                if(want.g[y][x] != got.g[y][x]) {
+                    snprintf(buf, sizeof(buf), "cell (%d,%d) is %c, reference %c", x, y, COLOR_CHARS[got.g[y][x]],
+                             COLOR_CHARS[want.g[y][x]]);
+                    return buf;
+                }
+    } else {
+        return "";
+    }
+    return buf;
+}
+
+// 기준 엔진과 나란히 진행해 처음 어긋난 수 (wantEngine이 있으면 그 엔진만 봄)
+struct Runner {
+    ReferenceEngine ref;
+    vector<unique_ptr<Engine>> engines;
+    BoardCore mover;   // 배치 위치 계산용 (이동/회전 규칙은 시험 대상이 아님)
+    uint64_t moves = 0, chains = 0, gameOvers = 0;
+    int maxChain = 0;
+
+    Divergence run(const Case& c, const Engine* only = nullptr) {
+        Divergence d;
+        ref.reset(c.start);
+        for(auto& e : engines)
+            if(!only || e.get() == only) e->reset(c.start);
+        Snapshot want, got;
+        for(size_t t = 0; t < c.moves.size(); t++) {
+            PuyoPair pair;
+            pair.pivot = { COLS/2, 0 };
+            pair.sub = { 0, -1 };
+            pair.c1 = c.moves[t].c1;
+            pair.c2 = c.moves[t].c2;
+            mover.g = ref.grid();
+            PuyoPair placed = dropPlacement(mover, pair, c.moves[t].action / COLS, c.moves[t].action % COLS);
+
+            ref.step(placed, want);
+            moves++;
+            if(want.chain > 0) chains++;
+            maxChain = max(maxChain, want.chain);
+            for(auto& e : engines) {
+                if(only && e.get() != only) continue;
+                e->step(placed, got);
+                string detail = describe(want, got);
+                if(!detail.empty()) {
+                    d.found = true;
+                    d.move = static_cast<int>(t);
+                    d.engine = e->name();
+                    d.detail = detail;
+                    return d;
+                }
+            }
+            if(want.gameOver) {
+                gameOvers++;
+                break;
+            }
+        }
+        return d;
+    }
+
+    Engine* find(const string& name) {
+        for(auto& e : engines)
+            if(name == e->name()) return e.get();
+        return nullptr;
+    }
+};
+
+// ---- 케이스 생성 ----
+static uint64_t mix(uint64_t z) {
+    z += 0x9e3779b97f4a7c15ull;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+static void settle(Grid& g) {
+    reference::State s;
+    s.g = g;
+    reference::applyGravity(s);
+    int chainIndex = 1;
+    while(reference::popGroupsAndScore(s, chainIndex) > 0) {
+        reference::applyGravity(s);
+        chainIndex++;
+    }
+    g = s.g;
+}
+
+// 게임 오버 줄(1행) 아래까지만 쌓음
+static const int MAX_START_HEIGHT = ROWS - 2;
+
+Case generate(uint64_t seed, const FuzzOptions& opt) {
+    mt19937_64 rng(mix(seed));
+    Case c;
+    string mode = opt.mode;
+    if(mode == "mixed") {
+        static const char* MODES[] = { "random", "chain", "tall" };
+        mode = MODES[rng() % 3];
+    }
+    // 색 가짓수를 줄이면 큰 그룹, 동시 제거, 긴 연쇄가 자주 나옴
+    int colors = 2 + static_cast<int>(rng() % (COLOR_COUNT - 2));
+    auto color = [&]() { return static_cast<Color>(1 + rng() % colors); };
+
+    if(mode == "chain") {
+        // 터지지 않는 범위에서 같은 색끼리 가장 많이 닿는 곳에 조각을 쌓음 (3개 묶음이 층층이 쌓인
+        // 보드가 되어 한 조각이 긴 연쇄를 일으키기 쉬움)
+        BoardCore b;
+        int pieces = 8 + static_cast<int>(rng() % 22);
+        for(int i = 0; i < pieces; i++) {
+            PuyoPair pair;
+            pair.pivot = { COLS/2, 0 };
+            pair.sub = { 0, -1 };
+            pair.c1 = color();
+            pair.c2 = color();
+            int bestAction = -1, bestTouch = -1;
+            for(int a = 0; a < NUM_PLACEMENTS; a++) {
+                BoardCore trial = b;
+                PuyoPair placed = dropPlacement(trial, pair, a / COLS, a % COLS);
+                Vec2 cells[2] = { placed.pivot, { placed.pivot.x + placed.sub.x, placed.pivot.y + placed.sub.y } };
+                if(!inBounds(cells[1].x, cells[1].y) || cells[0].y < ROWS - MAX_START_HEIGHT ||
+                   cells[1].y < ROWS - MAX_START_HEIGHT) continue;
+                Grid g = trial.g;
+                if(chain::resolve(g, cells, 2, 0, 1).chain > 0) continue;
+                int touch = static_cast<int>(rng() % 2);   // 동점이면 무작위
+                for(const Vec2& v : cells) {
+                    static const int DX[4] = {1, -1, 0, 0}, DY[4] = {0, 0, 1, -1};
+                    for(int k = 0; k < 4; k++) {
+                        int nx = v.x + DX[k], ny = v.y + DY[k];
+                        if(inBounds(nx, ny) && trial.g[ny][nx] == trial.g[v.y][v.x]) touch += 2;
+                    }
+                }
+                if(touch > bestTouch) {
+                    bestTouch = touch;
+                    bestAction = a;
+                }
+            }
+            if(bestAction < 0) break;
+            dropPlacement(b, pair, bestAction / COLS, bestAction % COLS);
+        }
+        c.start = b.g;
+    } else {
+        int maxHeight = mode == "tall" ? MAX_START_HEIGHT : 1 + static_cast<int>(rng() % MAX_START_HEIGHT);
+        for(int x = 0; x < COLS; x++) {
+            int h = mode == "tall" ? MAX_START_HEIGHT - static_cast<int>(rng() % 3)
+                                   : static_cast<int>(rng() % (maxHeight + 1));
+            for(int y = 0; y < h; y++) c.start[ROWS - 1 - y][x] = color();
+        }
+    }
+    settle(c.start);
+
+    int moveCount = 1 + static_cast<int>(rng() % opt.moves);
+    for(int i = 0; i < moveCount; i++) {
+        Move m;
+        m.c1 = color();
+        m.c2 = rng() % 4 == 0 ? m.c1 : color();
+        m.action = static_cast<uint8_t>(rng() % NUM_PLACEMENTS);
+        c.moves.push_back(m);
+    }
+    return c;
+}
+
+// ---- 최소화: 수를 줄이고, 시작 보드의 칸을 비워도 같은 엔진이 계속 어긋나면 채택 ----
+Case minimize(Runner& runner, Case c, const Divergence& first) {
+    Engine* engine = runner.find(first.engine);
+    auto fails = [&](const Case& t) { return runner.run(t, engine).found; };
+
+    c.moves.resize(static_cast<size_t>(first.move) + 1);
+    bool changed = true;
+    while(changed) {
+        changed = false;
+        for(size_t i = 0; i < c.moves.size() && c.moves.size() > 1; i++) {
+            Case t = c;
+            t.moves.erase(t.moves.begin() + static_cast<long>(i));
+            if(fails(t)) {
+                c = t;
+                i--;
+                changed = true;
+            }
+        }
+        for(int y = 0; y < ROWS; y++)
+            for(int x = 0; x < COLS; x++) {
+                if(c.start[y][x] == EMPTY) continue;
+                // 비운 칸 위가 떠 있지 않도록 중력을 적용 (실제 게임에서 나올 수 있는 보드만)
+                reference::State s;
+                s.g = c.start;
+                s.g[y][x] = EMPTY;
+                reference::applyGravity(s);
+                Case t = c;
+                t.start = s.g;
+                if(!reference::isStable(t.start) || !fails(t)) continue;
+                c = t;
+                changed = true;
+            }
+        // 어긋나는 수 뒤의 수는 필요 없음
+        Divergence d = runner.run(c, engine);
+        if(d.found && static_cast<size_t>(d.move) + 1 < c.moves.size()) {
+            c.moves.resize(static_cast<size_t>(d.move) + 1);
+            changed = true;
+        }
+    }
+    return c;
+}
+
+// ---- 재현 파일 ----
+// self-test 줄: 일부러 틀린 엔진이 있어야 재현됨 (--repro가 엔진 구성을 그대로 복원)
+bool writeRepro(const string& path, const Case& c, const Divergence& d, bool selfTest) {
+    FILE* fp = fopen(path.c_str(), "w");
+    if(!fp) return false;
+    fprintf(fp, "# %s diverges from reference at move %d: %s\n", d.engine.c_str(), d.move, d.detail.c_str());
+    if(selfTest) fprintf(fp, "self-test\n");
+    fprintf(fp, "board\n");
+    for(int y = 0; y < ROWS; y++) {
+        for(int x = 0; x < COLS; x++) fputc(COLOR_CHARS[c.start[y][x]], fp);
+        fputc('\n', fp);
+    }
+    fprintf(fp, "moves  # colors orientation column\n");
+    for(const Move& m : c.moves)
+        fprintf(fp, "%c%c %d %d\n", COLOR_CHARS[m.c1], COLOR_CHARS[m.c2], m.action / COLS, m.action % COLS);
+    return fclose(fp) == 0;
+}
+
+static Color colorOf(char ch) {
+    const char* p = strchr(COLOR_CHARS, ch);
+    return p && ch ? static_cast<Color>(p - COLOR_CHARS) : EMPTY;
+}
+
+bool readRepro(const string& path, Case& c, bool& selfTest) {
+    FILE* fp = fopen(path.c_str(), "r");
+    if(!fp) return false;
+    char line[256];
+    int section = 0, row = 0;   // 1: board, 2: moves
+    while(fgets(line, sizeof(line), fp)) {
+        if(line[0] == '#') continue;
+        if(strncmp(line, "self-test", 9) == 0) { selfTest = true; continue; }
+        if(strncmp(line, "board", 5) == 0) { section = 1; continue; }
+        if(strncmp(line, "moves", 5) == 0) { section = 2; continue; }
+        if(section == 1 && row < ROWS) {
+            for(int x = 0; x < COLS && line[x] && line[x] != '\n'; x++) c.start[row][x] = colorOf(line[x]);
+            row++;
+        } else if(section == 2) {
+            char a, b;
+            int o, col;
+            if(sscanf(line, " %c%c %d %d", &a, &b, &o, &col) != 4) continue;
+            Move m;
+            m.c1 = colorOf(a);
+            m.c2 = colorOf(b);
+            m.action = static_cast<uint8_t>((o & 3) * COLS + min(max(col, 0), COLS - 1));
+            c.moves.push_back(m);
+        }
+    }
+    fclose(fp);
+    return row == ROWS;
+}
+
+int main(int argc, char** argv) {
+    FuzzOptions opt;
+    for(int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        auto value = [&](const char* name) -> const char* {
+            size_t n = strlen(name);
+            return strncmp(arg, name, n) == 0 && arg[n] == '=' ? arg + n + 1 : nullptr;
+        };
+        if(const char* v = value("--cases")) opt.cases = strtoull(v, nullptr, 10);
+        else if(const char* v = value("--threads")) opt.threads = atoi(v);
+        else if(const char* v = value("--moves")) opt.moves = max(1, atoi(v));
+        else if(const char* v = value("--seed")) opt.seed = strtoull(v, nullptr, 10);
+        else if(const char* v = value("--mode")) opt.mode = v;
+        else if(const char* v = value("--engine")) opt.engine = v;
+        else if(const char* v = value("--out")) opt.outPath = v;
+        else if(const char* v = value("--repro")) opt.reproPath = v;
+        else if(strcmp(arg, "--self-test") == 0) opt.selfTest = true;
+        else {
+            fprintf(stderr,
+                    "usage: %s [--cases=N] [--threads=N] [--moves=N] [--seed=N] [--mode=random|chain|tall|mixed]\n"
+                    "          [--engine=NAME] [--out=FILE] [--self-test]\n"
+                    "       %s --repro=FILE [--engine=NAME] [--self-test]\n"
+                    "          (a repro written by --self-test turns --self-test on by itself)\n", argv[0], argv[0]);
+            return 2;
+        }
+    }
+    if(opt.mode != "random" && opt.mode != "chain" && opt.mode != "tall" && opt.mode != "mixed") {
+        fprintf(stderr, "unknown mode: %s\n", opt.mode.c_str());
+        return 2;
+    }
+    // 재현 파일이 엔진 구성(self-test)을 정하므로 먼저 읽음
+    Case repro;
+    if(!opt.reproPath.empty() && !readRepro(opt.reproPath, repro, opt.selfTest)) {
+        fprintf(stderr, "cannot read %s\n", opt.reproPath.c_str());
+        return 2;
+    }
+    if(makeEngines(opt).empty()) {
+        fprintf(stderr, "unknown engine: %s\n", opt.engine.c_str());
+        return 2;
+    }
+
+    if(!opt.reproPath.empty()) {
+        const Case& c = repro;
+        Runner runner;
+        runner.engines = makeEngines(opt);
+        Divergence d = runner.run(c);
+        if(!d.found) {
+            printf("%s: all engines agree over %zu moves\n", opt.reproPath.c_str(), c.moves.size());
+            return 0;
+        }
+        printf("%s: %s diverges at move %d: %s\n", opt.reproPath.c_str(), d.engine.c_str(), d.move, d.detail.c_str());
+        return 1;
+    }
+
+    int threadCount = opt.threads > 0 ? opt.threads : max(1u, thread::hardware_concurrency());
+    const uint64_t CHUNK = 256;
+    atomic<uint64_t> next{0};
+    atomic<uint64_t> firstFailure{UINT64_MAX};   // 가장 앞의 실패 케이스 (스레드 수와 무관하게 같은 결과)
+    atomic<uint64_t> totalMoves{0}, totalChains{0}, totalGameOvers{0};
+    atomic<int> maxChain{0};
+    auto start = chrono::steady_clock::now();
+
+    vector<thread> workers;
+    for(int t = 0; t < threadCount; t++) {
+        workers.emplace_back([&] {
+            Runner runner;
+            runner.engines = makeEngines(opt);
+            while(true) {
+                uint64_t begin = next.fetch_add(CHUNK);
+                if(begin >= opt.cases || begin > firstFailure.load()) break;
+                uint64_t end = min(opt.cases, begin + CHUNK);
+                for(uint64_t i = begin; i < end; i++) {
+                    if(!runner.run(generate(opt.seed + i, opt)).found) continue;
+                    uint64_t seen = firstFailure.load();
+                    while(i < seen && !firstFailure.compare_exchange_weak(seen, i)) {}
+                    break;
+                }
+            }
+            totalMoves += runner.moves;
+            totalChains += runner.chains;
+            totalGameOvers += runner.gameOvers;
+            int seen = maxChain.load();
+            while(runner.maxChain > seen && !maxChain.compare_exchange_weak(seen, runner.maxChain)) {}
+        });
+    }
+    for(auto& w : workers) w.join();
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    uint64_t failed = firstFailure.load();
+    uint64_t ran = failed == UINT64_MAX ? opt.cases : min(opt.cases, next.load());
+    printf("%llu cases (%llu moves, %llu with chains, %llu game overs, longest chain %d) on %d threads in %.1f s: "
+           "%.2f M cases/min\n",
+           (unsigned long long)ran, (unsigned long long)totalMoves.load(), (unsigned long long)totalChains.load(),
+           (unsigned long long)totalGameOvers.load(), maxChain.load(), threadCount, seconds,
+           ran / max(seconds, 1e-9) * 60.0 / 1e6);
+    if(failed == UINT64_MAX) {
+        printf("no divergence\n");
+        return 0;
+    }
+
+    Runner runner;
+    runner.engines = makeEngines(opt);
+    Case c = generate(opt.seed + failed, opt);
+    Divergence d = runner.run(c);
+    printf("case %llu (rerun alone with --seed=%llu --cases=1): %s diverges from reference at move %d: %s\n", (unsigned long long)failed,
+           (unsigned long long)(opt.seed + failed), d.engine.c_str(), d.move, d.detail.c_str());
+    Case small = minimize(runner, c, d);
+    Divergence ds = runner.run(small, runner.find(d.engine));
+    int cells = 0;
+    for(auto& row : small.start)
+        for(Color col : row) cells += col != EMPTY;
+    printf("minimized to %zu moves and %d board cells: move %d: %s\n", small.moves.size(), cells, ds.move,
+           ds.detail.c_str());
+    if(writeRepro(opt.outPath, small, ds, opt.selfTest)) printf("reproducer written to %s (run with --repro=%s)\n",
+                                                  opt.outPath.c_str(), opt.outPath.c_str());
+    return 1;
+}
@@ -0,0 +1,388 @@
+#pragma once
+// ---- 실행 중 계측 (Prometheus 텍스트 형식, 로컬 HTTP로 노출) ----
+// 뜨거운 경로는 스레드별 칸에 relaxed 원자 덧셈만 함 (잠금 없음, 칸마다 캐시 라인 분리).
+// 긁을 때(scrape) 모든 칸을 합침. 히스토그램은 HDR 방식 로그-선형 버킷:
+// 2배마다 8칸 (상대 오차 12.5% 이내), 나노초 정수로 기록하고 노출할 때만 초로 바꿈
+//
+//   metrics::Registry registry;
+//   metrics::Histogram& frame = registry.histogram("puyo_frame_seconds", "...");
+//   frame.record(nanos);
+//   metrics::HttpExporter http;
+//   http.start(registry, 9464);           // curl http://127.0.0.1:9464/metrics
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#  ifndef WIN32_LEAN_AND_MEAN
+#    define WIN32_LEAN_AND_MEAN
+#  endif
+#  ifndef NOMINMAX
+#    define NOMINMAX
+#  endif
+#  include <winsock2.h>
+#  include <ws2tcpip.h>
+#else
+#  include <arpa/inet.h>
+#  include <netinet/in.h>
+#  include <poll.h>
+#  include <sys/socket.h>
+#  include <unistd.h>
+#endif
+
+namespace metrics {
+
+static const int MAX_SLOTS = 16;   // 스레드 칸 수 (스레드가 더 많으면 칸을 나눠 씀 - 원자 덧셈이라 값은 정확)
+
+// 이 스레드의 칸 번호 (처음 쓸 때 한 번 정함)
+inline int threadSlot() {
+    static std::atomic<int> next{0};
+    thread_local int slot = next.fetch_add(1, std::memory_order_relaxed) % MAX_SLOTS;
+    return slot;
+}
+
+inline std::uint64_t nowNanos() {
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+struct alignas(64) Cell {
+    std::atomic<std::uint64_t> value{0};
+};
+
+// 단조 증가 카운터. 정적 객체로 두면 상수 초기화됨 (operator new 계측에서도 안전)
+class Counter {
+private:
+    Cell cells[MAX_SLOTS];
+
+public:
+    void add(std::uint64_t n = 1) { cells[threadSlot()].value.fetch_add(n, std::memory_order_relaxed); }
+
+    std::uint64_t value() const {
+        std::uint64_t sum = 0;
+        for(const Cell& c : cells) sum += c.value.load(std::memory_order_relaxed);
+        return sum;
+    }
+};
+
+// 마지막 값 (프레임당 파티클 수 등, 한 스레드가 씀)
+class Gauge {
+private:
+    std::atomic<std::int64_t> v{0};
+
+public:
+    void set(std::int64_t x) { v.store(x, std::memory_order_relaxed); }
+    std::int64_t value() const { return v.load(std::memory_order_relaxed); }
+};
+
+class Histogram {
+public:
+    static const int SUB_BITS = 3;
+    static const int SUB = 1 << SUB_BITS;
+    static const int BUCKETS = (64 - SUB_BITS + 1) * SUB;
+
+    // 8 미만은 그대로, 그 위는 최상위 비트(2배 구간) + 그 아래 3비트(구간 안 8칸)
+    static int bucketOf(std::uint64_t n) {
+        if(n < static_cast<std::uint64_t>(SUB)) return static_cast<int>(n);
+        int msb = 63 - __builtin_clzll(n);
+        return (msb - SUB_BITS + 1) * SUB + static_cast<int>((n >> (msb - SUB_BITS)) & (SUB - 1));
+    }
+
+    // 버킷의 상한 (이 값 미만이 들어감)
+    static std::uint64_t upperBound(int bucket) {
+        if(bucket < SUB) return static_cast<std::uint64_t>(bucket) + 1;
+        int shift = bucket / SUB - 1;
+        return static_cast<std::uint64_t>(SUB + bucket % SUB + 1) << shift;
+    }
+
+private:
+    struct alignas(64) Slot {
+        std::atomic<std::uint64_t> buckets[BUCKETS];
+        std::atomic<std::uint64_t> sum;
+    };
+    std::unique_ptr<Slot[]> slots;
+
+public:
+    Histogram() : slots(new Slot[MAX_SLOTS]) {
+        for(int s = 0; s < MAX_SLOTS; s++) {
+            for(auto& b : slots[s].buckets) b.store(0, std::memory_order_relaxed);
+            slots[s].sum.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    void record(std::uint64_t nanos) {
+        Slot& s = slots[threadSlot()];
+        s.buckets[bucketOf(nanos)].fetch_add(1, std::memory_order_relaxed);
+        s.sum.fetch_add(nanos, std::memory_order_relaxed);
+    }
+
+    // 모든 칸을 합친 버킷 (긁을 때만)
+    void snapshot(std::vector<std::uint64_t>& buckets, std::uint64_t& sum) const {
+        buckets.assign(BUCKETS, 0);
+        sum = 0;
+        for(int s = 0; s < MAX_SLOTS; s++) {
+            for(int b = 0; b < BUCKETS; b++) buckets[b] += slots[s].buckets[b].load(std::memory_order_relaxed);
+            sum += slots[s].sum.load(std::memory_order_relaxed);
+        }
+    }
+
+    // snapshot 버킷(또는 두 snapshot의 차이)의 백분위 (버킷 상한, 나노초)
+    static std::uint64_t percentile(const std::vector<std::uint64_t>& buckets, double p) {
+        std::uint64_t count = 0;
+        for(std::uint64_t b : buckets) count += b;
+        if(count == 0) return 0;
+        std::uint64_t want = static_cast<std::uint64_t>(p * count), seen = 0;
+        for(size_t i = 0; i < buckets.size(); i++) {
+            seen += buckets[i];
+            if(seen > want) return upperBound(static_cast<int>(i));
+        }
+        return upperBound(static_cast<int>(buckets.size()) - 1);
+    }
+};
+
+// 범위를 벗어날 때 걸린 시간을 기록
+class ScopedTimer {
+private:
+    Histogram& histogram;
+    std::uint64_t start;
+
+public:
+    explicit ScopedTimer(Histogram& h) : histogram(h), start(nowNanos()) {}
+    ~ScopedTimer() { histogram.record(nowNanos() - start); }
+};
+
+class Registry {
+private:
+    enum Kind { COUNTER, GAUGE, HISTOGRAM };
+    struct Entry {
+        std::string name, help;
+        Kind kind;
+        const void* metric;
+    };
+
+    mutable std::mutex mutex;
+    std::vector<Entry> entries;
+    std::vector<std::unique_ptr<Counter>> counters;
+    std::vector<std::unique_ptr<Gauge>> gauges;
+    std::vector<std::unique_ptr<Histogram>> histograms;
+
+    // 노출하는 히스토그램 경계: 2^10 ns (약 1 us) ~ 2^35 ns (약 34 s), 2배마다
+    static const int LE_FIRST = 10;
+    static const int LE_LAST = 35;
+
+    void add(const std::string& name, const std::string& help, Kind kind, const void* metric) {
+        std::lock_guard<std::mutex> lock(mutex);
+        entries.push_back({name, help, kind, metric});
+    }
+
+    static void appendf(std::string& out, const char* fmt, ...) {
+        char line[256];
+        va_list args;
+        va_start(args, fmt);
+        int n = vsnprintf(line, sizeof(line), fmt, args);
+        va_end(args);
+        if(n > 0) out.append(line, static_cast<size_t>(std::min(n, static_cast<int>(sizeof(line)) - 1)));
+    }
+
+public:
+    Counter& counter(const std::string& name, const std::string& help) {
+        counters.emplace_back(new Counter());
+        add(name, help, COUNTER, counters.back().get());
+        return *counters.back();
+    }
+
+    Gauge& gauge(const std::string& name, const std::string& help) {
+        gauges.emplace_back(new Gauge());
+        add(name, help, GAUGE, gauges.back().get());
+        return *gauges.back();
+    }
+
+    Histogram& histogram(const std::string& name, const std::string& help) {
+        histograms.emplace_back(new Histogram());
+        add(name, help, HISTOGRAM, histograms.back().get());
+        return *histograms.back();
+    }
+
+    // 밖에서 소유한 카운터 (operator new 계측처럼 레지스트리보다 먼저 살아 있는 것)
+    void expose(const std::string& name, const std::string& help, const Counter& c) {
+        add(name, help, COUNTER, &c);
+    }
+
+    // Prometheus 텍스트 형식 0.0.4
+    std::string render() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::string out;
+        std::vector<std::uint64_t> buckets;
+        for(const Entry& e : entries) {
+            static const char* TYPE_NAMES[] = { "counter", "gauge", "histogram" };
+            appendf(out, "# HELP %s %s\n# TYPE %s %s\n", e.name.c_str(), e.help.c_str(), e.name.c_str(),
+                    TYPE_NAMES[e.kind]);
+            if(e.kind == COUNTER) {
+                appendf(out, "%s %llu\n", e.name.c_str(),
+                        (unsigned long long)static_cast<const Counter*>(e.metric)->value());
+            } else if(e.kind == GAUGE) {
+                appendf(out, "%s %lld\n", e.name.c_str(), (long long)static_cast<const Gauge*>(e.metric)->value());
+            } else {
+                std::uint64_t sum = 0, seen = 0;
+                static_cast<const Histogram*>(e.metric)->snapshot(buckets, sum);
+                int b = 0;
+                for(int k = LE_FIRST; k <= LE_LAST; k++) {
+                    // 2^k는 k번째 2배 구간의 첫 버킷 하한 = 앞 버킷들의 상한
+                    int end = Histogram::bucketOf(1ull << k);
+                    for(; b < end; b++) seen += buckets[b];
+                    appendf(out, "%s_bucket{le=\"%.9g\"} %llu\n", e.name.c_str(), (1ull << k) * 1e-9,
+                            (unsigned long long)seen);
+                }
+                for(; b < Histogram::BUCKETS; b++) seen += buckets[b];
+                appendf(out, "%s_bucket{le=\"+Inf\"} %llu\n%s_sum %.9f\n%s_count %llu\n", e.name.c_str(),
+                        (unsigned long long)seen, e.name.c_str(), sum * 1e-9, e.name.c_str(),
+                        (unsigned long long)seen);
+            }
+        }
+        return out;
+    }
+};
+
+// 127.0.0.1 전용 HTTP 노출기. 자기 스레드에서 한 번에 한 요청씩 처리 (긁는 쪽은 몇 초에 한 번)
+class HttpExporter {
+private:
+#ifdef _WIN32
+    using Socket = SOCKET;
+    static const Socket NO_SOCKET = INVALID_SOCKET;
+    static void closeSocket(Socket s) { closesocket(s); }
+#else
+    using Socket = int;
+    static const Socket NO_SOCKET = -1;
+    static void closeSocket(Socket s) { close(s); }
+#endif
+#ifdef MSG_NOSIGNAL
+    static const int SEND_FLAGS = MSG_NOSIGNAL;
+#else
+    static const int SEND_FLAGS = 0;
+#endif
+
+    const Registry* registry = nullptr;
+    Socket listener = NO_SOCKET;
+    std::thread thread;
+    std::atomic<bool> stopping{false};
+
+    // poll: 서버가 소켓을 많이 열어 번호가 FD_SETSIZE를 넘어도 안전 (select의 fd_set은 넘치면 메모리를 덮음)
+    static bool readable(Socket s, int millis) {
+        pollfd p{};
+        p.fd = s;
+        p.events = POLLIN;
+#ifdef _WIN32
+        return WSAPoll(&p, 1, millis) > 0;
+#else
+        return poll(&p, 1, millis) > 0;
+#endif
+    }
+
+    static void sendAll(Socket s, const std::string& data) {
+        size_t pos = 0;
+        while(pos < data.size()) {
+            int n = send(s, data.data() + pos, static_cast<int>(data.size() - pos), SEND_FLAGS);
+            if(n <= 0) return;
+            pos += static_cast<size_t>(n);
+        }
+    }
+
+    void serve(Socket client) {
+        // 요청 줄만 보면 됨. 헤더 끝까지 읽되 느린 클라이언트는 1초에 끊음
+        char request[2048];
+        size_t got = 0;
+        while(got < sizeof(request) - 1 && readable(client, 1000)) {
+            int n = recv(client, request + got, static_cast<int>(sizeof(request) - 1 - got), 0);
+            if(n <= 0) break;
+            got += static_cast<size_t>(n);
+            request[got] = '\0';
+            if(strstr(request, "\r\n\r\n")) break;
+        }
+        request[got] = '\0';
+
+        std::string body, status = "200 OK";
+        if(strncmp(request, "GET /metrics", 12) == 0 || strncmp(request, "GET / ", 6) == 0) {
+            body = registry->render();
+            scrapes.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            status = "404 Not Found";
+            body = "try /metrics\n";
+        }
+        std::string head = "HTTP/1.1 " + status +
+                           "\r\nContent-Type: text/plain; version=0.0.4\r\nConnection: close\r\nContent-Length: " +
+                           std::to_string(body.size()) + "\r\n\r\n";
+        sendAll(client, head + body);
+        closeSocket(client);
+    }
+
+    void loop() {
+        while(!stopping.load()) {
+            if(!readable(listener, 200)) continue;
+            Socket client = accept(listener, nullptr, nullptr);
+            if(client == NO_SOCKET) continue;
+            serve(client);
+        }
+    }
+
+public:
+    std::atomic<std::uint64_t> scrapes{0};
+
+    HttpExporter() = default;
+    HttpExporter(const HttpExporter&) = delete;
+    HttpExporter& operator=(const HttpExporter&) = delete;
+    ~HttpExporter() { stop(); }
+
+    bool start(const Registry& reg, int port) {
+#ifdef _WIN32
+        WSADATA wsa;
+        if(WSAStartup(MAKEWORD(2, 2), &wsa) != 0) return false;
+#endif
+        registry = &reg;
+        listener = socket(AF_INET, SOCK_STREAM, 0);
+        if(listener == NO_SOCKET) return false;
+        int one = 1;
+        setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&one), sizeof(one));
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(static_cast<std::uint16_t>(port));
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);   // 로컬에서만 (캐비닛 안의 수집기가 긁음)
+        if(bind(listener, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || listen(listener, 8) != 0) {
+            closeSocket(listener);
+            listener = NO_SOCKET;
+            return false;
+        }
+        stopping = false;
+        thread = std::thread([this] { loop(); });
+        return true;
+    }
+
+    void stop() {
+        if(!thread.joinable()) return;
+        stopping = true;
+        thread.join();
+        closeSocket(listener);
+        listener = NO_SOCKET;
+#ifdef _WIN32
+        WSACleanup();
+#endif
+    }
+
+    bool running() const { return thread.joinable(); }
+};
+
+// 프로세스 전체 operator new 호출 수. 이 카운터를 올리는 operator new는 실행 파일 하나에서만 정의 (main.cpp)
+inline Counter& allocations() {
+    static Counter counter;
+    return counter;
+}
+
+} // namespace metrics
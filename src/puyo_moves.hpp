@@ -0,0 +1,174 @@
+#pragma once
+// ---- 합법 배치 생성기 (봇, 힌트, 리플레이 검증 공용) ----
+// 현재 조각 위치에서 (x, y, 방향) 상태를 BFS로 탐색. 한 번의 입력(좌, 우, 회전, 회전 반대, 한 칸 낙하)이
+// 간선이고, 이동/회전은 게임과 같은 canMove, tryRotate(벽 차기 포함)를 그대로 씀.
+// 더 내려갈 수 없는 상태가 최종 배치이고, BFS 경로가 그 배치까지의 최소 입력 열.
+// 중력 시간은 무시함 (입력이 낙하보다 빠르다고 가정)
+//
+// 결과는 보드 점유(색 무관)와 시작 상태로 캐시. 정리된 보드에서는 점유 = 열 높이
+#include <cstdint>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+#include "puyo_core.hpp"
+
+namespace moves {
+
+enum Input : std::uint8_t { IN_LEFT, IN_RIGHT, IN_CW, IN_CCW, IN_DOWN, INPUT_COUNT };
+
+static const int NUM_STATES = ROWS * COLS * NUM_ORIENTATIONS;
+static const size_t CACHE_LIMIT = 1 << 14;   // 넘으면 캐시를 비움
+
+struct Placement {
+    std::int8_t x, y;                // 축 위치
+    std::uint8_t orientation;        // orientationOffset 번호
+    std::uint8_t inputCount;
+    std::uint16_t inputStart;        // MoveList::inputs 안의 위치
+};
+
+struct MoveList {
+    std::vector<Placement> placements;
+    std::vector<Input> inputs;
+
+    const Input* inputsOf(const Placement& p) const { return inputs.data() + p.inputStart; }
+};
+
+inline int orientationIndex(const Vec2& sub) {
+    for(int o = 0; o < NUM_ORIENTATIONS; o++) {
+        Vec2 v = orientationOffset(o);
+        if(v.x == sub.x && v.y == sub.y) return o;
+    }
+    return 0;
+}
+
+inline int stateIndex(const PuyoPair& p) {
+    return (p.pivot.y * COLS + p.pivot.x) * NUM_ORIENTATIONS + orientationIndex(p.sub);
+}
+
+// 입력 하나를 게임 규칙대로 적용. 움직이지 못하면 false
+inline bool applyInput(const BoardCore& b, PuyoPair& p, Input in) {
+    switch(in) {
+    case IN_LEFT:  if(!canMove(b, p, -1, 0)) return false; p.pivot.x--; return true;
+    case IN_RIGHT: if(!canMove(b, p, +1, 0)) return false; p.pivot.x++; return true;
+    case IN_CW:    return tryRotate(b, p, true);
+    case IN_CCW:   return tryRotate(b, p, false);
+    case IN_DOWN:  if(!canMove(b, p, 0, +1)) return false; p.pivot.y++; return true;
+    default:       return false;
+    }
+}
+
+// 배치를 조각에 적용한 결과 (색은 base 그대로)
+inline PuyoPair placedPair(const PuyoPair& base, const Placement& m) {
+    PuyoPair p = base;
+    p.pivot = { m.x, m.y };
+    p.sub = orientationOffset(m.orientation);
+    return p;
+}
+
+// 캐시 없이 한 번 탐색
+inline void generate(const BoardCore& b, const PuyoPair& start, MoveList& out) {
+    out.placements.clear();
+    out.inputs.clear();
+    std::int16_t parent[NUM_STATES];
+    Input via[NUM_STATES];
+    PuyoPair queue[NUM_STATES];
+    std::memset(parent, -1, sizeof(parent));
+
+    // 시작 상태는 스폰 위치처럼 겹쳐 있을 수 있음 (sub가 화면 위) - 그대로 출발점으로 씀
+    if(!inBounds(start.pivot.x, start.pivot.y)) return;
+    int head = 0, tail = 0;
+    int startIndex = stateIndex(start);
+    parent[startIndex] = static_cast<std::int16_t>(startIndex);
+    queue[tail++] = start;
+
+    Input path[NUM_STATES];
+    while(head < tail) {
+        const PuyoPair cur = queue[head++];
+        int curIndex = stateIndex(cur);
+        for(int i = 0; i < INPUT_COUNT; i++) {
+            PuyoPair next = cur;
+            if(!applyInput(b, next, static_cast<Input>(i))) continue;
+            int nextIndex = stateIndex(next);
+            if(parent[nextIndex] >= 0) continue;
+            parent[nextIndex] = static_cast<std::int16_t>(curIndex);
+            via[nextIndex] = static_cast<Input>(i);
+            queue[tail++] = next;
+        }
+
+        if(canMove(b, cur, 0, +1)) continue;
+        // 더 내려갈 수 없음 = 최종 배치. 부모를 따라 입력 열을 거꾸로 모음
+        int n = 0;
+        for(int s = curIndex; s != startIndex; s = parent[s]) path[n++] = via[s];
+        Placement m;
+        m.x = static_cast<std::int8_t>(cur.pivot.x);
+        m.y = static_cast<std::int8_t>(cur.pivot.y);
+        m.orientation = static_cast<std::uint8_t>(orientationIndex(cur.sub));
+        m.inputCount = static_cast<std::uint8_t>(n);
+        m.inputStart = static_cast<std::uint16_t>(out.inputs.size());
+        for(int k = n - 1; k >= 0; k--) out.inputs.push_back(path[k]);
+        out.placements.push_back(m);
+    }
+}
+
+// 점유 + 시작 상태로 캐시하는 생성기 (스레드마다 하나씩)
+class MoveGenerator {
+private:
+    struct Key {
+        std::uint64_t lo, hi;
+        bool operator==(const Key& o) const { return lo == o.lo && hi == o.hi; }
+    };
+    struct KeyHash {
+        size_t operator()(const Key& k) const {
+            std::uint64_t h = k.lo * 0x9E3779B97F4A7C15ull ^ (k.hi + 0x632BE59BD9B4E019ull + (k.lo >> 29));
+            return static_cast<size_t>(h ^ (h >> 32));
+        }
+    };
+
+    std::unordered_map<Key, MoveList, KeyHash> cache;
+
+    static Key keyOf(const BoardCore& b, const PuyoPair& start) {
+        // 72칸 점유 비트: 앞 64칸은 lo, 나머지 8칸 + 시작 상태는 hi
+        Key k{0, 0};
+        int bit = 0;
+        for(int y = 0; y < ROWS; y++)
+            for(int x = 0; x < COLS; x++, bit++) {
+                if(b.g[y][x] == EMPTY) continue;
+                if(bit < 64) k.lo |= 1ull << bit;
+                else k.hi |= 1ull << (bit - 64);
+            }
+        k.hi |= static_cast<std::uint64_t>(stateIndex(start) + 1) << 16;
+        return k;
+    }
+
+public:
+    std::uint64_t hits = 0, misses = 0;
+
+    const MoveList& legalMoves(const BoardCore& b, const PuyoPair& start) {
+        Key k = keyOf(b, start);
+        auto it = cache.find(k);
+        if(it != cache.end()) {
+            hits++;
+            return it->second;
+        }
+        misses++;
+        if(cache.size() >= CACHE_LIMIT) cache.clear();
+        MoveList& list = cache[k];
+        generate(b, start, list);
+        return list;
+    }
+
+    // 최종 위치 p가 시작 상태에서 도달 가능한 배치인지 (리플레이 검증용)
+    const Placement* find(const BoardCore& b, const PuyoPair& start, const PuyoPair& p) {
+        const MoveList& list = legalMoves(b, start);
+        int o = orientationIndex(p.sub);
+        for(const Placement& m : list.placements)
+            if(m.x == p.pivot.x && m.y == p.pivot.y && m.orientation == o) return &m;
+        return nullptr;
+    }
+
+    void clear() { cache.clear(); }
+    size_t size() const { return cache.size(); }
+};
+
+} // namespace moves
@@ -0,0 +1,179 @@
+#pragma once
+// ---- 대전 서버 프로토콜 (서버, 부하 클라이언트, 외부 봇 공용) ----
+// 프레임 = u16 페이로드 길이 + u8 종류 + 페이로드 (모두 리틀 엔디언)
+//
+// 클라이언트 -> 서버
+//   HELLO  u8 상대(0: 서버 봇, 1: 다른 클라이언트) u8 조작(0: 배치, 1: 입력)
+//   PLACE  u32 조각 번호, u8 배치(방향 * COLS + 열)   - 조작 0일 때만
+//   INPUT  u8 버튼 비트 (다음 틱에 적용)              - 조작 1일 때만
+//   PING   u64 클라이언트 시각
+// 서버 -> 클라이언트
+//   START  u32 대전 번호, u32 시드, u8 내 자리, u16 틱/초
+//   DELTA  u32 틱, u8 자리, u32 점수, u8 연쇄, u32 조각 번호, 조각(x, y, 방향, 색1, 색2),
+//          u8 n, n * u16(칸 번호 << 3 | 색)   - 지난 DELTA 이후 바뀐 칸만
+//   END    u32 대전 번호, u8 승자(0, 1, 2=무승부), u32 점수0, u32 점수1, u32 틱
+//   PONG   u64 클라이언트 시각 (그대로 돌려줌)
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "puyo_core.hpp"
+
+namespace net {
+
+static const int FRAME_HEADER = 3;
+static const int MAX_PAYLOAD = 256;
+
+enum MessageType : std::uint8_t {
+    MSG_HELLO = 1,
+    MSG_PLACE = 2,
+    MSG_INPUT = 3,
+    MSG_PING = 4,
+    MSG_START = 16,
+    MSG_DELTA = 17,
+    MSG_END = 18,
+    MSG_PONG = 19,
+};
+
+enum InputBits : std::uint8_t {
+    BTN_LEFT = 1,
+    BTN_RIGHT = 2,
+    BTN_ROTATE_CW = 4,
+    BTN_ROTATE_CCW = 8,
+    BTN_SOFT_DROP = 16,
+};
+
+// 페이로드 작성기: begin()으로 헤더 자리를 잡고 end()에서 길이를 채움
+struct FrameWriter {
+    std::vector<std::uint8_t>& out;
+    size_t start = 0;
+
+    explicit FrameWriter(std::vector<std::uint8_t>& o) : out(o) {}
+
+    FrameWriter& begin(MessageType type) {
+        start = out.size();
+        out.resize(start + FRAME_HEADER);
+        out[start + 2] = type;
+        return *this;
+    }
+
+    template<class T>
+    FrameWriter& put(T v) {
+        size_t at = out.size();
+        out.resize(at + sizeof(T));
+        std::memcpy(out.data() + at, &v, sizeof(T));
+        return *this;
+    }
+
+    void end() {
+        std::uint16_t len = static_cast<std::uint16_t>(out.size() - start - FRAME_HEADER);
+        std::memcpy(out.data() + start, &len, 2);
+    }
+};
+
+// 받은 페이로드 읽기 (범위를 넘으면 ok = false, 값은 0)
+struct PayloadReader {
+    const std::uint8_t* p;
+    size_t left;
+    bool ok = true;
+
+    PayloadReader(const std::uint8_t* data, size_t size) : p(data), left(size) {}
+
+    template<class T>
+    T get() {
+        T v{};
+        if(left < sizeof(T)) {
+            ok = false;
+            return v;
+        }
+        std::memcpy(&v, p, sizeof(T));
+        p += sizeof(T);
+        left -= sizeof(T);
+        return v;
+    }
+};
+
+// 버퍼 앞의 완성된 프레임 하나를 꺼냄. 프레임이 덜 왔으면 0, 잘못된 길이면 -1, 아니면 소비한 바이트 수
+inline int nextFrame(const std::uint8_t* data, size_t size, MessageType& type, const std::uint8_t*& payload,
+                     size_t& payloadSize) {
+    if(size < static_cast<size_t>(FRAME_HEADER)) return 0;
+    std::uint16_t len;
+    std::memcpy(&len, data, 2);
+    if(len > MAX_PAYLOAD) return -1;
+    if(size < FRAME_HEADER + static_cast<size_t>(len)) return 0;
+    type = static_cast<MessageType>(data[2]);
+    payload = data + FRAME_HEADER;
+    payloadSize = len;
+    return FRAME_HEADER + len;
+}
+
+// 한 플레이어의 화면 상태 (클라이언트는 DELTA를 받아 같은 상태를 재구성)
+struct PlayerView {
+    std::array<std::array<Color, COLS>, ROWS> g{};
+    std::uint32_t score = 0;
+    std::uint8_t chain = 0;
+    std::uint32_t pieceIndex = 0;
+    std::int8_t px = 0, py = 0;
+    std::uint8_t orientation = 0;
+    Color c1 = EMPTY, c2 = EMPTY;
+
+    bool samePiece(const PlayerView& o) const {
+        return pieceIndex == o.pieceIndex && px == o.px && py == o.py && orientation == o.orientation &&
+               c1 == o.c1 && c2 == o.c2;
+    }
+};
+
+// sent 대비 바뀐 것이 있으면 DELTA 프레임을 쓰고 sent를 갱신. 바뀐 게 없으면 false
+inline bool writeDelta(std::vector<std::uint8_t>& out, std::uint32_t tick, std::uint8_t slot, const PlayerView& now,
+                       PlayerView& sent) {
+    std::uint16_t changed[ROWS * COLS];
+    int n = 0;
+    for(int y = 0; y < ROWS; y++)
+        for(int x = 0; x < COLS; x++)
+            if(now.g[y][x] != sent.g[y][x]) changed[n++] = static_cast<std::uint16_t>((y * COLS + x) << 3 | now.g[y][x]);
+    if(n == 0 && now.score == sent.score && now.chain == sent.chain && now.samePiece(sent)) return false;
+
+    FrameWriter w(out);
+    w.begin(MSG_DELTA).put(tick).put(slot).put(now.score).put(now.chain).put(now.pieceIndex)
+     .put(now.px).put(now.py).put(now.orientation).put(static_cast<std::uint8_t>(now.c1))
+     .put(static_cast<std::uint8_t>(now.c2)).put(static_cast<std::uint8_t>(n));
+    for(int i = 0; i < n; i++) w.put(changed[i]);
+    w.end();
+    sent = now;
+    return true;
+}
+
+// DELTA 페이로드를 view에 적용 (자리 번호는 slot으로 반환)
+inline bool applyDelta(const std::uint8_t* payload, size_t size, std::uint32_t& tick, std::uint8_t& slot,
+                       PlayerView& view) {
+    PayloadReader r(payload, size);
+    tick = r.get<std::uint32_t>();
+    slot = r.get<std::uint8_t>();
+    view.score = r.get<std::uint32_t>();
+    view.chain = r.get<std::uint8_t>();
+    view.pieceIndex = r.get<std::uint32_t>();
+    view.px = r.get<std::int8_t>();
+    view.py = r.get<std::int8_t>();
+    view.orientation = r.get<std::uint8_t>();
+    view.c1 = static_cast<Color>(r.get<std::uint8_t>() % COLOR_COUNT);
+    view.c2 = static_cast<Color>(r.get<std::uint8_t>() % COLOR_COUNT);
+    int n = r.get<std::uint8_t>();
+    for(int i = 0; i < n && r.ok; i++) {
+        std::uint16_t v = r.get<std::uint16_t>();
+        int cell = v >> 3;
+        if(cell >= ROWS * COLS) return false;
+        view.g[cell / COLS][cell % COLS] = static_cast<Color>((v & 7) % COLOR_COUNT);
+    }
+    return r.ok;
+}
+
+// sub 오프셋 -> 방향 번호 (orientationOffset의 역)
+inline std::uint8_t orientationOf(const Vec2& sub) {
+    for(int o = 0; o < NUM_ORIENTATIONS; o++) {
+        Vec2 v = orientationOffset(o);
+        if(v.x == sub.x && v.y == sub.y) return static_cast<std::uint8_t>(o);
+    }
+    return 0;
+}
+
+} // namespace net
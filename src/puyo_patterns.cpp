@@ -0,0 +1,388 @@
+// ---- 패턴 라이브러리 빌더 ----
+// 색을 추상화한 템플릿(a, b, c...)을 모든 위치/좌우 반전으로 놓고, 아래에서부터 쌓아 가는
+// 모든 중간 단계(열마다 아래쪽 일부)를 정규 서명으로 색인. 두 템플릿을 나란히 놓는 조합도 추가
+//
+//   ./puyo_patterns --out=patterns.bin [--templates=my_forms.txt] [--no-combos]
+//   ./puyo_patterns --self-test      (손으로 만든 깨진 항목이 든 파일로 조회가 안전한지 확인)
+//
+// 템플릿 파일 형식: 한 줄에 "이름 위행/.../아래행"  예) gtr a../bba/baa
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "puyo_patterns.hpp"
+
+using namespace std;
+
+struct Template {
+    string name;
+    vector<string> rows;   // 위 -> 아래
+};
+
+// 기본 정석 (모두 트리거 하나로 2~3연쇄가 나는 모양)
+static const Template BUILTIN_TEMPLATES[] = {
+    {"gtr",      {"a..", "bba", "baa"}},
+    {"stairs",   {".ab", "abc", "abc", "abc"}},
+    {"sandwich", {".ab", "aba", "aba", "aba"}},
+    {"layered",  {".bc", "acc", "bbb", "aaa"}},
+};
+
+// 열 단위 표현: cols[x] = 아래에서부터의 라벨 (1부터)
+struct Form {
+    int width = 0;
+    vector<vector<int>> cols;
+    int labels = 0;
+    int cells = 0;
+};
+
+bool toForm(const Template& t, bool mirror, Form& f) {
+    f = Form();
+    for(auto& r : t.rows) f.width = max(f.width, static_cast<int>(r.size()));
+    if(f.width == 0 || f.width > COLS || static_cast<int>(t.rows.size()) > ROWS - 2) return false;
+    f.cols.assign(f.width, {});
+    for(int x = 0; x < f.width; x++) {
+        int srcX = mirror ? f.width - 1 - x : x;
+        bool gap = false;
+        for(int r = static_cast<int>(t.rows.size()) - 1; r >= 0; r--) {
+            char ch = srcX < static_cast<int>(t.rows[r].size()) ? t.rows[r][srcX] : '.';
+            if(ch == '.') {
+                gap = true;
+                continue;
+            }
+            if(gap) return false;  // 떠 있는 칸은 허용하지 않음 (잘라 내지 않고 템플릿을 거절)
+            if(ch < 'a' || ch >= 'a' + COLOR_COUNT - 1) return false;
+            f.cols[x].push_back(ch - 'a' + 1);
+            f.labels = max(f.labels, ch - 'a' + 1);
+            f.cells++;
+        }
+    }
+    return f.cells > 0;
+}
+
+// heights[x]만큼 아래에서부터 채움. colorOf: 라벨 -> 실제 색
+void placeForm(chain::Grid& g, const Form& f, int offset, const vector<int>& heights, const int* colorOf) {
+    for(int x = 0; x < f.width; x++)
+        for(int i = 0; i < heights[x]; i++)
+            g[ROWS - 1 - i][offset + x] = static_cast<Color>(colorOf[f.cols[x][i]]);
+}
+
+bool stable(const chain::Grid& g) {
+    chain::Grid copy = g;
+    return chain::resolve(copy, nullptr, 0, 0, 1).chain == 0;
+}
+
+int formChain(const chain::Grid& g) {
+    int best = 0;
+    for(int k = 1; k <= chain::MAX_EXTRA; k++) best = max(best, chain::maxTriggerChain(g, k));
+    return best;
+}
+
+// 열마다 0..높이를 고르는 모든 조합 (heights를 갱신, 다 돌면 false)
+bool nextPrefix(vector<int>& heights, const Form& f) {
+    for(int x = 0; x < f.width; x++) {
+        if(heights[x] < static_cast<int>(f.cols[x].size())) {
+            heights[x]++;
+            return true;
+        }
+        heights[x] = 0;
+    }
+    return false;
+}
+
+struct Builder {
+    unordered_map<uint64_t, patterns::Entry> entries;
+    vector<string> names;
+    uint64_t generated = 0;
+
+    int addName(const string& name) {
+        names.push_back(name.substr(0, patterns::NAME_SIZE - 1));
+        return static_cast<int>(names.size()) - 1;
+    }
+
+    // 같은 키면 가치(완성도 * 연쇄)가 큰 쪽을 남김
+    void add(const chain::Grid& g, int offset, int width, int templateId, int filled, int total, int chainCount) {
+        uint64_t key = patterns::windowKey(g, offset, width);
+        if(key == 0) return;
+        generated++;
+        patterns::Entry e{key, static_cast<uint16_t>(templateId), static_cast<uint8_t>(filled),
+                          static_cast<uint8_t>(total), static_cast<uint8_t>(chainCount),
+                          static_cast<uint8_t>(width), static_cast<uint8_t>(offset), 0};
+        auto it = entries.find(key);
+        if(it == entries.end()) {
+            entries.emplace(key, e);
+        } else if(e.chain * e.filled * it->second.total > it->second.chain * it->second.filled * e.total) {
+            it->second = e;
+        }
+    }
+
+    // 템플릿 하나: 위치/반전마다 모든 중간 단계를 그 열 구간의 키로 등록
+    void addSingle(const Template& t, int id) {
+        static const int identity[COLOR_COUNT] = {0, 1, 2, 3, 4, 5};
+        for(int mirror = 0; mirror < 2; mirror++) {
+            Form f;
+            if(!toForm(t, mirror == 1, f)) continue;
+            chain::Grid full{};
+            vector<int> fullHeights(f.width);
+            for(int x = 0; x < f.width; x++) fullHeights[x] = static_cast<int>(f.cols[x].size());
+            placeForm(full, f, 0, fullHeights, identity);
+            int chainCount = formChain(full);
+
+            for(int offset = 0; offset + f.width <= COLS; offset++) {
+                vector<int> heights(f.width, 0);
+                while(nextPrefix(heights, f)) {
+                    chain::Grid g{};
+                    placeForm(g, f, offset, heights, identity);
+                    int filled = 0;
+                    for(int h : heights) filled += h;
+                    add(g, offset, f.width, id, filled, f.cells, chainCount);
+                }
+            }
+        }
+    }
+
+    // 두 템플릿을 나란히: 한쪽은 완성, 다른 쪽은 쌓는 중. 키는 보드 전체 구간
+    void addCombo(const Template& left, const Template& right, int id) {
+        for(int mirror = 0; mirror < 4; mirror++) {
+            Form fl, fr;
+            if(!toForm(left, mirror & 1, fl) || !toForm(right, (mirror >> 1) & 1, fr)) continue;
+            if(fl.width + fr.width > COLS) continue;
+
+            vector<int> fullL(fl.width), fullR(fr.width);
+            for(int x = 0; x < fl.width; x++) fullL[x] = static_cast<int>(fl.cols[x].size());
+            for(int x = 0; x < fr.width; x++) fullR[x] = static_cast<int>(fr.cols[x].size());
+
+            int leftColors[COLOR_COUNT] = {0, 1, 2, 3, 4, 5};
+            // 오른쪽 라벨 -> 실제 색의 모든 단사 대응
+            vector<int> palette = {1, 2, 3, 4, 5};
+            vector<vector<int>> mappings;
+            vector<int> pick(fr.labels + 1, 0);
+            function<void(int, unsigned)> enumerate = [&](int label, unsigned used) {
+                if(label > fr.labels) { mappings.push_back(pick); return; }
+                for(int c : palette) {
+                    if(used & (1u << c)) continue;
+                    pick[label] = c;
+                    enumerate(label + 1, used | (1u << c));
+                }
+            };
+            enumerate(1, 0);
+
+            for(int rightOffset = fl.width; rightOffset + fr.width <= COLS; rightOffset++) {
+                for(auto& mapping : mappings) {
+                    chain::Grid full{};
+                    placeForm(full, fl, 0, fullL, leftColors);
+                    placeForm(full, fr, rightOffset, fullR, mapping.data());
+                    if(!stable(full)) continue;
+                    int chainCount = formChain(full);
+                    int total = fl.cells + fr.cells;
+
+                    // 왼쪽 완성 + 오른쪽 쌓는 중
+                    vector<int> heights(fr.width, 0);
+                    while(nextPrefix(heights, fr)) {
+                        chain::Grid g{};
+                        placeForm(g, fl, 0, fullL, leftColors);
+                        placeForm(g, fr, rightOffset, heights, mapping.data());
+                        if(!stable(g)) continue;
+                        int filled = fl.cells;
+                        for(int h : heights) filled += h;
+                        add(g, 0, COLS, id, filled, total, chainCount);
+                    }
+                    // 오른쪽 완성 + 왼쪽 쌓는 중
+                    heights.assign(fl.width, 0);
+                    while(nextPrefix(heights, fl)) {
+                        chain::Grid g{};
+                        placeForm(g, fl, 0, heights, leftColors);
+                        placeForm(g, fr, rightOffset, fullR, mapping.data());
+                        if(!stable(g)) continue;
+                        int filled = fr.cells;
+                        for(int h : heights) filled += h;
+                        add(g, 0, COLS, id, filled, total, chainCount);
+                    }
+                }
+            }
+        }
+    }
+
+    bool write(const string& path) const {
+        int slotBits = 4;
+        while((1ull << slotBits) < entries.size() * 2) slotBits++;   // 적재율 50% 이하
+        uint64_t slotCount = 1ull << slotBits;
+        vector<patterns::Entry> slots(slotCount, patterns::Entry{0, 0, 0, 0, 0, 0, 0, 0});
+        uint64_t mask = slotCount - 1;
+        uint32_t widthMask = 0;
+        for(auto& kv : entries) {
+            uint64_t i = kv.first & mask;
+            while(slots[i].key != 0) i = (i + 1) & mask;
+            slots[i] = kv.second;
+            widthMask |= 1u << kv.second.width;
+        }
+
+        uint32_t nameOffset = patterns::HEADER_SIZE;
+        uint64_t slotsOffset = nameOffset + static_cast<uint64_t>(names.size()) * patterns::NAME_SIZE;
+        slotsOffset = (slotsOffset + 63) & ~uint64_t(63);
+
+        vector<uint8_t> head(slotsOffset, 0);
+        memcpy(head.data(), patterns::MAGIC, sizeof(patterns::MAGIC));
+        uint32_t version = patterns::VERSION, bits = static_cast<uint32_t>(slotBits);
+        uint64_t count = entries.size();
+        uint32_t templateCount = static_cast<uint32_t>(names.size());
+        memcpy(head.data() + 8, &version, 4);
+        memcpy(head.data() + 12, &bits, 4);
+        memcpy(head.data() + 16, &count, 8);
+        memcpy(head.data() + 24, &templateCount, 4);
+        memcpy(head.data() + 28, &nameOffset, 4);
+        memcpy(head.data() + 32, &slotsOffset, 8);
+        memcpy(head.data() + 40, &widthMask, 4);
+        for(size_t i = 0; i < names.size(); i++) {
+            memcpy(head.data() + nameOffset + i * patterns::NAME_SIZE, names[i].c_str(), names[i].size());
+        }
+
+        FILE* fp = fopen(path.c_str(), "wb");
+        if(!fp) return false;
+        bool ok = fwrite(head.data(), 1, head.size(), fp) == head.size() &&
+                  fwrite(slots.data(), sizeof(patterns::Entry), slots.size(), fp) == slots.size();
+        return fclose(fp) == 0 && ok;
+    }
+};
+
+bool loadTemplates(const string& path, vector<Template>& out) {
+    FILE* fp = fopen(path.c_str(), "r");
+    if(!fp) return false;
+    char name[64], shape[256];
+    while(fscanf(fp, "%63s %255s", name, shape) == 2) {
+        if(name[0] == '#') continue;
+        Template t;
+        t.name = name;
+        string s = shape;
+        size_t start = 0;
+        while(start <= s.size()) {
+            size_t slash = s.find('/', start);
+            if(slash == string::npos) slash = s.size();
+            t.rows.push_back(s.substr(start, slash - start));
+            start = slash + 1;
+        }
+        out.push_back(t);
+    }
+    fclose(fp);
+    return true;
+}
+
+// 완성형 칸 수가 0이거나 놓인 칸이 더 많은 항목은 건너뛰고, 정상 항목만 일치해야 함
+int selfTest(const string& path) {
+    auto column = [](int height) {
+        chain::Grid g{};
+        for(int i = 0; i < height; i++) g[ROWS - 1 - i][0] = i % 2 ? BLUE : RED;
+        return g;
+    };
+    Builder builder;
+    int id = builder.addName("self-test");
+    builder.add(column(1), 0, 1, id, 1, 0, 2);   // total 0
+    builder.add(column(2), 0, 1, id, 5, 3, 2);   // filled > total
+    builder.add(column(3), 0, 1, id, 2, 4, 2);   // 정상: 가치 2 * 2 / 4 = 1
+    if(!builder.write(path)) {
+        fprintf(stderr, "cannot write %s\n", path.c_str());
+        return 1;
+    }
+    patterns::PatternLibrary lib;
+    bool opened = lib.open(path);
+    int failures = opened ? 0 : 1;
+    for(int height = 1; opened && height <= 3; height++) {
+        float value = -1.0f;
+        const patterns::Entry* e = lib.bestMatch(column(height), &value);
+        bool expectMatch = height == 3;
+        bool ok = std::isfinite(value) && (e != nullptr) == expectMatch && value == (expectMatch ? 1.0f : 0.0f);
+        printf("column %d: %s, value %g -> %s\n", height, e ? "match" : "no match", value, ok ? "ok" : "FAIL");
+        if(!ok) failures++;
+    }
+    remove(path.c_str());
+    printf("self-test %s\n", failures == 0 ? "passed" : "FAILED");
+    return failures == 0 ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+    string outPath = "patterns.bin";
+    string templatePath;
+    bool combos = true;
+    bool runSelfTest = false;
+    for(int i = 1; i < argc; i++) {
+        if(strncmp(argv[i], "--out=", 6) == 0) outPath = argv[i] + 6;
+        else if(strncmp(argv[i], "--templates=", 12) == 0) templatePath = argv[i] + 12;
+        else if(strcmp(argv[i], "--no-combos") == 0) combos = false;
+        else if(strcmp(argv[i], "--self-test") == 0) runSelfTest = true;
+        else {
+            fprintf(stderr, "usage: %s [--out=FILE] [--templates=FILE] [--no-combos]\n"
+                            "       %s --self-test [--out=FILE]\n", argv[0], argv[0]);
+            return 2;
+        }
+    }
+    if(runSelfTest) return selfTest(outPath + ".selftest");
+
+    vector<Template> templates(begin(BUILTIN_TEMPLATES), end(BUILTIN_TEMPLATES));
+    if(!templatePath.empty() && !loadTemplates(templatePath, templates)) {
+        fprintf(stderr, "cannot read templates: %s\n", templatePath.c_str());
+        return 1;
+    }
+
+    auto start = chrono::steady_clock::now();
+    Builder builder;
+    for(auto& t : templates) builder.addSingle(t, builder.addName(t.name));
+    if(combos) {
+        for(auto& left : templates)
+            for(auto& right : templates)
+                builder.addCombo(left, right, builder.addName(left.name + "+" + right.name));
+    }
+    if(!builder.write(outPath)) {
+        fprintf(stderr, "cannot write %s\n", outPath.c_str());
+        return 1;
+    }
+    double buildSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    // 다시 열어 모든 항목이 조회되는지 확인하고 조회 비용 측정
+    auto openStart = chrono::steady_clock::now();
+    patterns::PatternLibrary lib;
+    if(!lib.open(outPath)) {
+        fprintf(stderr, "written library does not open: %s\n", outPath.c_str());
+        return 1;
+    }
+    double openMicros = chrono::duration<double, micro>(chrono::steady_clock::now() - openStart).count();
+    uint64_t missing = 0;
+    for(auto& kv : builder.entries) {
+        if(!lib.find(kv.first)) missing++;
+    }
+
+    mt19937 gen(1);
+    vector<chain::Grid> boards(256);
+    for(auto& g : boards) {
+        BoardCore b;
+        PuyoRng rng(gen());
+        for(int m = 0; m < 12; m++) {
+            PuyoPair p = makeSpawnPair(rng);
+            dropPlacement(b, p, gen() % NUM_ORIENTATIONS, gen() % COLS);
+            b.resolveChains();
+        }
+        g = b.g;
+    }
+    auto lookStart = chrono::steady_clock::now();
+    uint64_t hits = 0, lookups = 0;
+    for(int round = 0; round < 200; round++) {
+        for(auto& g : boards) {
+            float v;
+            if(lib.bestMatch(g, &v)) hits++;
+            lookups++;
+        }
+    }
+    double lookNanos = chrono::duration<double, nano>(chrono::steady_clock::now() - lookStart).count() / lookups;
+
+    printf("%zu templates, %llu prefixes -> %llu unique entries, %s (%.2fs)\n", builder.names.size(),
+           (unsigned long long)builder.generated, (unsigned long long)lib.size(), outPath.c_str(), buildSeconds);
+    printf("open %.1fus, %llu missing, bestMatch %.0f ns/board (%llu/%llu random boards matched)\n", openMicros,
+           (unsigned long long)missing, lookNanos, (unsigned long long)hits, (unsigned long long)lookups);
+    return missing == 0 ? 0 : 1;
+}
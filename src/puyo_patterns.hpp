@@ -0,0 +1,181 @@
+#pragma once
+// ---- 연쇄 형태 패턴 라이브러리 (정석 DB) ----
+// 색을 무시한 정규 서명으로 색인한 오픈 어드레싱 테이블을 파일째 메모리 맵으로 열어 그대로 조회.
+// 키 = (열 구간의 내용을 등장 순서로 색 번호를 다시 매긴 것, 구간 시작 열, 구간 너비)
+//
+// 파일 = 64바이트 헤더 + 템플릿 이름(32바이트씩) + 슬롯(16바이트씩, 2의 거듭제곱 개)
+#include <cstring>
+#include <string>
+
+#include "puyo_core.hpp"
+#include "puyo_chain.hpp"
+#include "mapped_file.hpp"
+
+namespace patterns {
+
+static const char MAGIC[8] = {'P','U','Y','O','P','A','T','1'};
+static const std::uint32_t VERSION = 1;
+static const int HEADER_SIZE = 64;
+static const int NAME_SIZE = 32;
+
+// 슬롯 하나 (key == 0이면 빈 칸)
+struct Entry {
+    std::uint64_t key;
+    std::uint16_t templateId;
+    std::uint8_t filled;    // 이미 놓인 칸 수
+    std::uint8_t total;     // 완성형의 칸 수
+    std::uint8_t chain;     // 완성형에서 트리거 하나로 나는 연쇄 수
+    std::uint8_t width;
+    std::uint8_t offset;
+    std::uint8_t reserved;
+};
+static_assert(sizeof(Entry) == 16, "pattern slot must stay 16 bytes");
+
+inline std::uint64_t mix64(std::uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+// 구간 [offset, offset + width) 열의 정규 서명. 색은 아래 행부터 왼쪽→오른쪽 순으로
+// 처음 나온 순서대로 1, 2, 3...으로 바꾸므로 색을 바꿔 칠한 같은 모양은 같은 키가 됨.
+// 구간이 비어 있으면 0
+inline std::uint64_t windowKey(const chain::Grid& g, int offset, int width) {
+    std::uint8_t relabel[COLOR_COUNT] = {};
+    std::uint8_t nextLabel = 1;
+    std::uint64_t h = mix64(0x9e3779b97f4a7c15ull ^ (static_cast<std::uint64_t>(offset) << 8) ^ static_cast<std::uint64_t>(width));
+    std::uint64_t word = 0;
+    int bits = 0;
+    bool any = false;
+    for(int y = ROWS - 1; y >= 0; y--) {
+        for(int x = offset; x < offset + width; x++) {
+            Color c = g[y][x];
+            std::uint8_t label = 0;
+            if(c != EMPTY) {
+                if(!relabel[c]) relabel[c] = nextLabel++;
+                label = relabel[c];
+                any = true;
+            }
+            word |= static_cast<std::uint64_t>(label) << bits;
+            bits += 3;
+            if(bits > 60) {
+                h = mix64(h ^ word);
+                word = 0;
+                bits = 0;
+            }
+        }
+    }
+    if(!any) return 0;
+    h = mix64(h ^ word ^ 0x5851f42d4c957f2dull);
+    return h ? h : 1;
+}
+
+class PatternLibrary {
+private:
+    MappedFile file;
+    const Entry* slots = nullptr;
+    std::uint64_t mask = 0;
+    std::uint64_t entries = 0;
+    std::uint32_t templates = 0;
+    std::uint32_t widthMask = 0;   // 라이브러리에 들어 있는 구간 너비 (비트 w)
+    const char* names = nullptr;
+
+public:
+    // 헤더만 확인하고 나머지는 조회할 때 필요한 페이지만 읽힘
+    bool open(const std::string& path) {
+        slots = nullptr;
+        if(!file.open(path, MappedFile::READ_ONLY)) return false;
+        const std::uint8_t* p = file.data();
+        std::uint32_t version, slotBits, nameOffset;
+        std::uint64_t slotsOffset;
+        if(file.size() < static_cast<size_t>(HEADER_SIZE) || std::memcmp(p, MAGIC, sizeof(MAGIC)) != 0) {
+            file.close();
+            return false;
+        }
+        std::memcpy(&version, p + 8, 4);
+        std::memcpy(&slotBits, p + 12, 4);
+        std::memcpy(&entries, p + 16, 8);
+        std::memcpy(&templates, p + 24, 4);
+        std::memcpy(&nameOffset, p + 28, 4);
+        std::memcpy(&slotsOffset, p + 32, 8);
+        std::memcpy(&widthMask, p + 40, 4);
+        std::uint64_t slotCount = 1ull << slotBits;   // 항상 2의 거듭제곱
+        // 적재율은 만들 때 50% 이하: 넘으면 잘리거나 잘못 만든 파일 (빈 칸이 없으면 조회가 멈추지 않음)
+        if(version != VERSION || slotBits > 40 || entries > slotCount / 2 || slotsOffset % alignof(Entry) != 0 ||
+           slotsOffset + slotCount * sizeof(Entry) > file.size() ||
+           nameOffset + static_cast<std::uint64_t>(templates) * NAME_SIZE > file.size()) {
+            file.close();
+            return false;
+        }
+        slots = reinterpret_cast<const Entry*>(p + slotsOffset);
+        names = reinterpret_cast<const char*>(p + nameOffset);
+        mask = slotCount - 1;
+        return true;
+    }
+
+    bool isOpen() const { return slots != nullptr; }
+    std::uint64_t size() const { return entries; }
+    std::uint32_t widths() const { return widthMask; }
+
+    const char* templateName(int id) const {
+        return (names && id >= 0 && static_cast<std::uint32_t>(id) < templates) ? names + id * NAME_SIZE : "?";
+    }
+
+    const Entry* find(std::uint64_t key) const {
+        if(!slots || key == 0) return nullptr;
+        // 헤더의 항목 수가 틀려 빈 칸이 없어도 한 바퀴에서 멈춤
+        std::uint64_t i = key & mask;
+        for(std::uint64_t probes = 0; probes <= mask; probes++, i = (i + 1) & mask) {
+            if(slots[i].key == key) return &slots[i];
+            if(slots[i].key == 0) return nullptr;
+        }
+        return nullptr;
+    }
+
+    // 보드의 모든 구간 중 가장 가치가 큰 일치 (완성도 * 연쇄 수)
+    const Entry* bestMatch(const chain::Grid& g, float* value = nullptr) const {
+        const Entry* best = nullptr;
+        float bestValue = 0.0f;
+        for(int width = 1; width <= COLS; width++) {
+            if(!(widthMask & (1u << width))) continue;
+            for(int offset = 0; offset + width <= COLS; offset++) {
+                const Entry* e = find(windowKey(g, offset, width));
+                // 깨진 파일의 항목 (total 0이면 0으로 나눠 평가값이 inf/NaN이 됨)
+                if(!e || e->total == 0 || e->filled > e->total) continue;
+                float v = e->chain * static_cast<float>(e->filled) / e->total;
+                if(v > bestValue) {
+                    bestValue = v;
+                    best = e;
+                }
+            }
+        }
+        if(value) *value = bestValue;
+        return best;
+    }
+};
+
+// 후보 배치마다 결과 보드를 라이브러리에서 찾아 가장 가치 있는 배치 (일치가 없으면 -1)
+inline int suggestPlacement(const PatternLibrary& lib, const BoardCore& board, const PuyoPair& cur,
+                            const Entry** matched = nullptr) {
+    int bestAction = -1;
+    float bestValue = 0.0f;
+    const Entry* bestEntry = nullptr;
+    for(int action = 0; action < NUM_PLACEMENTS; action++) {
+        if(cur.c1 == cur.c2 && action / COLS >= 2) break;
+        BoardCore trial = board;
+        dropPlacement(trial, cur, action / COLS, action % COLS);
+        if(trial.resolveChains() > 0 || trial.isGameOver()) continue;
+
+        float value = 0.0f;
+        const Entry* e = lib.bestMatch(trial.g, &value);
+        if(e && value > bestValue) {
+            bestValue = value;
+            bestAction = action;
+            bestEntry = e;
+        }
+    }
+    if(matched) *matched = bestEntry;
+    return bestAction;
+}
+
+} // namespace patterns
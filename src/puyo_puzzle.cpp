@@ -0,0 +1,182 @@
+// ---- 나조뿌요 퍼즐 생성기 / 검증기 (헤드리스) ----
+// 생성: 연쇄를 쌓는 봇으로 보드를 만들고 조각 목록을 뽑은 뒤, 전수 탐색으로
+//       최대 연쇄를 구해 그 연쇄의 해답이 하나뿐인 것만 퍼즐로 채택
+//
+//   ./puyo_puzzle --generate --count=50 --pieces=2 --min-chain=3 --threads=8 --out=daily.txt
+//   ./puyo_puzzle --verify=daily.txt
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "puyo_ai.hpp"
+#include "puyo_puzzle.hpp"
+
+using namespace std;
+
+struct PuzzleOptions {
+    bool generate = false;
+    string verifyPath;
+    string outPath = "puzzles.txt";
+    int count = 20;
+    int pieces = 2;
+    int minChain = 3;
+    int minFill = 12;
+    int maxFill = 26;
+    int threads = 0;
+    uint32_t seed = 1;
+};
+
+// 후보 하나 (candidate 번호로 시드를 정하므로 스레드 수와 무관하게 같은 결과)
+bool makeCandidate(const PuzzleOptions& opt, uint64_t candidate, puzzle::Puzzle& out, uint64_t& nodes) {
+    PuyoRng rng(opt.seed * 2654435761u + static_cast<uint32_t>(candidate));
+
+    // 터뜨리지 않고 연쇄 잠재력을 키우는 쪽으로 쌓는 봇
+    ai::EvalWeights builder = ai::EvalWeights::defaults();
+    builder.w[ai::F_SCORE_GAINED] = -50.0f;
+    builder.w[ai::F_CHAIN_POTENTIAL] = 1.5f;
+
+    BoardCore board;
+    uniform_int_distribution<int> fillDist(opt.minFill, opt.maxFill);
+    int fill = fillDist(rng);
+    for(int move = 0; move < fill; move++) {
+        PuyoPair p = makeSpawnPair(rng);
+        int action = ai::choosePlacement(board, p, builder);
+        dropPlacement(board, p, action / COLS, action % COLS);
+        board.resolveChains();
+        if(board.isGameOver()) return false;
+    }
+
+    out = puzzle::Puzzle();
+    out.board = board.g;
+    for(int i = 0; i < opt.pieces; i++) {
+        out.pieces.push_back({randomColor(rng), randomColor(rng)});
+    }
+
+    puzzle::Searcher searcher(out.pieces, 1, 2);
+    int best = searcher.bestChain(out.board, 0);
+    nodes += searcher.nodes;
+    if(best < opt.minChain) return false;
+
+    out.targetChain = best;
+    puzzle::SolveResult solved = puzzle::solve(out, 1);
+    nodes += solved.nodes;
+    if(solved.solutions != 1) return false;
+    out.solution = solved.firstSolution;
+    return true;
+}
+
+int runGenerate(const PuzzleOptions& opt) {
+    int threadCount = opt.threads > 0 ? opt.threads : max(1u, thread::hardware_concurrency());
+    mutex m;
+    vector<pair<uint64_t, puzzle::Puzzle>> accepted;
+    atomic<uint64_t> nextCandidate{0};
+    atomic<int> acceptedCount{0};
+    atomic<uint64_t> totalNodes{0};
+    auto start = chrono::steady_clock::now();
+
+    auto work = [&] {
+        puzzle::Puzzle pz;
+        uint64_t nodes = 0;
+        while(acceptedCount < opt.count) {
+            uint64_t candidate = nextCandidate.fetch_add(1);
+            if(makeCandidate(opt, candidate, pz, nodes)) {
+                lock_guard<mutex> lock(m);
+                accepted.emplace_back(candidate, pz);
+                acceptedCount++;
+            }
+        }
+        totalNodes += nodes;
+    };
+
+    vector<thread> workers;
+    for(int t = 1; t < threadCount; t++) workers.emplace_back(work);
+    work();
+    for(auto& w : workers) w.join();
+
+    // 후보 번호 순으로 앞에서부터 count개 (진행 중이던 후보까지 끝난 뒤라 결과가 결정적)
+    sort(accepted.begin(), accepted.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+    accepted.resize(min<size_t>(accepted.size(), opt.count));
+
+    FILE* fp = fopen(opt.outPath.c_str(), "w");
+    if(!fp) {
+        fprintf(stderr, "[puzzle] cannot write %s\n", opt.outPath.c_str());
+        return 1;
+    }
+    fprintf(fp, "# seed=%u pieces=%d min-chain=%d\n", opt.seed, opt.pieces, opt.minChain);
+    int histogram[20] = {};
+    for(auto& entry : accepted) {
+        fprintf(fp, "%s\n", puzzle::format(entry.second).c_str());
+        histogram[min(entry.second.targetChain, 19)]++;
+    }
+    fclose(fp);
+
+    double elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    printf("%zu puzzles from %llu candidates in %.2fs (%.1f puzzles/min, %llu nodes) -> %s\n", accepted.size(),
+           (unsigned long long)nextCandidate.load(), elapsed, accepted.size() / max(elapsed, 1e-9) * 60.0,
+           (unsigned long long)totalNodes.load(), opt.outPath.c_str());
+    for(int c = 0; c < 20; c++) {
+        if(histogram[c]) printf("  %2d chain: %d\n", c, histogram[c]);
+    }
+    return 0;
+}
+
+// 팩의 모든 퍼즐이 해답이 유일하고 기록된 해답이 맞는지 확인
+int runVerify(const PuzzleOptions& opt) {
+    vector<puzzle::Puzzle> pack;
+    if(!puzzle::loadPack(opt.verifyPath, pack)) {
+        fprintf(stderr, "[puzzle] cannot read %s\n", opt.verifyPath.c_str());
+        return 1;
+    }
+    int threadCount = opt.threads > 0 ? opt.threads : max(1u, thread::hardware_concurrency());
+    int bad = 0;
+    for(size_t i = 0; i < pack.size(); i++) {
+        puzzle::SolveResult r = puzzle::solve(pack[i], threadCount);
+        bool recorded = puzzle::checkSolution(pack[i], pack[i].solution);
+        if(r.solutions != 1 || !recorded) {
+            bad++;
+            printf("#%zu: %d solution(s)%s\n", i, r.solutions, recorded ? "" : ", recorded solution fails");
+        }
+    }
+    printf("%zu puzzles, %d invalid\n", pack.size(), bad);
+    return bad == 0 ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+    PuzzleOptions opt;
+    for(int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        auto value = [&](const char* name) -> const char* {
+            size_t n = strlen(name);
+            return strncmp(arg, name, n) == 0 && arg[n] == '=' ? arg + n + 1 : nullptr;
+        };
+        if(strcmp(arg, "--generate") == 0) opt.generate = true;
+        else if(const char* v = value("--verify")) opt.verifyPath = v;
+        else if(const char* v = value("--out")) opt.outPath = v;
+        else if(const char* v = value("--count")) opt.count = max(1, atoi(v));
+        else if(const char* v = value("--pieces")) opt.pieces = min(max(1, atoi(v)), 6);
+        else if(const char* v = value("--min-chain")) opt.minChain = max(1, atoi(v));
+        else if(const char* v = value("--min-fill")) opt.minFill = max(0, atoi(v));
+        else if(const char* v = value("--max-fill")) opt.maxFill = max(0, atoi(v));
+        else if(const char* v = value("--threads")) opt.threads = atoi(v);
+        else if(const char* v = value("--seed")) opt.seed = static_cast<uint32_t>(strtoul(v, nullptr, 10));
+        else {
+            fprintf(stderr,
+                    "usage: %s --generate [--count=N] [--pieces=N] [--min-chain=N] [--min-fill=N] [--max-fill=N]\n"
+                    "          [--threads=N] [--seed=N] [--out=FILE]\n"
+                    "       %s --verify=FILE [--threads=N]\n", argv[0], argv[0]);
+            return 2;
+        }
+    }
+    opt.maxFill = max(opt.maxFill, opt.minFill);
+
+    if(!opt.verifyPath.empty()) return runVerify(opt);
+    if(opt.generate) return runGenerate(opt);
+    fprintf(stderr, "nothing to do (use --generate or --verify=FILE)\n");
+    return 2;
+}
@@ -0,0 +1,344 @@
+#pragma once
+// ---- 나조뿌요(퍼즐): 포맷, 배치 적용, 전수 탐색 해법기 ----
+// 퍼즐 한 줄 형식:
+//   chain=3 board=<72글자 .RGBYP, 위에서부터 행 우선> pieces=RG,BY solution=3,14
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "puyo_core.hpp"
+#include "puyo_chain.hpp"
+
+namespace puzzle {
+
+struct Piece { Color c1, c2; };
+
+struct Puzzle {
+    chain::Grid board{};
+    std::vector<Piece> pieces;
+    int targetChain = 2;
+    std::vector<int> solution;   // 배치 번호 (orientation * COLS + column)
+};
+
+static const char COLOR_CHARS[] = ".RGBYP";
+
+inline Color colorFromChar(char ch) {
+    const char* p = std::strchr(COLOR_CHARS, ch);
+    return (p && ch) ? static_cast<Color>(p - COLOR_CHARS) : EMPTY;
+}
+
+inline std::string format(const Puzzle& pz) {
+    std::string s = "chain=" + std::to_string(pz.targetChain) + " board=";
+    for(int y = 0; y < ROWS; y++)
+        for(int x = 0; x < COLS; x++)
+            s += COLOR_CHARS[pz.board[y][x]];
+    s += " pieces=";
+    for(size_t i = 0; i < pz.pieces.size(); i++) {
+        if(i) s += ',';
+        s += COLOR_CHARS[pz.pieces[i].c1];
+        s += COLOR_CHARS[pz.pieces[i].c2];
+    }
+    s += " solution=";
+    for(size_t i = 0; i < pz.solution.size(); i++) {
+        if(i) s += ',';
+        s += std::to_string(pz.solution[i]);
+    }
+    return s;
+}
+
+inline bool parse(const std::string& line, Puzzle& pz) {
+    pz = Puzzle();
+    bool hasBoard = false;
+    size_t pos = 0;
+    while(pos < line.size()) {
+        size_t end = line.find(' ', pos);
+        if(end == std::string::npos) end = line.size();
+        std::string token = line.substr(pos, end - pos);
+        pos = end + 1;
+
+        size_t eq = token.find('=');
+        if(eq == std::string::npos) continue;
+        std::string key = token.substr(0, eq);
+        std::string value = token.substr(eq + 1);
+
+        if(key == "chain") {
+            pz.targetChain = std::atoi(value.c_str());
+        } else if(key == "board") {
+            if(value.size() != static_cast<size_t>(ROWS * COLS)) return false;
+            for(int i = 0; i < ROWS * COLS; i++) pz.board[i / COLS][i % COLS] = colorFromChar(value[i]);
+            hasBoard = true;
+        } else if(key == "pieces") {
+            for(size_t i = 0; i + 1 < value.size(); i += 3) {
+                Piece p{colorFromChar(value[i]), colorFromChar(value[i + 1])};
+                if(p.c1 == EMPTY || p.c2 == EMPTY) return false;
+                pz.pieces.push_back(p);
+            }
+        } else if(key == "solution") {
+            for(size_t i = 0; i < value.size();) {
+                pz.solution.push_back(std::atoi(value.c_str() + i));
+                size_t comma = value.find(',', i);
+                if(comma == std::string::npos) break;
+                i = comma + 1;
+            }
+        }
+    }
+    return hasBoard && !pz.pieces.empty() && pz.targetChain > 0;
+}
+
+inline bool loadPack(const std::string& path, std::vector<Puzzle>& out) {
+    FILE* fp = std::fopen(path.c_str(), "r");
+    if(!fp) return false;
+    char buffer[512];
+    Puzzle pz;
+    while(std::fgets(buffer, sizeof(buffer), fp)) {
+        std::string line(buffer);
+        while(!line.empty() && (line.back() == '\n' || line.back() == '\r')) line.pop_back();
+        if(line.empty() || line[0] == '#') continue;
+        if(parse(line, pz)) out.push_back(pz);
+    }
+    std::fclose(fp);
+    return true;
+}
+
+// 게임과 같은 dropPlacement 규칙으로 놓고 연쇄를 끝까지 진행.
+// 놓인 두 칸을 cells에 기록 (같은 결과를 내는 배치를 걸러내는 데 사용)
+struct MoveResult {
+    int chain = 0;
+    bool dead = false;
+    int cells[2] = {-1, -1};   // y * COLS + x, 색은 colors에
+    Color colors[2] = {EMPTY, EMPTY};
+};
+
+inline MoveResult applyPlacement(chain::Grid& g, const Piece& piece, int action) {
+    MoveResult r;
+    BoardCore b;
+    b.g = g;
+    PuyoPair p;
+    p.pivot = { COLS/2, 0 };
+    p.sub = { 0, -1 };
+    p.c1 = piece.c1;
+    p.c2 = piece.c2;
+    PuyoPair placed = dropPlacement(b, p, action / COLS, action % COLS);
+
+    Vec2 seeds[2];
+    int seedCount = 0;
+    Vec2 cells[2] = { placed.pivot, {placed.pivot.x + placed.sub.x, placed.pivot.y + placed.sub.y} };
+    Color colors[2] = { placed.c1, placed.c2 };
+    for(int i = 0; i < 2; i++) {
+        if(!inBounds(cells[i].x, cells[i].y)) continue;
+        r.cells[seedCount] = cells[i].y * COLS + cells[i].x;
+        r.colors[seedCount] = colors[i];
+        seeds[seedCount++] = cells[i];
+    }
+    // 칸 순서를 맞춰 두어 서로 다른 배치가 같은 결과인지 비교하기 쉽게 함
+    if(seedCount == 2 && r.cells[0] > r.cells[1]) {
+        std::swap(r.cells[0], r.cells[1]);
+        std::swap(r.colors[0], r.colors[1]);
+    }
+
+    g = b.g;
+    r.chain = chain::resolve(g, seeds, seedCount, 0, 1).chain;
+    for(int x = 0; x < COLS; x++) {
+        if(g[1][x] != EMPTY) r.dead = true;
+    }
+    return r;
+}
+
+// 같은 최종 위치가 되는 배치를 하나로 묶은 후보 목록.
+// 같은 색 쌍도 네 방향을 모두 시도함: dropPlacement는 회전(벽 차기)과 이동 경로가 방향마다 달라서
+// 벽이나 쌓인 뿌요 옆에서는 아래/왼쪽으로만 닿는 위치가 있음. 대칭인 결과는 아래 중복 검사가 합침
+inline int distinctPlacements(const chain::Grid& g, const Piece& piece, int* actions, MoveResult* results,
+                              chain::Grid* grids) {
+    int count = 0;
+    for(int action = 0; action < NUM_PLACEMENTS; action++) {
+        chain::Grid trial = g;
+        MoveResult r = applyPlacement(trial, piece, action);
+        bool duplicate = false;
+        for(int i = 0; i < count && !duplicate; i++) {
+            duplicate = results[i].cells[0] == r.cells[0] && results[i].cells[1] == r.cells[1] &&
+                        results[i].colors[0] == r.colors[0] && results[i].colors[1] == r.colors[1];
+        }
+        if(duplicate) continue;
+        actions[count] = action;
+        results[count] = r;
+        grids[count] = trial;
+        count++;
+    }
+    return count;
+}
+
+// 메모 키: 해시만으로는 충돌 시 다른 국면의 답을 돌려주므로 보드와 깊이를 통째로 비교
+struct MemoKey {
+    chain::Grid g;
+    int depth;
+    bool operator==(const MemoKey& o) const { return depth == o.depth && g == o.g; }
+};
+
+inline std::uint64_t hashGrid(const chain::Grid& g, int depth) {
+    std::uint64_t h = 1469598103934665603ull ^ static_cast<std::uint64_t>(depth);
+    for(int y = 0; y < ROWS; y++)
+        for(int x = 0; x < COLS; x++)
+            h = (h ^ g[y][x]) * 1099511628211ull;
+    return h ^ (h >> 29);
+}
+
+// 규칙: 모든 조각을 놓아야 하고, 마지막 조각으로 target 이상의 연쇄를 터뜨려야 함.
+// 그 전에 무엇이든 터지거나 1행이 막히면 실패
+
+struct MemoKeyHash {
+    size_t operator()(const MemoKey& k) const { return static_cast<size_t>(hashGrid(k.g, k.depth)); }
+};
+
+// 한 스레드의 탐색기. (보드, 남은 조각 위치)별 결과를 기억해 같은 국면을 다시 풀지 않음
+class Searcher {
+private:
+    const std::vector<Piece>& pieces;
+    int target;
+    int limit;
+    std::unordered_map<MemoKey, std::uint8_t, MemoKeyHash> countMemo;
+    std::unordered_map<MemoKey, std::uint8_t, MemoKeyHash> bestMemo;
+
+public:
+    std::uint64_t nodes = 0;
+
+    Searcher(const std::vector<Piece>& ps, int targetChain, int solutionLimit)
+        : pieces(ps), target(targetChain), limit(solutionLimit) {}
+
+    // depth 이후 조각들로 target 연쇄에 도달하는 서로 다른 수순의 수 (limit에서 멈춤).
+    // path가 있으면 처음 찾은 수순을 기록
+    int countSolutions(const chain::Grid& g, int depth, std::vector<int>* path) {
+        if(depth >= static_cast<int>(pieces.size())) return 0;
+        MemoKey key{ g, depth };
+        if(!path) {
+            auto it = countMemo.find(key);
+            if(it != countMemo.end()) return it->second;
+        }
+
+        int actions[NUM_PLACEMENTS];
+        MoveResult results[NUM_PLACEMENTS];
+        chain::Grid grids[NUM_PLACEMENTS];
+        int n = distinctPlacements(g, pieces[depth], actions, results, grids);
+        nodes += n;
+
+        bool last = depth + 1 == static_cast<int>(pieces.size());
+        int total = 0;
+        for(int i = 0; i < n && total < limit; i++) {
+            if(last) {
+                if(results[i].chain >= target) {
+                    if(path && total == 0) path->assign(1, actions[i]);
+                    total++;
+                }
+                continue;
+            }
+            if(results[i].dead || results[i].chain > 0) continue;
+            std::vector<int> sub;
+            int found = countSolutions(grids[i], depth + 1, (path && total == 0) ? &sub : nullptr);
+            if(found > 0 && path && total == 0) {
+                path->assign(1, actions[i]);
+                path->insert(path->end(), sub.begin(), sub.end());
+            }
+            total += found;
+        }
+        total = std::min(total, limit);
+        countMemo[key] = static_cast<std::uint8_t>(total);
+        return total;
+    }
+
+    // depth 이후 조각들로 만들 수 있는 최대 연쇄 (생성기에서 목표를 정할 때 사용)
+    int bestChain(const chain::Grid& g, int depth) {
+        if(depth >= static_cast<int>(pieces.size())) return 0;
+        MemoKey key{ g, depth };
+        auto it = bestMemo.find(key);
+        if(it != bestMemo.end()) return it->second;
+
+        int actions[NUM_PLACEMENTS];
+        MoveResult results[NUM_PLACEMENTS];
+        chain::Grid grids[NUM_PLACEMENTS];
+        int n = distinctPlacements(g, pieces[depth], actions, results, grids);
+        nodes += n;
+
+        bool last = depth + 1 == static_cast<int>(pieces.size());
+        int best = 0;
+        for(int i = 0; i < n; i++) {
+            if(last) best = std::max(best, results[i].chain);
+            else if(!results[i].dead && results[i].chain == 0) best = std::max(best, bestChain(grids[i], depth + 1));
+        }
+        bestMemo[key] = static_cast<std::uint8_t>(best);
+        return best;
+    }
+};
+
+struct SolveResult {
+    int solutions = 0;           // limit에서 포화
+    std::vector<int> firstSolution;
+    std::uint64_t nodes = 0;
+};
+
+// 첫 수를 스레드들에 나눠 전수 탐색 (스레드마다 자기 메모 테이블 사용)
+inline SolveResult solve(const Puzzle& pz, int threads, int limit = 2) {
+    SolveResult result;
+    int actions[NUM_PLACEMENTS];
+    MoveResult results[NUM_PLACEMENTS];
+    chain::Grid grids[NUM_PLACEMENTS];
+    int n = distinctPlacements(pz.board, pz.pieces[0], actions, results, grids);
+
+    std::vector<int> counts(n, 0);
+    std::vector<std::vector<int>> paths(n);
+    std::atomic<int> next{0};
+    std::atomic<int> found{0};
+    std::atomic<std::uint64_t> nodes{0};
+
+    auto work = [&] {
+        Searcher searcher(pz.pieces, pz.targetChain, limit);
+        bool last = pz.pieces.size() == 1;
+        for(int i = next.fetch_add(1); i < n && found < limit; i = next.fetch_add(1)) {
+            if(last) {
+                if(results[i].chain >= pz.targetChain) {
+                    counts[i] = 1;
+                    paths[i].assign(1, actions[i]);
+                }
+            } else if(!results[i].dead && results[i].chain == 0) {
+                std::vector<int> sub;
+                counts[i] = searcher.countSolutions(grids[i], 1, &sub);
+                if(counts[i] > 0) {
+                    paths[i].assign(1, actions[i]);
+                    paths[i].insert(paths[i].end(), sub.begin(), sub.end());
+                }
+            }
+            found += counts[i];
+        }
+        nodes += searcher.nodes;
+    };
+
+    std::vector<std::thread> workers;
+    for(int t = 1; t < threads; t++) workers.emplace_back(work);
+    work();
+    for(auto& w : workers) w.join();
+
+    for(int i = 0; i < n; i++) {
+        if(counts[i] > 0 && result.firstSolution.empty()) result.firstSolution = paths[i];
+        result.solutions += counts[i];
+    }
+    result.solutions = std::min(result.solutions, limit);
+    result.nodes = nodes + n;
+    return result;
+}
+
+// 기록된 해답을 그대로 재생해 목표 연쇄에 도달하는지 확인
+inline bool checkSolution(const Puzzle& pz, const std::vector<int>& solution) {
+    if(solution.size() != pz.pieces.size()) return false;
+    chain::Grid g = pz.board;
+    for(size_t i = 0; i < solution.size(); i++) {
+        if(solution[i] < 0 || solution[i] >= NUM_PLACEMENTS) return false;
+        MoveResult r = applyPlacement(g, pz.pieces[i], solution[i]);
+        if(i + 1 == solution.size()) return r.chain >= pz.targetChain;
+        if(r.dead || r.chain > 0) return false;
+    }
+    return false;
+}
+
+} // namespace puzzle
@@ -0,0 +1,205 @@
+// ---- 점수 기록 도구 (헤드리스) ----
+// 게임이 쌓은 기록(--scores=PREFIX)을 조회하고, 리플레이로 기록을 검증하고, 인덱스를 다시 만듦.
+// --simulate는 가상 플레이어 게임을 추가해 큰 기록에서 순위표가 얼마나 빨리 열리는지 잼
+//
+//   ./puyo_scores --top=20
+//   ./puyo_scores --player=alice
+//   ./puyo_scores --verify                      (모든 리플레이를 다시 진행해 수의 합법성과 점수/레벨 비교)
+//   ./puyo_scores --db=/tmp/big --simulate=300000 --bench
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "puyo_ai.hpp"
+#include "puyo_scores.hpp"
+
+using namespace std;
+
+struct ScoresOptions {
+    string db = "puyo_scores";
+    int top = 10;
+    string player;
+    bool verify = false;
+    bool rebuild = false;
+    int simulate = 0;
+    bool aiPlayers = false;
+    int maxMoves = 300;
+    bool bench = false;
+    uint32_t seed = 1;
+};
+
+static double millisSince(chrono::steady_clock::time_point start) {
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+void printRows(const vector<scores::Ranked>& rows, bool ranked) {
+    printf("%5s  %-9s %3s %5s %6s %6s  %-20s %s\n", ranked ? "rank" : "#", "score", "lv", "chain", "lines", "time",
+           "player", "record");
+    for(size_t i = 0; i < rows.size(); i++) {
+        const scores::GameRecord& g = rows[i].game;
+        printf("%5zu  %-9u %3u %5u %6u %3u:%02u  %-20s %u\n", i + 1, g.score, g.level, g.maxChain, g.lines,
+               g.durationMs / 60000, g.durationMs / 1000 % 60, scores::playerName(g).c_str(), rows[i].record);
+    }
+}
+
+// 가상 플레이어 한 판: 무작위 배치(빠름) 또는 평가 함수 AI. 실제 게임처럼 잠금 위치를 기록
+void simulateGame(scores::ScoreStore& store, const ScoresOptions& opt, mt19937& rng, int index) {
+    uint32_t seed = static_cast<uint32_t>(rng());
+    PuyoRng pieces(seed);
+    BoardCore board;
+    PuyoPair cur = makeSpawnPair(pieces);
+    PuyoPair next = makeSpawnPair(pieces);
+    vector<uint16_t> locks;
+    int maxChain = 0;
+    ai::EvalWeights weights;
+    for(int move = 0; move < opt.maxMoves; move++) {
+        int action = opt.aiPlayers ? ai::choosePlacement(board, cur, weights)
+                                   : static_cast<int>(rng() % NUM_PLACEMENTS);
+        PuyoPair placed = dropPlacement(board, cur, action / COLS, action % COLS);
+        locks.push_back(scores::encodeLock(placed));
+        maxChain = max(maxChain, board.resolveChains());
+        if(board.isGameOver()) break;
+        cur = next;
+        next = makeSpawnPair(pieces);
+    }
+
+    scores::GameRecord rec{};
+    rec.timestamp = static_cast<uint64_t>(time(nullptr));
+    rec.score = static_cast<uint32_t>(board.score);
+    rec.lines = static_cast<uint32_t>(board.totalLinesCleared);
+    rec.durationMs = static_cast<uint32_t>(locks.size() * 900);
+    rec.seed = seed;
+    rec.level = static_cast<uint16_t>(board.level);
+    rec.maxChain = static_cast<uint16_t>(maxChain);
+    snprintf(rec.player, sizeof(rec.player), "bot%d", index % 64);
+    store.append(rec, locks);
+}
+
+// 모든 기록을 리플레이로 다시 진행해 저장된 결과와 비교
+int verifyAll(const scores::ScoreStore& store) {
+    int bad = 0, torn = 0;
+    vector<uint16_t> locks;
+    moves::MoveGenerator legality;
+    for(uint64_t i = 0; i < store.count(); i++) {
+        const scores::GameRecord* r = store.record(i);
+        if(!r) {
+            torn++;
+            continue;
+        }
+        if(!store.loadReplay(*r, locks)) {
+            printf("record %llu: replay missing\n", (unsigned long long)i);
+            bad++;
+            continue;
+        }
+        int illegalMove = -1;
+        BoardCore board = scores::replayGame(r->seed, locks, &legality, &illegalMove);
+        if(illegalMove >= 0) {
+            printf("record %llu: move %d is not reachable from the spawn position\n", (unsigned long long)i,
+                   illegalMove);
+            bad++;
+            continue;
+        }
+        if(static_cast<uint32_t>(board.score) != r->score || board.level != r->level ||
+           static_cast<uint32_t>(board.totalLinesCleared) != r->lines) {
+            printf("record %llu: replay gives score %d level %d lines %d, stored %u/%u/%u\n", (unsigned long long)i,
+                   board.score, board.level, board.totalLinesCleared, r->score, r->level, r->lines);
+            bad++;
+        }
+    }
+    printf("verified %llu records: %d mismatched, %d torn (ignored)\n", (unsigned long long)store.count(), bad, torn);
+    return bad == 0 ? 0 : 1;
+}
+
+// 게임이 순위표를 여는 것과 같은 순서: 열기 -> 상위 10개 -> 내 최근 5개
+void runBench(const ScoresOptions& opt) {
+    const int runs = 50;
+    double openMs = 0, topMs = 0, historyMs = 0, rankMs = 0;
+    for(int i = 0; i < runs; i++) {
+        auto start = chrono::steady_clock::now();
+        scores::ScoreStore store;
+        store.open(opt.db);
+        openMs += millisSince(start);
+
+        start = chrono::steady_clock::now();
+        vector<scores::Ranked> top = store.top(10);
+        topMs += millisSince(start);
+
+        start = chrono::steady_clock::now();
+        vector<scores::Ranked> history = store.history("bot7", 5);
+        historyMs += millisSince(start);
+
+        start = chrono::steady_clock::now();
+        store.rankOf(top.empty() ? 0 : top.back().game.score / 2);
+        rankMs += millisSince(start);
+        if(i == 0) printf("%llu records, %llu in the unindexed tail\n", (unsigned long long)store.count(),
+                          (unsigned long long)store.tailSize());
+    }
+    printf("open %.3f ms, top(10) %.3f ms, history(5) %.3f ms, rankOf %.3f ms (mean of %d)\n", openMs / runs,
+           topMs / runs, historyMs / runs, rankMs / runs, runs);
+}
+
+int main(int argc, char** argv) {
+    ScoresOptions opt;
+    for(int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        auto value = [&](const char* name) -> const char* {
+            size_t n = strlen(name);
+            return strncmp(arg, name, n) == 0 && arg[n] == '=' ? arg + n + 1 : nullptr;
+        };
+        if(const char* v = value("--db")) opt.db = v;
+        else if(const char* v = value("--top")) opt.top = max(1, atoi(v));
+        else if(const char* v = value("--player")) opt.player = v;
+        else if(strcmp(arg, "--verify") == 0) opt.verify = true;
+        else if(strcmp(arg, "--rebuild") == 0) opt.rebuild = true;
+        else if(const char* v = value("--simulate")) opt.simulate = max(0, atoi(v));
+        else if(strcmp(arg, "--ai") == 0) opt.aiPlayers = true;
+        else if(const char* v = value("--moves")) opt.maxMoves = max(1, atoi(v));
+        else if(strcmp(arg, "--bench") == 0) opt.bench = true;
+        else if(const char* v = value("--seed")) opt.seed = static_cast<uint32_t>(strtoul(v, nullptr, 10));
+        else {
+            fprintf(stderr,
+                    "usage: %s [--db=PREFIX] [--top=N] [--player=NAME] [--verify] [--rebuild]\n"
+                    "       %s [--db=PREFIX] --simulate=N [--ai] [--moves=N] [--seed=N] [--bench]\n", argv[0], argv[0]);
+            return 2;
+        }
+    }
+
+    scores::ScoreStore store;
+    if(!store.open(opt.db)) {
+        fprintf(stderr, "cannot open %s.log\n", opt.db.c_str());
+        return 1;
+    }
+
+    if(opt.simulate > 0) {
+        mt19937 rng(opt.seed);
+        auto start = chrono::steady_clock::now();
+        for(int i = 0; i < opt.simulate; i++) simulateGame(store, opt, rng, i);
+        printf("simulated %d games in %.1f s (%llu records total)\n", opt.simulate, millisSince(start) / 1000.0,
+               (unsigned long long)store.count());
+    }
+    if(opt.rebuild) {
+        auto start = chrono::steady_clock::now();
+        bool ok = store.rebuildIndexes(true);
+        printf("rebuilt indexes over %llu records in %.1f ms%s\n", (unsigned long long)store.count(),
+               millisSince(start), ok ? "" : " (write failed)");
+    }
+    if(opt.bench) {
+        runBench(opt);
+        return 0;
+    }
+    if(opt.verify) return verifyAll(store);
+
+    if(!opt.player.empty()) {
+        printf("recent games of %s\n", opt.player.c_str());
+        printRows(store.history(opt.player, static_cast<size_t>(opt.top)), false);
+    } else if(opt.simulate == 0 && !opt.rebuild) {
+        printRows(store.top(static_cast<size_t>(opt.top)), true);
+    }
+    return 0;
+}
@@ -0,0 +1,406 @@
+#pragma once
+// ---- 점수 기록 / 리플레이 저장소 ----
+// <prefix>.log         끝난 게임 레코드 (64바이트 고정, 추가만 함)
+// <prefix>.replay      리플레이 = 잠금 위치(u16) 목록. 뿌요 순서는 레코드의 시드로 다시 만듦
+// <prefix>.rank.idx    점수 내림차순으로 정렬된 (점수, 레코드 번호)
+// <prefix>.player.idx  (플레이어 해시, 레코드 번호 내림차순)으로 정렬된 목록
+//
+// 인덱스는 메모리 맵으로 열어 바로 읽고, 인덱스를 만든 뒤에 추가된 레코드(꼬리)만 훑어서 합침.
+// 꼬리가 길어지면 인덱스를 병합해 새로 씀 (임시 파일 -> 이름 바꾸기)
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "puyo_core.hpp"
+#include "mapped_file.hpp"
+#include "puyo_moves.hpp"
+
+namespace scores {
+
+static const char LOG_MAGIC[8] = {'P','U','Y','O','L','O','G','1'};
+static const char INDEX_MAGIC[8] = {'P','U','Y','O','I','D','X','1'};
+static const int HEADER_SIZE = 64;
+static const int PLAYER_NAME_SIZE = 20;
+static const std::uint64_t TAIL_LIMIT = 4096;   // 이만큼 쌓이면 인덱스에 병합
+
+struct GameRecord {
+    std::uint64_t timestamp;      // 유닉스 시각 (초)
+    std::uint32_t score;
+    std::uint32_t lines;          // totalLinesCleared
+    std::uint32_t durationMs;
+    std::uint32_t seed;           // PuyoRng 시드
+    std::uint64_t replayOffset;   // .replay 안의 바이트 위치
+    std::uint32_t replayMoves;
+    std::uint16_t level;
+    std::uint16_t maxChain;
+    char player[PLAYER_NAME_SIZE];
+    std::uint32_t checksum;       // 앞 60바이트의 FNV-1a (찢어진 마지막 레코드 검출)
+};
+static_assert(sizeof(GameRecord) == 64, "game record must stay 64 bytes");
+
+struct RankEntry {
+    std::uint32_t score;
+    std::uint32_t record;
+};
+
+struct PlayerEntry {
+    std::uint64_t playerHash;
+    std::uint32_t record;
+    std::uint32_t score;
+};
+
+inline std::uint32_t fnv1a(const void* data, size_t size) {
+    const std::uint8_t* p = static_cast<const std::uint8_t*>(data);
+    std::uint32_t h = 2166136261u;
+    for(size_t i = 0; i < size; i++) h = (h ^ p[i]) * 16777619u;
+    return h;
+}
+
+// 2 GiB를 넘는 파일 위치 (Windows는 long이 32비트라 fseek/ftell로는 잘림)
+inline bool seekTo(FILE* fp, std::uint64_t offset) {
+#ifdef _WIN32
+    return _fseeki64(fp, static_cast<__int64>(offset), SEEK_SET) == 0;
+#else
+    return fseeko(fp, static_cast<off_t>(offset), SEEK_SET) == 0;
+#endif
+}
+
+inline std::uint64_t endOf(FILE* fp) {
+#ifdef _WIN32
+    _fseeki64(fp, 0, SEEK_END);
+    return static_cast<std::uint64_t>(_ftelli64(fp));
+#else
+    fseeko(fp, 0, SEEK_END);
+    return static_cast<std::uint64_t>(ftello(fp));
+#endif
+}
+
+inline std::uint32_t recordChecksum(const GameRecord& r) {
+    return fnv1a(&r, offsetof(GameRecord, checksum));
+}
+
+inline std::uint64_t playerHash(const std::string& name) {
+    std::uint64_t h = 1469598103934665603ull;
+    for(size_t i = 0; i < name.size() && i < static_cast<size_t>(PLAYER_NAME_SIZE); i++) {
+        h = (h ^ static_cast<std::uint8_t>(name[i])) * 1099511628211ull;
+    }
+    return h ? h : 1;
+}
+
+inline std::string playerName(const GameRecord& r) {
+    return std::string(r.player, strnlen(r.player, PLAYER_NAME_SIZE));
+}
+
+// 점수 높은 순, 같으면 먼저 끝난 게임이 위
+inline bool rankBefore(const RankEntry& a, const RankEntry& b) {
+    return a.score != b.score ? a.score > b.score : a.record < b.record;
+}
+
+// 플레이어별로 모으고, 그 안에서는 최근 게임이 앞
+inline bool playerBefore(const PlayerEntry& a, const PlayerEntry& b) {
+    return a.playerHash != b.playerHash ? a.playerHash < b.playerHash : a.record > b.record;
+}
+
+// 잠금 위치 한 개: 축 x(3비트) | 축 y(4비트) << 3 | 방향(2비트) << 7
+inline std::uint16_t encodeLock(const PuyoPair& p) {
+    int orientation = 0;
+    for(int o = 0; o < NUM_ORIENTATIONS; o++) {
+        Vec2 v = orientationOffset(o);
+        if(v.x == p.sub.x && v.y == p.sub.y) orientation = o;
+    }
+    return static_cast<std::uint16_t>((p.pivot.x & 7) | (p.pivot.y & 15) << 3 | orientation << 7);
+}
+
+// 시드와 잠금 목록으로 게임을 다시 진행 (리플레이 재생 / 검증)
+// legality가 있으면 잠금마다 스폰 위치에서 도달 가능한지 확인하고, 처음 어긋난 수를 illegalMove에 기록
+inline BoardCore replayGame(std::uint32_t seed, const std::vector<std::uint16_t>& locks,
+                            moves::MoveGenerator* legality = nullptr, int* illegalMove = nullptr) {
+    BoardCore board;
+    PuyoRng rng(seed);
+    PuyoPair cur = makeSpawnPair(rng);
+    PuyoPair next = makeSpawnPair(rng);
+    if(illegalMove) *illegalMove = -1;
+    for(size_t i = 0; i < locks.size(); i++) {
+        std::uint16_t code = locks[i];
+        PuyoPair spawn = cur;
+        cur.pivot = { code & 7, (code >> 3) & 15 };
+        cur.sub = orientationOffset((code >> 7) & 3);
+        if(legality && illegalMove && *illegalMove < 0 && !legality->find(board, spawn, cur)) {
+            *illegalMove = static_cast<int>(i);
+        }
+        board.lock(cur);
+        board.resolveChains();
+        cur = next;
+        next = makeSpawnPair(rng);
+    }
+    return board;
+}
+
+// 정렬된 고정 크기 항목 배열 파일 (헤더: 매직, 항목 크기, 반영한 로그 레코드 수)
+template<class Entry>
+class SortedIndex {
+private:
+    MappedFile file;
+    const Entry* items = nullptr;
+    std::uint64_t itemCount = 0;
+    std::uint64_t coveredRecords = 0;
+
+public:
+    bool open(const std::string& path) {
+        items = nullptr;
+        itemCount = coveredRecords = 0;
+        if(!file.open(path, MappedFile::READ_ONLY)) return false;
+        const std::uint8_t* p = file.data();
+        std::uint32_t entrySize = 0;
+        if(file.size() < static_cast<size_t>(HEADER_SIZE) || std::memcmp(p, INDEX_MAGIC, 8) != 0) {
+            file.close();
+            return false;
+        }
+        std::memcpy(&entrySize, p + 8, 4);
+        std::memcpy(&itemCount, p + 16, 8);
+        std::memcpy(&coveredRecords, p + 24, 8);
+        if(entrySize != sizeof(Entry) || HEADER_SIZE + itemCount * sizeof(Entry) > file.size()) {
+            file.close();
+            itemCount = coveredRecords = 0;
+            return false;
+        }
+        items = reinterpret_cast<const Entry*>(p + HEADER_SIZE);
+        return true;
+    }
+
+    void close() {
+        file.close();
+        items = nullptr;
+        itemCount = coveredRecords = 0;
+    }
+
+    const Entry* begin() const { return items; }
+    const Entry* end() const { return items + itemCount; }
+    std::uint64_t size() const { return itemCount; }
+    std::uint64_t covered() const { return coveredRecords; }
+
+    // path.tmp에 씀. 다른 인덱스와 함께 성공했을 때만 commit으로 바꿔 넣음
+    static bool writeTemp(const std::string& path, const std::vector<Entry>& entries, std::uint64_t covered) {
+        std::string tmp = path + ".tmp";
+        FILE* fp = std::fopen(tmp.c_str(), "wb");
+        if(!fp) return false;
+        std::uint8_t header[HEADER_SIZE] = {};
+        std::memcpy(header, INDEX_MAGIC, 8);
+        std::uint32_t entrySize = sizeof(Entry);
+        std::uint64_t count = entries.size();
+        std::memcpy(header + 8, &entrySize, 4);
+        std::memcpy(header + 16, &count, 8);
+        std::memcpy(header + 24, &covered, 8);
+        bool ok = std::fwrite(header, 1, HEADER_SIZE, fp) == static_cast<size_t>(HEADER_SIZE) &&
+                  std::fwrite(entries.data(), sizeof(Entry), entries.size(), fp) == entries.size();
+        ok = std::fclose(fp) == 0 && ok;
+        if(!ok) std::remove(tmp.c_str());
+        return ok;
+    }
+
+    static bool commit(const std::string& path) {
+        std::string tmp = path + ".tmp";
+        std::remove(path.c_str());
+        return std::rename(tmp.c_str(), path.c_str()) == 0;
+    }
+};
+
+struct Ranked {
+    std::uint32_t record;
+    GameRecord game;
+};
+
+class ScoreStore {
+private:
+    std::string prefix;
+    MappedFile log;
+    std::uint64_t records = 0;
+    SortedIndex<RankEntry> byRank;
+    SortedIndex<PlayerEntry> byPlayer;
+
+    std::string path(const char* suffix) const { return prefix + suffix; }
+
+    // 로그를 다시 매핑 (추가한 뒤, 또는 처음 열 때)
+    bool remapLog() {
+        log.close();
+        records = 0;
+        if(!log.open(path(".log"), MappedFile::READ_ONLY)) return false;
+        if(log.size() < static_cast<size_t>(HEADER_SIZE) || std::memcmp(log.data(), LOG_MAGIC, 8) != 0) {
+            log.close();
+            return false;
+        }
+        records = (log.size() - HEADER_SIZE) / sizeof(GameRecord);
+        return true;
+    }
+
+    // 인덱스가 아직 반영하지 않은 레코드 번호 범위 [from, records)
+    std::uint64_t tailStart() const { return std::min(byRank.covered(), byPlayer.covered()); }
+
+public:
+    bool open(const std::string& pathPrefix) {
+        prefix = pathPrefix;
+        FILE* fp = std::fopen(path(".log").c_str(), "ab");
+        if(!fp) return false;
+        if(std::ftell(fp) == 0) {
+            std::uint8_t header[HEADER_SIZE] = {};
+            std::memcpy(header, LOG_MAGIC, 8);
+            std::uint32_t recordSize = sizeof(GameRecord);
+            std::memcpy(header + 8, &recordSize, 4);
+            std::fwrite(header, 1, HEADER_SIZE, fp);
+        }
+        std::fclose(fp);
+        byRank.open(path(".rank.idx"));
+        byPlayer.open(path(".player.idx"));
+        if(!remapLog()) return false;
+        // 로그가 인덱스보다 짧으면 (로그를 지웠거나 바꿈) 인덱스를 버리고 새로 만듦
+        if(byRank.covered() > records || byPlayer.covered() > records) return rebuildIndexes(true);
+        return true;
+    }
+
+    bool isOpen() const { return log.isOpen(); }
+    std::uint64_t count() const { return records; }
+    std::uint64_t tailSize() const { return records - tailStart(); }
+
+    // 체크섬이 맞지 않는 레코드(쓰다 끊긴 것)는 nullptr
+    const GameRecord* record(std::uint64_t i) const {
+        if(i >= records) return nullptr;
+        const GameRecord* r = reinterpret_cast<const GameRecord*>(log.data() + HEADER_SIZE) + i;
+        return r->checksum == recordChecksum(*r) ? r : nullptr;
+    }
+
+    // 리플레이를 먼저 쓰고 레코드를 추가 (레코드가 있으면 리플레이도 있음)
+    bool append(GameRecord rec, const std::vector<std::uint16_t>& locks) {
+        FILE* rp = std::fopen(path(".replay").c_str(), "ab");
+        if(!rp) return false;
+        rec.replayOffset = endOf(rp);
+        rec.replayMoves = static_cast<std::uint32_t>(locks.size());
+        bool ok = std::fwrite(locks.data(), sizeof(std::uint16_t), locks.size(), rp) == locks.size();
+        ok = std::fclose(rp) == 0 && ok;
+        if(!ok) return false;
+
+        // 끝이 잘린 레코드가 있으면 레코드 경계에 맞춰 이어 씀
+        FILE* lp = std::fopen(path(".log").c_str(), "r+b");
+        if(!lp) return false;
+        rec.checksum = recordChecksum(rec);
+        ok = seekTo(lp, HEADER_SIZE + records * sizeof(GameRecord)) && std::fwrite(&rec, sizeof(rec), 1, lp) == 1;
+        ok = std::fclose(lp) == 0 && ok;
+        if(!ok || !remapLog()) return false;
+
+        if(tailSize() >= TAIL_LIMIT) rebuildIndexes(false);
+        return true;
+    }
+
+    // 기존 인덱스(이미 정렬됨)와 정렬한 꼬리를 병합해 새로 씀.
+    // 꼬리는 인덱스마다 자기가 반영한 곳부터 (한쪽만 바뀐 채 남아도 같은 레코드를 두 번 넣지 않음)
+    bool rebuildIndexes(bool fromScratch) {
+        std::uint64_t rankFrom = fromScratch ? 0 : byRank.covered();
+        std::uint64_t playerFrom = fromScratch ? 0 : byPlayer.covered();
+        std::vector<RankEntry> rankTail;
+        std::vector<PlayerEntry> playerTail;
+        for(std::uint64_t i = std::min(rankFrom, playerFrom); i < records; i++) {
+            const GameRecord* r = record(i);
+            if(!r) continue;
+            if(i >= rankFrom) rankTail.push_back({r->score, static_cast<std::uint32_t>(i)});
+            if(i >= playerFrom) {
+                playerTail.push_back({playerHash(playerName(*r)), static_cast<std::uint32_t>(i), r->score});
+            }
+        }
+        std::sort(rankTail.begin(), rankTail.end(), rankBefore);
+        std::sort(playerTail.begin(), playerTail.end(), playerBefore);
+
+        std::vector<RankEntry> ranks;
+        std::vector<PlayerEntry> players;
+        if(fromScratch) {
+            ranks.swap(rankTail);
+            players.swap(playerTail);
+        } else {
+            ranks.resize(byRank.size() + rankTail.size());
+            std::merge(byRank.begin(), byRank.end(), rankTail.begin(), rankTail.end(), ranks.begin(), rankBefore);
+            players.resize(byPlayer.size() + playerTail.size());
+            std::merge(byPlayer.begin(), byPlayer.end(), playerTail.begin(), playerTail.end(), players.begin(),
+                       playerBefore);
+        }
+        // 둘 다 임시 파일에 쓴 뒤에만 바꿔 넣음 (하나가 실패하면 둘 다 이전 인덱스 유지)
+        bool rankOk = SortedIndex<RankEntry>::writeTemp(path(".rank.idx"), ranks, records);
+        bool playerOk = SortedIndex<PlayerEntry>::writeTemp(path(".player.idx"), players, records);
+        bool ok = rankOk && playerOk;
+        byRank.close();
+        byPlayer.close();
+        if(ok) {
+            ok = SortedIndex<RankEntry>::commit(path(".rank.idx"));
+            ok = SortedIndex<PlayerEntry>::commit(path(".player.idx")) && ok;
+        } else {
+            if(rankOk) std::remove((path(".rank.idx") + ".tmp").c_str());
+            if(playerOk) std::remove((path(".player.idx") + ".tmp").c_str());
+        }
+        byRank.open(path(".rank.idx"));
+        byPlayer.open(path(".player.idx"));
+        return ok;
+    }
+
+    // 상위 n개: 인덱스 앞부분 n개와 꼬리를 합침 (로그 전체를 읽지 않음)
+    std::vector<Ranked> top(size_t n) const {
+        std::vector<RankEntry> candidates;
+        for(const RankEntry* e = byRank.begin(); e != byRank.end() && candidates.size() < n; e++) {
+            candidates.push_back(*e);
+        }
+        for(std::uint64_t i = tailStart(); i < records; i++) {
+            if(i < byRank.covered()) continue;
+            if(const GameRecord* r = record(i)) candidates.push_back({r->score, static_cast<std::uint32_t>(i)});
+        }
+        std::sort(candidates.begin(), candidates.end(), rankBefore);
+        std::vector<Ranked> out;
+        for(const RankEntry& e : candidates) {
+            if(out.size() >= n) break;
+            if(const GameRecord* r = record(e.record)) out.push_back({e.record, *r});
+        }
+        return out;
+    }
+
+    // 한 플레이어의 최근 게임 n개
+    std::vector<Ranked> history(const std::string& player, size_t n) const {
+        std::uint64_t h = playerHash(player);
+        std::vector<Ranked> out;
+        // 꼬리가 더 최근이므로 먼저
+        for(std::uint64_t i = records; i > tailStart() && out.size() < n; i--) {
+            if(i - 1 < byPlayer.covered()) break;
+            const GameRecord* r = record(i - 1);
+            if(r && playerName(*r) == player) out.push_back({static_cast<std::uint32_t>(i - 1), *r});
+        }
+        PlayerEntry key{h, UINT32_MAX, 0};
+        const PlayerEntry* it = std::lower_bound(byPlayer.begin(), byPlayer.end(), key, playerBefore);
+        for(; it != byPlayer.end() && it->playerHash == h && out.size() < n; it++) {
+            const GameRecord* r = record(it->record);
+            if(r && playerName(*r) == player) out.push_back({it->record, *r});
+        }
+        return out;
+    }
+
+    // 이 점수가 들어갈 순위 (1부터)
+    std::uint64_t rankOf(std::uint32_t score) const {
+        RankEntry key{score, 0};
+        std::uint64_t better = static_cast<std::uint64_t>(
+            std::lower_bound(byRank.begin(), byRank.end(), key, rankBefore) - byRank.begin());
+        for(std::uint64_t i = byRank.covered(); i < records; i++) {
+            const GameRecord* r = record(i);
+            if(r && r->score > score) better++;
+        }
+        return better + 1;
+    }
+
+    bool loadReplay(const GameRecord& rec, std::vector<std::uint16_t>& locks) const {
+        FILE* fp = std::fopen(path(".replay").c_str(), "rb");
+        if(!fp) return false;
+        locks.resize(rec.replayMoves);
+        bool ok = seekTo(fp, rec.replayOffset) &&
+                  std::fread(locks.data(), sizeof(std::uint16_t), locks.size(), fp) == locks.size();
+        std::fclose(fp);
+        return ok;
+    }
+};
+
+} // namespace scores
@@ -0,0 +1,312 @@
+#pragma once
+// ---- 비동기 CPU 탐색 (언제 멈춰도 그때까지의 최선을 돌려주는 탐색) ----
+// 게임 루프는 start()로 일을 맡기고 bestAction()만 읽음. 탐색은 워커 스레드에서:
+//   0라운드  배치 24가지마다 현재 쌍 + NEXT 쌍까지 (2수) 평가, 각 배치의 좋은 2수째 BEAM개를 기억
+//   r라운드  알 수 없는 3수째 쌍을 하나 뽑아(라운드마다 같은 쌍: 공통 난수) 3수까지 평가해 평균에 더함
+// 일은 (라운드, 배치) 단위로 나눠 워커가 가져감. 라운드가 끝날 때마다 최선 배치를 갱신.
+// 보드가 바뀌면 start()/cancel()이 세대 번호를 올려 진행 중인 일을 버림
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "puyo_ai.hpp"
+
+namespace ai {
+
+// 레벨별 생각 시간: 지금 쌍이 바닥까지 떨어지는 시간(getFallSpeed * 남은 줄)의 fraction, [minSeconds, maxSeconds]
+struct SearchBudget {
+    float fraction = 0.5f;
+    float minSeconds = 0.004f;
+    float maxSeconds = 0.3f;
+
+    float secondsFor(const BoardCore& b, const PuyoPair& cur) const {
+        int rows = ROWS - columnHeight(b, cur.pivot.x) - cur.pivot.y;
+        float fall = b.getFallSpeed() * static_cast<float>(std::max(1, rows));
+        return std::min(maxSeconds, std::max(minSeconds, fraction * fall));
+    }
+};
+
+struct SearchStatus {
+    int action = -1;       // 지금까지의 최선 배치 (-1: 아직 없음)
+    int depth = 0;         // 1: 현재 쌍만, 2: NEXT까지, 3: 뽑은 3수째까지
+    int samples = 0;       // 끝난 3수째 라운드 수
+    std::uint64_t evaluations = 0;
+};
+
+class AnytimeSearch {
+private:
+    static const int BEAM = 3;
+    static const int MAX_ROUNDS = 256;
+
+    struct Job {
+        BoardCore board;
+        PuyoPair cur, next;
+        std::uint64_t generation = 0;
+        std::chrono::steady_clock::time_point deadline;
+        std::uint32_t seed = 0;
+    };
+
+    // 배치 하나의 결과 (0라운드가 채움)
+    struct RootResult {
+        bool legal = false;
+        float depth1 = -1e30f;
+        float depth2 = -1e30f;
+        int beam[BEAM];
+        int beamCount = 0;
+        double sampleSum = 0.0;
+        int sampleCount = 0;
+    };
+
+    EvalWeights weights;
+    const patterns::PatternLibrary* library;
+    std::vector<std::thread> workers;
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    Job job;
+    bool stopping = false;
+
+    // 진행 중인 일 (job.generation과 세대가 다르면 버림)
+    std::atomic<std::uint64_t> generation{0};
+    std::atomic<std::uint64_t> taskWord{0};  // 세대 << 24 | 다음 일 번호
+    std::vector<RootResult> roots;           // mutex로 보호
+    std::vector<int> roundDone;              // 라운드별 끝난 배치 수
+    std::atomic<bool> rootReady[NUM_PLACEMENTS];
+    SearchStatus published;                  // mutex로 보호
+    std::atomic<std::uint64_t> evaluations{0};
+
+    bool cancelled(std::uint64_t gen) const { return generation.load(std::memory_order_relaxed) != gen; }
+
+    // 이 세대의 다음 일 번호 (세대가 바뀌었으면 -1: 옛 워커가 새 일 번호를 가로채지 않도록)
+    int claimTask(std::uint64_t gen) {
+        std::uint64_t w = taskWord.load();
+        while(true) {
+            if((w >> 24) != gen) return -1;
+            if(taskWord.compare_exchange_weak(w, w + 1)) return static_cast<int>(w & 0xFFFFFF);
+        }
+    }
+
+    // 배치 후 연쇄까지 처리한 보드. 패배면 false
+    static bool place(BoardCore& b, const PuyoPair& pair, int action) {
+        PuyoPair p = pair;
+        p.pivot = { COLS/2, 0 };
+        p.sub = { 0, -1 };
+        dropPlacement(b, p, action / COLS, action % COLS);
+        b.resolveChains();
+        return !b.isGameOver();
+    }
+
+    static bool skipSymmetric(const PuyoPair& pair, int action) {
+        return pair.c1 == pair.c2 && action / COLS >= 2;
+    }
+
+    float evaluate(const BoardCore& b, int before) {
+        evaluations.fetch_add(1, std::memory_order_relaxed);
+        return weights.evaluate(computeFeatures(b, b.score - before, library));
+    }
+
+    // 3수째 pair까지 본 최선 값 (after: 2수를 둔 보드)
+    float bestReply(const BoardCore& after, int before, const PuyoPair& pair, std::uint64_t gen) {
+        float best = -1e30f;
+        for(int a = 0; a < NUM_PLACEMENTS && !cancelled(gen); a++) {
+            if(skipSymmetric(pair, a)) break;
+            BoardCore trial = after;
+            if(!place(trial, pair, a)) continue;
+            best = std::max(best, evaluate(trial, before));
+        }
+        return best;
+    }
+
+    void runRoot(const Job& j, int action, RootResult& out) {
+        BoardCore first = j.board;
+        int before = first.score;
+        if(skipSymmetric(j.cur, action) || !place(first, j.cur, action)) return;
+        out.legal = true;
+        out.depth1 = evaluate(first, before);
+
+        float values[NUM_PLACEMENTS];
+        int order[NUM_PLACEMENTS];
+        int n = 0;
+        for(int a = 0; a < NUM_PLACEMENTS && !cancelled(j.generation); a++) {
+            if(skipSymmetric(j.next, a)) break;
+            BoardCore second = first;
+            if(!place(second, j.next, a)) continue;
+            values[a] = evaluate(second, before);
+            order[n++] = a;
+        }
+        std::sort(order, order + n, [&](int x, int y) { return values[x] > values[y]; });
+        out.depth2 = n > 0 ? values[order[0]] : out.depth1 - 1e6f;   // 다음 수가 모두 패배면 크게 감점
+        out.beamCount = std::min(n, BEAM);
+        for(int i = 0; i < out.beamCount; i++) out.beam[i] = order[i];
+    }
+
+    float runSample(const Job& j, int action, const RootResult& root, const PuyoPair& third) {
+        BoardCore first = j.board;
+        int before = first.score;
+        place(first, j.cur, action);
+        if(root.beamCount == 0) return root.depth2;
+        float best = -1e30f;
+        for(int i = 0; i < root.beamCount; i++) {
+            BoardCore second = first;
+            place(second, j.next, root.beam[i]);
+            best = std::max(best, bestReply(second, before, third, j.generation));
+        }
+        return best > -1e29f ? best : root.depth2 - 1e6f;
+    }
+
+    // 라운드가 끝나면 최선 배치 갱신 (mutex 잡은 상태에서 호출)
+    void publish(int round) {
+        int best = -1;
+        double bestValue = -1e300;
+        for(int a = 0; a < NUM_PLACEMENTS; a++) {
+            const RootResult& r = roots[a];
+            if(!r.legal) continue;
+            double v = round == 0 ? r.depth2 : r.sampleSum / std::max(1, r.sampleCount);
+            if(v > bestValue) {
+                bestValue = v;
+                best = a;
+            }
+        }
+        if(best < 0) return;
+        published.action = best;
+        published.depth = round == 0 ? 2 : 3;
+        published.samples = round;
+    }
+
+    void work(const Job& j) {
+        const int perRound = NUM_PLACEMENTS;
+        std::mt19937 thirdRng;
+        while(!cancelled(j.generation) && std::chrono::steady_clock::now() < j.deadline) {
+            int task = claimTask(j.generation);
+            if(task < 0) return;
+            int round = task / perRound, action = task % perRound;
+            if(round > MAX_ROUNDS) return;
+
+            if(round == 0) {
+                RootResult r;
+                runRoot(j, action, r);
+                if(cancelled(j.generation)) return;
+                std::lock_guard<std::mutex> lock(mutex);
+                if(cancelled(j.generation)) return;
+                roots[action] = r;
+                rootReady[action].store(true, std::memory_order_release);
+                // 2수 평가 전이라도 1수 최선은 바로 쓸 수 있게
+                if(published.depth <= 1 && r.legal &&
+                   (published.action < 0 || r.depth1 > roots[published.action].depth1)) {
+                    published.action = action;
+                    published.depth = 1;
+                }
+                if(++roundDone[0] == perRound) publish(0);
+                continue;
+            }
+
+            // 같은 배치의 0라운드가 다른 워커에서 아직 진행 중이면 기다림
+            while(!rootReady[action].load(std::memory_order_acquire)) {
+                if(cancelled(j.generation)) return;
+                std::this_thread::yield();
+            }
+            RootResult root;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                root = roots[action];
+            }
+            if(!root.legal) {
+                std::lock_guard<std::mutex> lock(mutex);
+                if(!cancelled(j.generation) && ++roundDone[round] == perRound) publish(round);
+                continue;
+            }
+            // 라운드마다 같은 3수째 쌍 (배치 간 비교가 공정하도록)
+            thirdRng.seed(j.seed + static_cast<std::uint32_t>(round) * 7919u);
+            PuyoPair third = makeSpawnPair(thirdRng);
+            float v = runSample(j, action, root, third);
+            if(cancelled(j.generation)) return;
+            std::lock_guard<std::mutex> lock(mutex);
+            if(cancelled(j.generation)) return;
+            roots[action].sampleSum += v;
+            roots[action].sampleCount++;
+            if(++roundDone[round] == perRound) publish(round);
+        }
+    }
+
+    void workerLoop() {
+        std::uint64_t seen = 0;
+        while(true) {
+            Job j;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [&] { return stopping || job.generation != seen; });
+                if(stopping) return;
+                seen = job.generation;
+                j = job;
+            }
+            work(j);
+        }
+    }
+
+public:
+    explicit AnytimeSearch(int threads = 0, const EvalWeights& w = EvalWeights::defaults(),
+                           const patterns::PatternLibrary* lib = nullptr)
+        : weights(w), library(lib), roots(NUM_PLACEMENTS), roundDone(MAX_ROUNDS + 1, 0) {
+        for(auto& r : rootReady) r.store(false);
+        if(threads <= 0) threads = static_cast<int>(std::max(2u, std::thread::hardware_concurrency()) - 1);
+        for(int i = 0; i < threads; i++) workers.emplace_back([this] { workerLoop(); });
+    }
+
+    ~AnytimeSearch() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+            generation.fetch_add(1);
+        }
+        wake.notify_all();
+        for(auto& w : workers) w.join();
+    }
+
+    AnytimeSearch(const AnytimeSearch&) = delete;
+    AnytimeSearch& operator=(const AnytimeSearch&) = delete;
+
+    // 새 탐색 시작 (이전 탐색은 버림). seconds가 지나면 워커는 새 일을 가져가지 않음
+    void start(const BoardCore& board, const PuyoPair& cur, const PuyoPair& next, float seconds) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            job.board = board;
+            job.cur = cur;
+            job.next = next;
+            job.deadline = std::chrono::steady_clock::now() +
+                           std::chrono::microseconds(static_cast<std::int64_t>(seconds * 1e6f));
+            job.seed = static_cast<std::uint32_t>(board.score * 31 + cur.c1 * 7 + next.c2) ^ 0x9E3779B9u;
+            job.generation = generation.fetch_add(1) + 1;
+            taskWord = job.generation << 24;
+            std::fill(roots.begin(), roots.end(), RootResult());
+            std::fill(roundDone.begin(), roundDone.end(), 0);
+            for(auto& r : rootReady) r.store(false);
+            published = SearchStatus();
+            evaluations = 0;
+        }
+        wake.notify_all();
+    }
+
+    // 보드가 바뀌어 지금 탐색이 쓸모없어짐
+    void cancel() {
+        std::lock_guard<std::mutex> lock(mutex);
+        generation.fetch_add(1);
+        published = SearchStatus();
+    }
+
+    SearchStatus status() {
+        std::lock_guard<std::mutex> lock(mutex);
+        SearchStatus s = published;
+        s.evaluations = evaluations.load(std::memory_order_relaxed);
+        return s;
+    }
+
+    int threadCount() const { return static_cast<int>(workers.size()); }
+};
+
+} // namespace ai
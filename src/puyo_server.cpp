@@ -0,0 +1,931 @@
+// ---- 헤드리스 대전 서버 (Linux: epoll) ----
+// 이벤트 루프 스레드 하나가 모든 소켓(로컬 TCP, Unix 소켓)과 틱 타이머(timerfd)를 처리하고,
+// 틱마다 대전들을 작업 스레드들에 나눠 진행시킨 뒤 바뀐 부분(DELTA)만 모아 보냄.
+// 입력은 다음 틱에 적용되므로 틱 동안 대전 상태를 만지는 것은 작업 스레드뿐
+//
+//   ./puyo_server --unix=/tmp/puyo.sock --tcp=7777 --tick-hz=60 --threads=4 --bot-matches=200
+//   ./puyo_server --client=unix:/tmp/puyo.sock --clients=200 --duration=30     (부하 클라이언트)
+//   ./puyo_server --bot-matches=200 --metrics=9465                            (curl 127.0.0.1:9465/metrics)
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/timerfd.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "puyo_ai.hpp"
+#include "puyo_metrics.hpp"
+#include "puyo_net.hpp"
+
+using namespace std;
+
+struct ServerOptions {
+    string unixPath;
+    int tcpPort = 0;
+    int tickHz = 60;
+    int threads = 0;
+    int botMatches = 0;          // 클라이언트 없이 유지할 봇 대 봇 대전 수
+    int metricsPort = 0;         // 0이 아니면 127.0.0.1:PORT/metrics
+    bool aiBot = false;          // false: 빠른 탐욕 봇, true: 평가 함수 CPU
+    int botThinkTicks = 4;       // 봇이 한 수를 두는 간격
+    int maxTicks = 60 * 180;     // 이 틱이 지나면 점수로 판정
+    double statsInterval = 5.0;
+    double duration = 0.0;       // 0이면 신호가 올 때까지
+    // 부하 클라이언트
+    string connectAddr;
+    int clients = 0;
+    bool vsBot = false;
+};
+
+static volatile sig_atomic_t stopRequested = 0;
+
+// --metrics=PORT로 노출하는 계측 (틱 작업 스레드에서도 잠금 없이 기록)
+struct ServerMetrics {
+    metrics::Registry registry;
+    metrics::Histogram& tick = registry.histogram("puyo_server_tick_seconds", "Time to step every match in one tick");
+    metrics::Histogram& chain = registry.histogram("puyo_server_chain_resolve_seconds", "Time to resolve the chain after a lock");
+    metrics::Histogram& input = registry.histogram("puyo_server_input_latency_seconds", "Message received to applied in a match");
+    metrics::Counter& ticks = registry.counter("puyo_server_ticks_total", "Ticks processed");
+    metrics::Counter& lateTicks = registry.counter("puyo_server_late_ticks_total", "Ticks skipped because the loop fell behind");
+    metrics::Counter& matchesStarted = registry.counter("puyo_server_matches_started_total", "Matches started");
+    metrics::Counter& matchesFinished = registry.counter("puyo_server_matches_finished_total", "Matches finished (games played)");
+    metrics::Counter& messagesIn = registry.counter("puyo_server_messages_in_total", "Frames received");
+    metrics::Counter& bytesIn = registry.counter("puyo_server_bytes_in_total", "Bytes received");
+    metrics::Counter& bytesOut = registry.counter("puyo_server_bytes_out_total", "Bytes sent");
+    metrics::Gauge& connections = registry.gauge("puyo_server_connections", "Open client connections");
+    metrics::Gauge& liveMatches = registry.gauge("puyo_server_matches", "Matches in progress");
+};
+static ServerMetrics serverMetrics;
+
+uint64_t nowNanos() {
+    return static_cast<uint64_t>(
+        chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// 누적 히스토그램의 지난번 이후 늘어난 버킷 (콘솔의 구간 백분위용). since는 이번 스냅샷으로 바뀜
+void bucketsSince(const metrics::Histogram& h, vector<uint64_t>& since, vector<uint64_t>& delta) {
+    vector<uint64_t> now;
+    uint64_t sum;
+    h.snapshot(now, sum);
+    since.resize(now.size(), 0);
+    delta.resize(now.size());
+    for(size_t i = 0; i < now.size(); i++) delta[i] = now[i] - since[i];
+    since = std::move(now);
+}
+
+// 빠른 봇: (획득 점수 - 높이 벌점)이 가장 큰 배치
+int greedyPlacement(const BoardCore& board, const PuyoPair& cur) {
+    int best = 0;
+    double bestValue = -1e18;
+    for(int action = 0; action < NUM_PLACEMENTS; action++) {
+        if(cur.c1 == cur.c2 && action / COLS >= 2) break;
+        // 놓인 두 칸에서만 연쇄를 확인하는 빠른 시뮬레이션 (틱 예산 안에 수백 판의 봇을 돌리기 위해)
+        BoardCore trial = board;
+        PuyoPair placed = dropPlacement(trial, cur, action / COLS, action % COLS);
+        Vec2 seeds[2] = { placed.pivot, {placed.pivot.x + placed.sub.x, placed.pivot.y + placed.sub.y} };
+        int seedCount = inBounds(seeds[1].x, seeds[1].y) ? 2 : 1;
+        chain::ChainOutcome outcome = chain::resolve(trial.g, seeds, seedCount, board.score, board.level);
+        if(trial.isGameOver()) continue;
+
+        double value = outcome.score - board.score;
+        for(int x = 0; x < COLS; x++) {
+            int h = ai::columnHeight(trial, x);
+            value -= h * h * 0.5;
+        }
+        if(value > bestValue) {
+            bestValue = value;
+            best = action;
+        }
+    }
+    return best;
+}
+
+struct Match;
+
+struct Connection {
+    int fd = -1;
+    bool tcp = false;
+    vector<uint8_t> in;
+    vector<uint8_t> out;
+    size_t outPos = 0;
+    bool wantWrite = false;
+    Match* match = nullptr;
+    int slot = 0;
+    uint8_t control = 0;          // HELLO의 조작 방식: 맞지 않는 PLACE/INPUT은 버림
+};
+
+struct Player {
+    Connection* conn = nullptr;   // nullptr이면 서버 봇 (또는 연결이 끊긴 자리)
+    bool remote = false;
+    BoardCore board;
+    PuyoRng rng;
+    PuyoPair cur, next;
+    uint32_t pieceIndex = 0;
+    int gravity = 0;
+    int think = 0;
+    bool alive = true;
+    uint8_t lastChain = 0;
+
+    // 이벤트 루프가 채우고 다음 틱에 작업 스레드가 적용
+    int pendingAction = -1;
+    uint32_t pendingPiece = 0;
+    uint8_t pendingInput = 0;
+    uint64_t pendingSince = 0;
+
+    net::PlayerView sent;
+
+    net::PlayerView view() const {
+        net::PlayerView v;
+        v.g = board.g;
+        v.score = static_cast<uint32_t>(board.score);
+        v.chain = lastChain;
+        v.pieceIndex = pieceIndex;
+        if(alive) {
+            v.px = static_cast<int8_t>(cur.pivot.x);
+            v.py = static_cast<int8_t>(cur.pivot.y);
+            v.orientation = net::orientationOf(cur.sub);
+            v.c1 = cur.c1;
+            v.c2 = cur.c2;
+        }
+        return v;
+    }
+};
+
+struct Match {
+    uint32_t id = 0;
+    uint32_t seed = 0;
+    uint32_t tick = 0;
+    array<Player, 2> players;
+    bool finished = false;
+    vector<uint8_t> out;   // 이번 틱에 두 자리 모두에게 보낼 프레임
+    int frames = 0;
+
+    Match(uint32_t matchId, uint32_t s) : id(matchId), seed(s) {
+        // 두 플레이어가 같은 순서의 뿌요를 받음
+        for(auto& p : players) {
+            p.rng.reseed(seed);
+            p.cur = makeSpawnPair(p.rng);
+            p.next = makeSpawnPair(p.rng);
+        }
+    }
+};
+
+// 잠금 후 연쇄를 끝까지 처리하고 다음 조각을 꺼냄
+void settle(Player& p) {
+    uint64_t start = metrics::nowNanos();
+    p.lastChain = static_cast<uint8_t>(p.board.resolveChains());
+    serverMetrics.chain.record(metrics::nowNanos() - start);
+    p.cur = p.next;
+    p.next = makeSpawnPair(p.rng);
+    p.pieceIndex++;
+    p.gravity = 0;
+    p.think = 0;
+    if(p.board.isGameOver()) p.alive = false;
+}
+
+void stepPlayer(Player& p, const ServerOptions& opt, uint64_t now) {
+    if(!p.alive) return;
+
+    if(!p.remote) {
+        if(++p.think < opt.botThinkTicks) return;
+        static const ai::EvalWeights weights = ai::EvalWeights::defaults();
+        int action = opt.aiBot ? ai::choosePlacement(p.board, p.cur, weights) : greedyPlacement(p.board, p.cur);
+        dropPlacement(p.board, p.cur, action / COLS, action % COLS);
+        settle(p);
+        return;
+    }
+
+    if(p.pendingAction >= 0) {
+        // 다른 조각에 대한 늦은 배치는 버림
+        if(p.pendingPiece == p.pieceIndex) {
+            dropPlacement(p.board, p.cur, p.pendingAction / COLS, p.pendingAction % COLS);
+            serverMetrics.input.record(now - p.pendingSince);
+            settle(p);
+        }
+        p.pendingAction = -1;
+        p.pendingInput = 0;
+        return;
+    }
+
+    uint8_t buttons = p.pendingInput;
+    if(buttons) {
+        if((buttons & net::BTN_LEFT) && canMove(p.board, p.cur, -1, 0)) p.cur.pivot.x--;
+        if((buttons & net::BTN_RIGHT) && canMove(p.board, p.cur, +1, 0)) p.cur.pivot.x++;
+        if(buttons & (net::BTN_ROTATE_CW | net::BTN_ROTATE_CCW)) tryRotate(p.board, p.cur, (buttons & net::BTN_ROTATE_CW) != 0);
+        serverMetrics.input.record(now - p.pendingSince);
+        p.pendingInput = 0;
+    }
+
+    int interval = (buttons & net::BTN_SOFT_DROP) ? 1 : max(1, static_cast<int>(p.board.getFallSpeed() * opt.tickHz));
+    if(++p.gravity >= interval) {
+        p.gravity = 0;
+        if(canMove(p.board, p.cur, 0, +1)) {
+            p.cur.pivot.y++;
+        } else {
+            p.board.lock(p.cur);
+            settle(p);
+        }
+    }
+}
+
+void stepMatch(Match& m, const ServerOptions& opt, uint64_t now) {
+    m.tick++;
+    for(auto& p : m.players) stepPlayer(p, opt, now);
+    for(uint8_t slot = 0; slot < 2; slot++) {
+        if(net::writeDelta(m.out, m.tick, slot, m.players[slot].view(), m.players[slot].sent)) m.frames++;
+    }
+
+    bool dead0 = !m.players[0].alive, dead1 = !m.players[1].alive;
+    if(!dead0 && !dead1 && static_cast<int>(m.tick) < opt.maxTicks) return;
+
+    uint32_t s0 = static_cast<uint32_t>(m.players[0].board.score);
+    uint32_t s1 = static_cast<uint32_t>(m.players[1].board.score);
+    uint8_t winner;
+    if(dead0 != dead1) winner = dead0 ? 1 : 0;
+    else winner = s0 > s1 ? 0 : (s1 > s0 ? 1 : 2);
+    net::FrameWriter(m.out).begin(net::MSG_END).put(m.id).put(winner).put(s0).put(s1).put(m.tick).end();
+    m.frames++;
+    m.finished = true;
+}
+
+// 틱마다 같은 작업을 모든 스레드가 나눠 처리 (호출 스레드도 0번 작업자로 참여)
+class TickPool {
+private:
+    vector<thread> workers;
+    mutex m;
+    condition_variable startCv, doneCv;
+    function<void(int)> job;
+    uint64_t generation = 0;
+    int running = 0;
+    bool quit = false;
+
+public:
+    explicit TickPool(int threadCount) {
+        for(int i = 1; i < threadCount; i++) {
+            workers.emplace_back([this, i] {
+                uint64_t seen = 0;
+                while(true) {
+                    unique_lock<mutex> lock(m);
+                    startCv.wait(lock, [&] { return quit || generation != seen; });
+                    if(quit) return;
+                    seen = generation;
+                    lock.unlock();
+                    job(i);
+                    lock.lock();
+                    if(--running == 0) doneCv.notify_one();
+                }
+            });
+        }
+    }
+
+    ~TickPool() {
+        {
+            lock_guard<mutex> lock(m);
+            quit = true;
+        }
+        startCv.notify_all();
+        for(auto& w : workers) w.join();
+    }
+
+    int size() const { return static_cast<int>(workers.size()) + 1; }
+
+    void run(function<void(int)> fn) {
+        {
+            lock_guard<mutex> lock(m);
+            job = std::move(fn);
+            running = static_cast<int>(workers.size());
+            generation++;
+        }
+        startCv.notify_all();
+        job(0);
+        unique_lock<mutex> lock(m);
+        doneCv.wait(lock, [&] { return running == 0; });
+    }
+};
+
+struct ServerStats {
+    uint64_t messagesIn = 0, messagesOut = 0;
+    uint64_t bytesIn = 0, bytesOut = 0;
+    uint64_t matchesStarted = 0, matchesFinished = 0;
+    uint64_t ticks = 0, lateTicks = 0;
+    // 지난 출력 때의 serverMetrics.tick / input 스냅샷
+    vector<uint64_t> tickSeen, inputSeen;
+};
+
+class Server {
+private:
+    const ServerOptions& opt;
+    int epfd = -1;
+    int unixFd = -1, tcpFd = -1, timerFd = -1;
+    unordered_map<int, unique_ptr<Connection>> conns;
+    vector<unique_ptr<Match>> matches;
+    Connection* waiting = nullptr;   // 다른 클라이언트를 기다리는 연결
+    uint32_t nextMatchId = 1;
+    TickPool pool;
+    ServerStats stats;
+
+    static const size_t MAX_PENDING_OUT = 1 << 20;   // 이보다 못 읽어 가는 클라이언트는 끊음
+
+public:
+    explicit Server(const ServerOptions& o)
+        : opt(o), pool(o.threads > 0 ? o.threads : max(1u, thread::hardware_concurrency())) {}
+
+    ~Server() {
+        for(auto& kv : conns) close(kv.first);
+        for(int fd : {unixFd, tcpFd, timerFd, epfd}) {
+            if(fd >= 0) close(fd);
+        }
+        if(unixFd >= 0) unlink(opt.unixPath.c_str());
+    }
+
+    bool start() {
+        epfd = epoll_create1(EPOLL_CLOEXEC);
+        if(epfd < 0) return false;
+
+        if(!opt.unixPath.empty()) {
+            unixFd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+            sockaddr_un addr{};
+            addr.sun_family = AF_UNIX;
+            if(opt.unixPath.size() >= sizeof(addr.sun_path)) return false;
+            strcpy(addr.sun_path, opt.unixPath.c_str());
+            unlink(opt.unixPath.c_str());
+            if(unixFd < 0 || bind(unixFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 ||
+               listen(unixFd, 512) < 0) {
+                perror("unix socket");
+                return false;
+            }
+            watch(unixFd, EPOLLIN);
+        }
+        if(opt.tcpPort > 0) {
+            tcpFd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+            int one = 1;
+            setsockopt(tcpFd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+            sockaddr_in addr{};
+            addr.sin_family = AF_INET;
+            addr.sin_port = htons(static_cast<uint16_t>(opt.tcpPort));
+            addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);   // 내부 사다리용: 로컬에서만
+            if(tcpFd < 0 || bind(tcpFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 ||
+               listen(tcpFd, 512) < 0) {
+                perror("tcp socket");
+                return false;
+            }
+            watch(tcpFd, EPOLLIN);
+        }
+
+        timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+        if(timerFd < 0) return false;
+        long period = 1000000000L / max(1, opt.tickHz);
+        itimerspec spec{};
+        spec.it_interval.tv_sec = period / 1000000000L;   // tv_nsec는 1초 미만이어야 함 (--tick-hz=1)
+        spec.it_interval.tv_nsec = period % 1000000000L;
+        spec.it_value = spec.it_interval;
+        if(timerfd_settime(timerFd, 0, &spec, nullptr) < 0) {
+            perror("timerfd_settime");
+            return false;
+        }
+        watch(timerFd, EPOLLIN);
+
+        for(int i = 0; i < opt.botMatches; i++) createMatch(nullptr, nullptr);
+        return true;
+    }
+
+    void run() {
+        uint64_t startTime = nowNanos();
+        uint64_t lastStats = startTime;
+        ServerStats lastTotals = stats;
+        epoll_event events[256];
+
+        while(!stopRequested) {
+            int n = epoll_wait(epfd, events, 256, 100);
+            if(n < 0 && errno != EINTR) break;
+            for(int i = 0; i < n; i++) {
+                int fd = events[i].data.fd;
+                if(fd == unixFd || fd == tcpFd) acceptAll(fd);
+                else if(fd == timerFd) onTimer();
+                else onConnection(fd, events[i].events);
+            }
+
+            uint64_t now = nowNanos();
+            if((now - lastStats) / 1e9 >= opt.statsInterval) {
+                printStats((now - lastStats) / 1e9, (now - startTime) / 1e9, lastTotals);
+                lastTotals = stats;
+                lastStats = now;
+            }
+            if(opt.duration > 0 && (now - startTime) / 1e9 >= opt.duration) break;
+        }
+    }
+
+private:
+    void watch(int fd, uint32_t events) {
+        epoll_event ev{};
+        ev.events = events;
+        ev.data.fd = fd;
+        epoll_ctl(epfd, EPOLL_CTL_ADD, fd, &ev);
+    }
+
+    void acceptAll(int listenFd) {
+        while(true) {
+            int fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if(fd < 0) return;
+            auto conn = make_unique<Connection>();
+            conn->fd = fd;
+            conn->tcp = listenFd == tcpFd;
+            if(conn->tcp) {
+                int one = 1;
+                setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+            }
+            watch(fd, EPOLLIN | EPOLLRDHUP);
+            conns[fd] = std::move(conn);
+        }
+    }
+
+    void onConnection(int fd, uint32_t events) {
+        auto it = conns.find(fd);
+        if(it == conns.end()) return;
+        Connection& c = *it->second;
+
+        if(events & EPOLLOUT) flush(c);
+        if(events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) {
+            uint8_t buf[16384];
+            bool closed = (events & (EPOLLHUP | EPOLLERR)) != 0;
+            while(true) {
+                ssize_t got = read(fd, buf, sizeof(buf));
+                if(got > 0) {
+                    c.in.insert(c.in.end(), buf, buf + got);
+                    stats.bytesIn += got;
+                    serverMetrics.bytesIn.add(static_cast<uint64_t>(got));
+                } else {
+                    if(got == 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) closed = true;
+                    break;
+                }
+            }
+            if(!parseFrames(c) || closed) {
+                drop(fd);
+                return;
+            }
+        }
+    }
+
+    bool parseFrames(Connection& c) {
+        uint64_t received = nowNanos();
+        size_t pos = 0;
+        while(true) {
+            net::MessageType type;
+            const uint8_t* payload;
+            size_t size;
+            int used = net::nextFrame(c.in.data() + pos, c.in.size() - pos, type, payload, size);
+            if(used < 0) return false;
+            if(used == 0) break;
+            pos += used;
+            stats.messagesIn++;
+            serverMetrics.messagesIn.add();
+            handle(c, type, net::PayloadReader(payload, size), received);
+        }
+        c.in.erase(c.in.begin(), c.in.begin() + pos);
+        return true;
+    }
+
+    void handle(Connection& c, net::MessageType type, net::PayloadReader r, uint64_t received) {
+        Player* p = c.match ? &c.match->players[c.slot] : nullptr;
+        switch(type) {
+        case net::MSG_HELLO: {
+            uint8_t opponent = r.get<uint8_t>();
+            uint8_t control = r.get<uint8_t>();
+            if(!r.ok || control > 1 || c.match || waiting == &c) break;
+            c.control = control;
+            if(opponent == 0) createMatch(&c, nullptr);
+            else if(waiting) {
+                Connection* other = waiting;
+                waiting = nullptr;
+                createMatch(other, &c);
+            } else {
+                waiting = &c;
+            }
+            break;
+        }
+        case net::MSG_PLACE: {
+            uint32_t piece = r.get<uint32_t>();
+            uint8_t action = r.get<uint8_t>();
+            if(p && r.ok && c.control == 0 && action < NUM_PLACEMENTS) {
+                p->pendingAction = action;
+                p->pendingPiece = piece;
+                p->pendingSince = received;
+            }
+            break;
+        }
+        case net::MSG_INPUT: {
+            uint8_t buttons = r.get<uint8_t>();
+            if(p && r.ok && c.control == 1) {
+                if(!p->pendingInput) p->pendingSince = received;
+                p->pendingInput |= buttons;
+            }
+            break;
+        }
+        case net::MSG_PING: {
+            uint64_t stamp = r.get<uint64_t>();
+            net::FrameWriter(c.out).begin(net::MSG_PONG).put(stamp).end();
+            stats.messagesOut++;
+            flush(c);
+            break;
+        }
+        default:
+            break;
+        }
+    }
+
+    // a, b 중 nullptr인 자리는 서버 봇
+    void createMatch(Connection* a, Connection* b) {
+        uint32_t id = nextMatchId++;
+        auto m = make_unique<Match>(id, static_cast<uint32_t>(mix(id)));
+        Connection* seats[2] = {a, b};
+        for(int slot = 0; slot < 2; slot++) {
+            Connection* c = seats[slot];
+            m->players[slot].conn = c;
+            m->players[slot].remote = c != nullptr;
+            m->players[slot].think = -static_cast<int>((id * 2 + slot) % opt.botThinkTicks);   // 봇 계산이 한 틱에 몰리지 않게
+            if(!c) continue;
+            c->match = m.get();
+            c->slot = slot;
+            net::FrameWriter(c->out).begin(net::MSG_START).put(id).put(m->seed)
+                .put(static_cast<uint8_t>(slot)).put(static_cast<uint16_t>(opt.tickHz)).end();
+            stats.messagesOut++;
+            flush(*c);
+        }
+        matches.push_back(std::move(m));
+        stats.matchesStarted++;
+        serverMetrics.matchesStarted.add();
+    }
+
+    static uint64_t mix(uint64_t z) {
+        z += 0x9e3779b97f4a7c15ull;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        return z ^ (z >> 31);
+    }
+
+    void onTimer() {
+        uint64_t expirations = 0;
+        if(read(timerFd, &expirations, sizeof(expirations)) != sizeof(expirations)) return;
+        if(expirations > 1) {
+            stats.lateTicks += expirations - 1;   // 밀린 틱은 건너뜀
+            serverMetrics.lateTicks.add(expirations - 1);
+        }
+
+        uint64_t start = nowNanos();
+        atomic<size_t> next{0};
+        pool.run([&](int) {
+            for(size_t i = next.fetch_add(1); i < matches.size(); i = next.fetch_add(1)) {
+                stepMatch(*matches[i], opt, start);
+            }
+        });
+
+        // 모은 프레임을 두 자리에 보내고, 끝난 대전 정리
+        int botRestarts = 0;
+        for(auto& m : matches) {
+            if(!m->out.empty()) {
+                for(auto& p : m->players) {
+                    if(!p.conn) continue;
+                    p.conn->out.insert(p.conn->out.end(), m->out.begin(), m->out.end());
+                    stats.messagesOut += m->frames;
+                }
+                m->out.clear();
+                m->frames = 0;
+            }
+            if(m->finished) {
+                bool botOnly = !m->players[0].remote && !m->players[1].remote;
+                if(botOnly) botRestarts++;
+                for(auto& p : m->players) {
+                    if(p.conn) p.conn->match = nullptr;
+                }
+                stats.matchesFinished++;
+                serverMetrics.matchesFinished.add();
+            }
+        }
+        matches.erase(remove_if(matches.begin(), matches.end(), [](const unique_ptr<Match>& m) { return m->finished; }),
+                      matches.end());
+        for(int i = 0; i < botRestarts; i++) createMatch(nullptr, nullptr);
+
+        vector<int> slow;
+        for(auto& kv : conns) {
+            Connection& c = *kv.second;
+            if(c.out.size() > c.outPos) flush(c);
+            if(c.out.size() - c.outPos > MAX_PENDING_OUT) slow.push_back(kv.first);
+        }
+        for(int fd : slow) drop(fd);
+
+        stats.ticks++;
+        uint64_t tickNanos = nowNanos() - start;
+        serverMetrics.ticks.add();
+        serverMetrics.tick.record(tickNanos);
+        serverMetrics.connections.set(static_cast<int64_t>(conns.size()));
+        serverMetrics.liveMatches.set(static_cast<int64_t>(matches.size()));
+    }
+
+    void flush(Connection& c) {
+        while(c.outPos < c.out.size()) {
+            ssize_t sent = send(c.fd, c.out.data() + c.outPos, c.out.size() - c.outPos, MSG_NOSIGNAL);
+            if(sent <= 0) break;
+            c.outPos += sent;
+            stats.bytesOut += sent;
+            serverMetrics.bytesOut.add(static_cast<uint64_t>(sent));
+        }
+        if(c.outPos == c.out.size()) {
+            c.out.clear();
+            c.outPos = 0;
+        }
+        bool pending = !c.out.empty();
+        if(pending != c.wantWrite) {
+            c.wantWrite = pending;
+            epoll_event ev{};
+            ev.events = EPOLLIN | EPOLLRDHUP | (pending ? static_cast<uint32_t>(EPOLLOUT) : 0u);
+            ev.data.fd = c.fd;
+            epoll_ctl(epfd, EPOLL_CTL_MOD, c.fd, &ev);
+        }
+    }
+
+    // 연결이 끊기면 그 자리는 기권 (대전은 다음 틱에 끝남)
+    void drop(int fd) {
+        auto it = conns.find(fd);
+        if(it == conns.end()) return;
+        Connection* c = it->second.get();
+        if(waiting == c) waiting = nullptr;
+        if(c->match) {
+            Player& p = c->match->players[c->slot];
+            p.conn = nullptr;
+            p.alive = false;
+        }
+        epoll_ctl(epfd, EPOLL_CTL_DEL, fd, nullptr);
+        close(fd);
+        conns.erase(it);
+    }
+
+    void printStats(double interval, double elapsed, const ServerStats& last) {
+        double finishedRate = (stats.matchesFinished - last.matchesFinished) / interval;
+        printf("[server] %.0fs conns=%zu matches=%zu finished=%llu (%.1f/s) msgs in=%.0f/s out=%.0f/s "
+               "%.0f KB/s out, ticks=%llu late=%llu\n",
+               elapsed, conns.size(), matches.size(), (unsigned long long)stats.matchesFinished, finishedRate,
+               (stats.messagesIn - last.messagesIn) / interval, (stats.messagesOut - last.messagesOut) / interval,
+               (stats.bytesOut - last.bytesOut) / interval / 1024.0, (unsigned long long)stats.ticks,
+               (unsigned long long)stats.lateTicks);
+        vector<uint64_t> tick, input;
+        bucketsSince(serverMetrics.tick, stats.tickSeen, tick);
+        bucketsSince(serverMetrics.input, stats.inputSeen, input);
+        uint64_t inputCount = 0;
+        for(uint64_t b : input) inputCount += b;
+        using H = metrics::Histogram;
+        printf("[server]   tick p50=%.0fus p99=%.0fus, input->applied p50=%.0fus p99=%.0fus (%llu)\n",
+               H::percentile(tick, 0.5) / 1000.0, H::percentile(tick, 0.99) / 1000.0,
+               H::percentile(input, 0.5) / 1000.0, H::percentile(input, 0.99) / 1000.0,
+               (unsigned long long)inputCount);
+        fflush(stdout);
+    }
+};
+
+// ---- 부하 클라이언트: 연결 여러 개를 한 스레드에서 돌리며 DELTA로 보드를 재구성해 배치를 보냄 ----
+struct ClientConn {
+    int fd = -1;
+    vector<uint8_t> in, out;
+    size_t outPos = 0;
+    uint8_t slot = 0;
+    bool inMatch = false;
+    net::PlayerView views[2];
+    uint32_t lastPlaced = UINT32_MAX;
+    uint64_t placeSentAt = 0;
+};
+
+int connectTo(const string& addr) {
+    int fd = -1;
+    if(addr.rfind("unix:", 0) == 0) {
+        fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if(fd < 0) return -1;
+        sockaddr_un sa{};
+        sa.sun_family = AF_UNIX;
+        strncpy(sa.sun_path, addr.c_str() + 5, sizeof(sa.sun_path) - 1);
+        if(connect(fd, reinterpret_cast<sockaddr*>(&sa), sizeof(sa)) < 0) {
+            close(fd);
+            return -1;
+        }
+    } else if(addr.rfind("tcp:", 0) == 0) {
+        fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if(fd < 0) return -1;
+        sockaddr_in sa{};
+        sa.sin_family = AF_INET;
+        sa.sin_port = htons(static_cast<uint16_t>(atoi(addr.c_str() + 4)));
+        sa.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if(connect(fd, reinterpret_cast<sockaddr*>(&sa), sizeof(sa)) < 0) {
+            close(fd);
+            return -1;
+        }
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    }
+    return fd;
+}
+
+int runClients(const ServerOptions& opt) {
+    int epfd = epoll_create1(EPOLL_CLOEXEC);
+    vector<ClientConn> clients(opt.clients);
+    auto sendHello = [&](ClientConn& c) {
+        net::FrameWriter(c.out).begin(net::MSG_HELLO).put(static_cast<uint8_t>(opt.vsBot ? 0 : 1))
+            .put(static_cast<uint8_t>(0)).end();
+    };
+    auto flush = [&](ClientConn& c) {
+        while(c.outPos < c.out.size()) {
+            ssize_t sent = send(c.fd, c.out.data() + c.outPos, c.out.size() - c.outPos, MSG_NOSIGNAL);
+            if(sent <= 0) break;
+            c.outPos += sent;
+        }
+        if(c.outPos == c.out.size()) {
+            c.out.clear();
+            c.outPos = 0;
+        }
+    };
+
+    for(size_t i = 0; i < clients.size(); i++) {
+        ClientConn& c = clients[i];
+        c.fd = connectTo(opt.connectAddr);
+        if(c.fd < 0) {
+            fprintf(stderr, "cannot connect to %s\n", opt.connectAddr.c_str());
+            return 1;
+        }
+        fcntl(c.fd, F_SETFL, fcntl(c.fd, F_GETFL) | O_NONBLOCK);
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.u64 = i;
+        epoll_ctl(epfd, EPOLL_CTL_ADD, c.fd, &ev);
+        sendHello(c);
+        flush(c);
+    }
+
+    metrics::Histogram placeRtt;
+    uint64_t matches = 0, placements = 0, deltas = 0, bytes = 0;
+    uint64_t start = nowNanos();
+    epoll_event events[256];
+    while(!stopRequested && (opt.duration <= 0 || (nowNanos() - start) / 1e9 < opt.duration)) {
+        int n = epoll_wait(epfd, events, 256, 100);
+        for(int e = 0; e < n; e++) {
+            ClientConn& c = clients[events[e].data.u64];
+            uint8_t buf[16384];
+            ssize_t got;
+            while((got = read(c.fd, buf, sizeof(buf))) > 0) {
+                c.in.insert(c.in.end(), buf, buf + got);
+                bytes += got;
+            }
+            if(got == 0) {
+                fprintf(stderr, "server closed the connection\n");
+                return 1;
+            }
+
+            size_t pos = 0;
+            while(true) {
+                net::MessageType type;
+                const uint8_t* payload;
+                size_t size;
+                int used = net::nextFrame(c.in.data() + pos, c.in.size() - pos, type, payload, size);
+                if(used <= 0) break;
+                pos += used;
+                uint64_t now = nowNanos();
+                if(type == net::MSG_START) {
+                    net::PayloadReader r(payload, size);
+                    r.get<uint32_t>();
+                    r.get<uint32_t>();
+                    c.slot = r.get<uint8_t>();
+                    c.inMatch = true;
+                    c.views[0] = c.views[1] = net::PlayerView();
+                    c.lastPlaced = UINT32_MAX;
+                    c.placeSentAt = 0;
+                } else if(type == net::MSG_DELTA) {
+                    deltas++;
+                    uint32_t tick;
+                    uint8_t slot;
+                    if(size < 5) continue;
+                    net::PayloadReader peek(payload + 4, size - 4);
+                    uint8_t who = peek.get<uint8_t>();
+                    if(who > 1 || !net::applyDelta(payload, size, tick, slot, c.views[who])) continue;
+                    const net::PlayerView& v = c.views[slot];
+                    if(slot != c.slot || v.c1 == EMPTY || v.pieceIndex == c.lastPlaced) continue;
+                    if(c.placeSentAt) {
+                        placeRtt.record(now - c.placeSentAt);
+                        c.placeSentAt = 0;
+                    }
+                    // 재구성한 보드로 배치를 골라 보냄
+                    BoardCore board;
+                    board.g = v.g;
+                    PuyoPair cur;
+                    cur.pivot = {v.px, v.py};
+                    cur.sub = orientationOffset(v.orientation);
+                    cur.c1 = v.c1;
+                    cur.c2 = v.c2;
+                    int action = greedyPlacement(board, cur);
+                    net::FrameWriter(c.out).begin(net::MSG_PLACE).put(v.pieceIndex)
+                        .put(static_cast<uint8_t>(action)).end();
+                    c.lastPlaced = v.pieceIndex;
+                    c.placeSentAt = now;
+                    placements++;
+                } else if(type == net::MSG_END) {
+                    matches++;
+                    c.inMatch = false;
+                    sendHello(c);
+                }
+            }
+            c.in.erase(c.in.begin(), c.in.begin() + pos);
+            flush(c);
+        }
+    }
+
+    double elapsed = (nowNanos() - start) / 1e9;
+    printf("%d clients, %.1fs: %llu matches (%.1f/s), %llu placements (%.0f/s), %llu deltas, %.0f KB/s in\n",
+           opt.clients, elapsed, (unsigned long long)matches, matches / elapsed, (unsigned long long)placements,
+           placements / elapsed, (unsigned long long)deltas, bytes / elapsed / 1024.0);
+    vector<uint64_t> rtt;
+    uint64_t rttSum;
+    placeRtt.snapshot(rtt, rttSum);
+    printf("place -> next piece p50=%.0fus p99=%.0fus\n", metrics::Histogram::percentile(rtt, 0.5) / 1000.0,
+           metrics::Histogram::percentile(rtt, 0.99) / 1000.0);
+    for(auto& c : clients) close(c.fd);
+    close(epfd);
+    return 0;
+}
+
+void onSignal(int) { stopRequested = 1; }
+
+int main(int argc, char** argv) {
+    ServerOptions opt;
+    for(int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        auto value = [&](const char* name) -> const char* {
+            size_t n = strlen(name);
+            return strncmp(arg, name, n) == 0 && arg[n] == '=' ? arg + n + 1 : nullptr;
+        };
+        if(const char* v = value("--unix")) opt.unixPath = v;
+        else if(const char* v = value("--tcp")) opt.tcpPort = atoi(v);
+        else if(const char* v = value("--tick-hz")) opt.tickHz = min(max(1, atoi(v)), 1000);
+        else if(const char* v = value("--threads")) opt.threads = atoi(v);
+        else if(const char* v = value("--bot-matches")) opt.botMatches = max(0, atoi(v));
+        else if(const char* v = value("--bot")) opt.aiBot = strcmp(v, "ai") == 0;
+        else if(const char* v = value("--bot-think")) opt.botThinkTicks = max(1, atoi(v));
+        else if(const char* v = value("--max-ticks")) opt.maxTicks = max(1, atoi(v));
+        else if(const char* v = value("--stats")) opt.statsInterval = max(0.1, atof(v));
+        else if(const char* v = value("--metrics")) opt.metricsPort = atoi(v);
+        else if(const char* v = value("--duration")) opt.duration = atof(v);
+        else if(const char* v = value("--client")) opt.connectAddr = v;
+        else if(const char* v = value("--clients")) opt.clients = max(1, atoi(v));
+        else if(strcmp(arg, "--vs-bot") == 0) opt.vsBot = true;
+        else {
+            fprintf(stderr,
+                    "usage: %s [--unix=PATH] [--tcp=PORT] [--tick-hz=N] [--threads=N] [--bot-matches=N]\n"
+                    "          [--bot=greedy|ai] [--bot-think=TICKS] [--max-ticks=N] [--stats=SEC] [--duration=SEC]\n"
+                    "          [--metrics=PORT]\n"
+                    "       %s --client=unix:PATH|tcp:PORT --clients=N [--vs-bot] [--duration=SEC]\n", argv[0], argv[0]);
+            return 2;
+        }
+    }
+    signal(SIGINT, onSignal);
+    signal(SIGTERM, onSignal);
+
+    if(!opt.connectAddr.empty()) {
+        opt.clients = max(1, opt.clients);
+        return runClients(opt);
+    }
+    if(opt.unixPath.empty() && opt.tcpPort == 0 && opt.botMatches == 0) {
+        fprintf(stderr, "nothing to serve (use --unix=PATH, --tcp=PORT or --bot-matches=N)\n");
+        return 2;
+    }
+
+    Server server(opt);
+    if(!server.start()) {
+        fprintf(stderr, "[server] startup failed\n");
+        return 1;
+    }
+    printf("[server] listening%s%s%s, %d Hz\n", opt.unixPath.empty() ? "" : " unix:", opt.unixPath.c_str(),
+           opt.tcpPort ? (" tcp:127.0.0.1:" + to_string(opt.tcpPort)).c_str() : "", opt.tickHz);
+    metrics::HttpExporter metricsHttp;
+    if(opt.metricsPort > 0) {
+        if(metricsHttp.start(serverMetrics.registry, opt.metricsPort))
+            printf("[server] metrics on http://127.0.0.1:%d/metrics\n", opt.metricsPort);
+        else
+            fprintf(stderr, "[server] cannot listen for metrics on 127.0.0.1:%d\n", opt.metricsPort);
+    }
+    fflush(stdout);
+    server.run();
+    return 0;
+}
@@ -0,0 +1,259 @@
+#pragma once
+// ---- 학습 데이터 샤드 포맷 (고정 길이 비트 패킹 레코드) ----
+// 파일 = 64바이트 헤더 + RECORD_SIZE 바이트 레코드 * recordCount
+// 레코드는 고정 길이라서 압축된 상태 그대로 임의 위치에 접근 가능
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "puyo_core.hpp"
+#include "mapped_file.hpp"
+
+namespace shard {
+
+static const char MAGIC[8] = {'P','U','Y','O','S','H','D','1'};
+static const std::uint32_t VERSION = 1;
+static const int HEADER_SIZE = 64;
+static const int CELL_BITS = 3;                                  // EMPTY + 5색 = 3비트
+static const int BOARD_BYTES = (ROWS * COLS * CELL_BITS + 7) / 8; // 27바이트
+static const int RECORD_SIZE = BOARD_BYTES + 13;                 // 40바이트
+
+// 레코드 바이트 배치 (리틀 엔디언)
+//   [0, 27)  보드 셀 3비트씩, 행 우선
+//   27       현재 쌍 c1 | c2 << 4
+//   28       다음 쌍 c1 | c2 << 4
+//   29       배치 (orientation * COLS + column)
+//   30       연쇄 수 (255로 포화)
+//   31       bit0: 게임 오버, bit1-5: 배치 전 레벨
+//   32..35   획득 점수
+//   36..39   게임 번호
+struct Record {
+    std::array<std::array<Color, COLS>, ROWS> g{};
+    Color cur1 = EMPTY, cur2 = EMPTY;
+    Color next1 = EMPTY, next2 = EMPTY;
+    int placement = 0;
+    int chain = 0;
+    int level = 1;
+    bool gameOver = false;
+    std::uint32_t scoreGained = 0;
+    std::uint32_t gameIndex = 0;
+};
+
+inline void putU32(std::uint8_t* p, std::uint32_t v) {
+    p[0] = static_cast<std::uint8_t>(v);
+    p[1] = static_cast<std::uint8_t>(v >> 8);
+    p[2] = static_cast<std::uint8_t>(v >> 16);
+    p[3] = static_cast<std::uint8_t>(v >> 24);
+}
+
+inline std::uint32_t getU32(const std::uint8_t* p) {
+    return std::uint32_t(p[0]) | std::uint32_t(p[1]) << 8 | std::uint32_t(p[2]) << 16 | std::uint32_t(p[3]) << 24;
+}
+
+inline void putU64(std::uint8_t* p, std::uint64_t v) {
+    putU32(p, static_cast<std::uint32_t>(v));
+    putU32(p + 4, static_cast<std::uint32_t>(v >> 32));
+}
+
+inline std::uint64_t getU64(const std::uint8_t* p) {
+    return std::uint64_t(getU32(p)) | std::uint64_t(getU32(p + 4)) << 32;
+}
+
+// 보드만 패킹 (레코드 작성의 대부분을 차지하므로 분리)
+inline void packBoard(const std::array<std::array<Color, COLS>, ROWS>& g, std::uint8_t* out) {
+    std::memset(out, 0, BOARD_BYTES);
+    int bit = 0;
+    for(int y = 0; y < ROWS; ++y) {
+        for(int x = 0; x < COLS; ++x, bit += CELL_BITS) {
+            unsigned v = g[y][x] & 7u;
+            out[bit >> 3] |= static_cast<std::uint8_t>(v << (bit & 7));
+            if((bit & 7) > 8 - CELL_BITS) out[(bit >> 3) + 1] |= static_cast<std::uint8_t>(v >> (8 - (bit & 7)));
+        }
+    }
+}
+
+inline void unpackBoard(const std::uint8_t* in, std::array<std::array<Color, COLS>, ROWS>& g) {
+    int bit = 0;
+    for(int y = 0; y < ROWS; ++y) {
+        for(int x = 0; x < COLS; ++x, bit += CELL_BITS) {
+            unsigned v = in[bit >> 3] >> (bit & 7);
+            if((bit & 7) > 8 - CELL_BITS) v |= unsigned(in[(bit >> 3) + 1]) << (8 - (bit & 7));
+            g[y][x] = static_cast<Color>(v & 7u);
+        }
+    }
+}
+
+inline void encode(const Record& r, std::uint8_t* out) {
+    packBoard(r.g, out);
+    out[BOARD_BYTES + 0] = static_cast<std::uint8_t>(r.cur1 | r.cur2 << 4);
+    out[BOARD_BYTES + 1] = static_cast<std::uint8_t>(r.next1 | r.next2 << 4);
+    out[BOARD_BYTES + 2] = static_cast<std::uint8_t>(r.placement);
+    out[BOARD_BYTES + 3] = static_cast<std::uint8_t>(std::min(r.chain, 255));
+    out[BOARD_BYTES + 4] = static_cast<std::uint8_t>((r.gameOver ? 1 : 0) | (std::min(r.level, 31) << 1));
+    putU32(out + BOARD_BYTES + 5, r.scoreGained);
+    putU32(out + BOARD_BYTES + 9, r.gameIndex);
+}
+
+inline void decode(const std::uint8_t* in, Record& r) {
+    unpackBoard(in, r.g);
+    r.cur1 = static_cast<Color>(in[BOARD_BYTES + 0] & 15);
+    r.cur2 = static_cast<Color>(in[BOARD_BYTES + 0] >> 4);
+    r.next1 = static_cast<Color>(in[BOARD_BYTES + 1] & 15);
+    r.next2 = static_cast<Color>(in[BOARD_BYTES + 1] >> 4);
+    r.placement = in[BOARD_BYTES + 2];
+    r.chain = in[BOARD_BYTES + 3];
+    r.gameOver = (in[BOARD_BYTES + 4] & 1) != 0;
+    r.level = in[BOARD_BYTES + 4] >> 1;
+    r.scoreGained = getU32(in + BOARD_BYTES + 5);
+    r.gameIndex = getU32(in + BOARD_BYTES + 9);
+}
+
+//   [0, 8)   MAGIC
+//   8        VERSION
+//   12       RECORD_SIZE
+//   16       recordCount (샤드를 닫을 때 기록)
+//   24       capacity
+//   32       ROWS, 36 COLS
+inline void writeHeader(std::uint8_t* out, std::uint64_t count, std::uint64_t capacity) {
+    std::memset(out, 0, HEADER_SIZE);
+    std::memcpy(out, MAGIC, sizeof(MAGIC));
+    putU32(out + 8, VERSION);
+    putU32(out + 12, RECORD_SIZE);
+    putU64(out + 16, count);
+    putU64(out + 24, capacity);
+    putU32(out + 32, ROWS);
+    putU32(out + 36, COLS);
+}
+
+// 정해진 레코드 수마다 새 샤드 파일로 넘어가는 순차 기록기 (한 스레드 전용)
+class ShardWriter {
+private:
+    std::string directory;
+    std::string prefix;
+    std::uint64_t capacity;
+    std::vector<char> ioBuffer;
+    FILE* file = nullptr;
+    std::uint64_t countInShard = 0;
+    int shardIndex = 0;
+    std::uint64_t totalRecords = 0;
+    std::vector<std::string> finished;
+
+    bool openNext() {
+        char name[64];
+        std::snprintf(name, sizeof(name), "%s-%05d.bin", prefix.c_str(), shardIndex++);
+        std::string path = directory.empty() ? name : directory + "/" + name;
+        file = std::fopen(path.c_str(), "wb");
+        if(!file) return false;
+        // 기본 버퍼는 작아서 쓰기 호출이 잦아지므로 큰 버퍼를 지정
+        std::setvbuf(file, ioBuffer.data(), _IOFBF, ioBuffer.size());
+        countInShard = 0;
+        finished.push_back(path);
+        std::uint8_t header[HEADER_SIZE];
+        writeHeader(header, 0, capacity);
+        if(std::fwrite(header, 1, HEADER_SIZE, file) != HEADER_SIZE) {
+            abandonCurrent();
+            return false;
+        }
+        return true;
+    }
+
+    // 쓰다 실패한 샤드는 지움 (헤더만 완성된 채 데이터가 잘린 파일을 남기지 않음)
+    void abandonCurrent() {
+        if(file) std::fclose(file);
+        file = nullptr;
+        std::remove(finished.back().c_str());
+        totalRecords -= countInShard;
+        countInShard = 0;
+        finished.pop_back();
+    }
+
+    // 데이터를 모두 내보낸 뒤에 레코드 수를 헤더에 씀. 어느 단계든 실패하면 샤드를 지우고 false
+    bool closeCurrent() {
+        if(!file) return true;
+        std::uint8_t header[HEADER_SIZE];
+        writeHeader(header, countInShard, capacity);
+        bool ok = std::fflush(file) == 0 && std::fseek(file, 0, SEEK_SET) == 0 &&
+                  std::fwrite(header, 1, HEADER_SIZE, file) == HEADER_SIZE;
+        FILE* done = file;
+        file = nullptr;
+        if(std::fclose(done) != 0 || !ok) {
+            abandonCurrent();
+            return false;
+        }
+        return true;
+    }
+
+public:
+    ShardWriter(const std::string& dir, const std::string& namePrefix, std::uint64_t recordsPerShard)
+        : directory(dir), prefix(namePrefix), capacity(std::max<std::uint64_t>(1, recordsPerShard)),
+          ioBuffer(4 << 20) {}
+
+    ~ShardWriter() { close(); }
+
+    // 첫 샤드를 미리 엶 (디렉터리에 쓸 수 없으면 게임을 돌리기 전에 알 수 있도록)
+    bool open() { return file || openNext(); }
+
+    // 레코드 count개를 이어서 기록 (샤드 경계에서 자동으로 분할)
+    bool write(const std::uint8_t* records, std::uint64_t count) {
+        while(count > 0) {
+            if(!file && !openNext()) return false;
+            std::uint64_t n = std::min(count, capacity - countInShard);
+            if(std::fwrite(records, RECORD_SIZE, n, file) != n) {
+                abandonCurrent();
+                return false;
+            }
+            countInShard += n;
+            totalRecords += n;
+            records += n * RECORD_SIZE;
+            count -= n;
+            if(countInShard == capacity && !closeCurrent()) return false;
+        }
+        return true;
+    }
+
+    // 마지막 샤드를 마무리. 실패하면 그 샤드는 지워지고 false
+    bool close() { return closeCurrent(); }
+
+    std::uint64_t recordsWritten() const { return totalRecords; }
+    const std::vector<std::string>& shardPaths() const { return finished; }
+};
+
+// 샤드를 메모리 맵으로 열어 임의 접근 (복사 없이 필요한 레코드만 디코딩)
+class ShardReader {
+private:
+    MappedFile file;
+    std::uint64_t count = 0;
+
+public:
+    bool open(const std::string& path) {
+        count = 0;
+        if(!file.open(path, MappedFile::READ_ONLY)) return false;
+        const std::uint8_t* p = file.data();
+        if(file.size() < static_cast<size_t>(HEADER_SIZE) || std::memcmp(p, MAGIC, sizeof(MAGIC)) != 0 ||
+           getU32(p + 8) != VERSION || getU32(p + 12) != RECORD_SIZE ||
+           getU32(p + 32) != ROWS || getU32(p + 36) != COLS) {
+            file.close();
+            return false;
+        }
+        // 헤더 갱신 전에 중단된 샤드는 파일 크기로 레코드 수를 계산
+        std::uint64_t available = (file.size() - HEADER_SIZE) / RECORD_SIZE;
+        count = getU64(p + 16);
+        if(count == 0 || count > available) count = available;
+        return true;
+    }
+
+    std::uint64_t size() const { return count; }
+
+    const std::uint8_t* raw(std::uint64_t i) const { return file.data() + HEADER_SIZE + i * RECORD_SIZE; }
+
+    void read(std::uint64_t i, Record& r) const { decode(raw(i), r); }
+
+    template<class Rng>
+    std::uint64_t sampleIndex(Rng& gen) const {
+        std::uniform_int_distribution<std::uint64_t> dist(0, count - 1);
+        return dist(gen);
+    }
+};
+
+} // namespace shard
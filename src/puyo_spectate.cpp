@@ -0,0 +1,279 @@
+// ---- 관전 도구 (헤드리스) ----
+// 게임이 --spectate로 공유 메모리 링에 쓰는 스트림을 읽어 터미널에 보드를 그림.
+// --bench는 가상 게임을 링에 쓰면서 읽는 스레드 수를 바꿔 쓰는 쪽 비용이 그대로인지 확인
+//
+//   ./puyo --spectate                     (게임 쪽)
+//   ./puyo_spectate                       (관전, 여러 개 띄워도 됨)
+//   ./puyo_spectate --bench --readers=200 --frames=20000
+//   ./puyo_spectate --bench --ring-bytes=4096         (작은 링: 뒤처진 관전자가 KEYFRAME으로 복구되는지)
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "puyo_stream.hpp"
+
+using namespace std;
+
+struct SpectateOptions {
+    string path = stream::DEFAULT_PATH;
+    bool once = false;
+    bool bench = false;
+    int readers = 64;
+    int frames = 20000;
+    uint64_t ringBytes = 1 << 20;
+    uint32_t seed = 1;
+};
+
+static const char COLOR_CHARS[COLOR_COUNT] = {'.', 'R', 'G', 'B', 'Y', 'P'};
+static const char* const STATE_NAMES[] = {"MENU", "PLAYING", "GAME OVER", "PAUSED", "LEADERBOARD"};
+
+void drawState(const stream::SpectatorReader& reader, const string& lastEvent) {
+    const stream::State& s = reader.current();
+    char cells[ROWS][COLS];
+    for(int y = 0; y < ROWS; y++)
+        for(int x = 0; x < COLS; x++) cells[y][x] = COLOR_CHARS[s.g[y][x]];
+
+    // 조작 중인 쌍은 소문자
+    if(s.c1 != EMPTY) {
+        Vec2 sub = orientationOffset(s.orientation);
+        if(inBounds(s.px, s.py)) cells[s.py][s.px] = static_cast<char>(COLOR_CHARS[s.c1] + 32);
+        if(inBounds(s.px + sub.x, s.py + sub.y)) cells[s.py + sub.y][s.px + sub.x] = static_cast<char>(COLOR_CHARS[s.c2] + 32);
+    }
+
+    string out = "\x1b[H\x1b[2J";
+    char line[128];
+    snprintf(line, sizeof(line), "tick %u  %s  score %u  level %u  chain %u  next %c%c\n", reader.currentTick(),
+             s.gameState < 5 ? STATE_NAMES[s.gameState] : "?", s.score, s.level, s.chain, COLOR_CHARS[s.n1],
+             COLOR_CHARS[s.n2]);
+    out += line;
+    for(int y = 0; y < ROWS; y++) {
+        out += "  |";
+        out.append(cells[y], COLS);
+        out += "|\n";
+    }
+    snprintf(line, sizeof(line), "  lag %llu bytes, %llu records, %llu resyncs\n  %s\n",
+             (unsigned long long)reader.lag(), (unsigned long long)reader.records,
+             (unsigned long long)reader.resyncs, lastEvent.c_str());
+    out += line;
+    fputs(out.c_str(), stdout);
+    fflush(stdout);
+}
+
+string describe(const stream::Event& ev) {
+    char buf[96];
+    switch(ev.kind) {
+    case stream::EV_POP: snprintf(buf, sizeof(buf), "%u CHAIN: %u popped, +%u", ev.a, ev.b, ev.c); break;
+    case stream::EV_LEVEL_UP: snprintf(buf, sizeof(buf), "LEVEL UP -> %u", ev.a); break;
+    case stream::EV_GAME_OVER: snprintf(buf, sizeof(buf), "GAME OVER"); break;
+    case stream::EV_RESET: snprintf(buf, sizeof(buf), "NEW GAME"); break;
+    default: snprintf(buf, sizeof(buf), "event %u", ev.kind); break;
+    }
+    return buf;
+}
+
+int runViewer(const SpectateOptions& opt) {
+    stream::SpectatorReader reader;
+    while(!reader.open(opt.path)) {
+        if(opt.once) {
+            fprintf(stderr, "no stream at %s (start the game with --spectate)\n", opt.path.c_str());
+            return 1;
+        }
+        this_thread::sleep_for(chrono::milliseconds(500));
+    }
+
+    string lastEvent;
+    while(true) {
+        int applied = reader.poll([&](const stream::Event& ev) { lastEvent = describe(ev); });
+        if(opt.once) {
+            if(reader.isSynced()) {
+                drawState(reader, lastEvent);
+                return 0;
+            }
+        } else if(applied > 0 && reader.isSynced()) {
+            drawState(reader, lastEvent);
+        }
+        this_thread::sleep_for(chrono::milliseconds(16));
+    }
+}
+
+// 가상 게임: 틱마다 한 칸씩 떨어지고, 닿으면 잠금 + 연쇄 (실제 게임과 같은 레코드가 나오도록)
+struct FakeGame {
+    BoardCore board;
+    PuyoRng rng;
+    PuyoPair cur, next;
+    uint8_t gameState = 1;
+    int target = 0;
+
+    explicit FakeGame(uint32_t seed) : rng(seed) { reset(); }
+
+    void reset() {
+        board.clear();
+        cur = makeSpawnPair(rng);
+        next = makeSpawnPair(rng);
+        target = static_cast<int>(rng() % COLS);
+    }
+
+    stream::State state() const {
+        stream::State s;
+        s.g = board.g;
+        s.score = static_cast<uint32_t>(board.score);
+        s.level = static_cast<uint8_t>(board.level);
+        s.chain = static_cast<uint8_t>(board.chain);
+        s.gameState = gameState;
+        s.px = static_cast<int8_t>(cur.pivot.x);
+        s.py = static_cast<int8_t>(cur.pivot.y);
+        for(int o = 0; o < NUM_ORIENTATIONS; o++) {
+            Vec2 v = orientationOffset(o);
+            if(v.x == cur.sub.x && v.y == cur.sub.y) s.orientation = static_cast<uint8_t>(o);
+        }
+        s.c1 = cur.c1;
+        s.c2 = cur.c2;
+        s.n1 = next.c1;
+        s.n2 = next.c2;
+        return s;
+    }
+
+    void tick(stream::SpectatorWriter& writer) {
+        if(cur.pivot.x < target && canMove(board, cur, +1, 0)) cur.pivot.x++;
+        else if(cur.pivot.x > target && canMove(board, cur, -1, 0)) cur.pivot.x--;
+        if(canMove(board, cur, 0, +1)) {
+            cur.pivot.y++;
+            return;
+        }
+        board.lock(cur);
+        for(int chainIndex = 1;; chainIndex++) {
+            int removed = board.popGroupsAndScore(chainIndex);
+            if(removed <= 0) break;
+            writer.event(stream::EV_POP, static_cast<uint8_t>(chainIndex), static_cast<uint16_t>(removed),
+                         static_cast<uint32_t>(board.lastPoints));
+            if(board.leveledUp) writer.event(stream::EV_LEVEL_UP, static_cast<uint8_t>(board.level));
+            board.applyGravity();
+        }
+        if(board.isGameOver()) {
+            writer.event(stream::EV_GAME_OVER);
+            writer.event(stream::EV_RESET);
+            reset();
+            return;
+        }
+        cur = next;
+        next = makeSpawnPair(rng);
+        target = static_cast<int>(rng() % COLS);
+    }
+};
+
+struct BenchResult {
+    double meanNanos = 0, p50 = 0, p99 = 0;
+    uint64_t bytes = 0;
+    uint64_t readerRecords = 0, readerResyncs = 0;
+    int mismatches = 0;
+};
+
+BenchResult runBenchOnce(const SpectateOptions& opt, int readerCount) {
+    BenchResult result;
+    stream::SpectatorWriter writer;
+    if(!writer.open(opt.path, opt.ringBytes, 60)) {
+        fprintf(stderr, "cannot create %s\n", opt.path.c_str());
+        exit(1);
+    }
+
+    atomic<bool> done{false};
+    vector<stream::SpectatorReader> readers(readerCount);
+    for(auto& r : readers) r.open(opt.path);
+    vector<thread> threads;
+    for(int i = 0; i < readerCount; i++) {
+        threads.emplace_back([&, i] {
+            // 관전 창처럼 주기적으로 따라잡음
+            while(!done.load(memory_order_acquire)) {
+                readers[i].poll();
+                this_thread::sleep_for(chrono::milliseconds(1));
+            }
+            readers[i].poll();
+        });
+    }
+
+    FakeGame game(opt.seed);
+    vector<uint64_t> samples;
+    samples.reserve(opt.frames);
+    for(int f = 0; f < opt.frames; f++) {
+        auto start = chrono::steady_clock::now();
+        game.tick(writer);
+        writer.publish(game.state());
+        samples.push_back(static_cast<uint64_t>(chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count()));
+        // 실제 게임처럼 프레임 사이에 쉬는 구간 (읽는 쪽이 돌 틈)
+        if(readerCount > 0 && f % 16 == 15) this_thread::sleep_for(chrono::microseconds(200));
+    }
+    done.store(true, memory_order_release);
+    for(auto& t : threads) t.join();
+
+    stream::State final = game.state();
+    for(auto& r : readers) {
+        result.readerRecords += r.records;
+        result.readerResyncs += r.resyncs;
+        const stream::State& s = r.current();
+        bool same = r.isSynced() && s.g == final.g && s.score == final.score && s.px == final.px &&
+                    s.py == final.py && s.c1 == final.c1 && s.c2 == final.c2 && s.n1 == final.n1;
+        if(!same) result.mismatches++;
+    }
+
+    // 게임 로직 시간을 빼기 어렵기 때문에 tick + publish를 함께 잼 (읽는 쪽 수와 무관해야 함)
+    uint64_t total = 0;
+    for(uint64_t s : samples) total += s;
+    sort(samples.begin(), samples.end());
+    result.meanNanos = static_cast<double>(total) / samples.size();
+    result.p50 = static_cast<double>(samples[samples.size() / 2]);
+    result.p99 = static_cast<double>(samples[samples.size() * 99 / 100]);
+    result.bytes = writer.bytesWritten();
+    return result;
+}
+
+int runBench(const SpectateOptions& opt) {
+    printf("%d frames per run, ring %s\n", opt.frames, opt.path.c_str());
+    int bad = 0;
+    for(int readers : {0, opt.readers}) {
+        BenchResult r = runBenchOnce(opt, readers);
+        printf("%4d readers: tick+publish mean %.0f ns, p50 %.0f ns, p99 %.0f ns, %.1f bytes/frame",
+               readers, r.meanNanos, r.p50, r.p99, static_cast<double>(r.bytes) / opt.frames);
+        if(readers > 0) {
+            printf(", %llu records read, %llu resyncs, %d/%d readers off the final state",
+                   (unsigned long long)r.readerRecords, (unsigned long long)r.readerResyncs, r.mismatches, readers);
+            bad += r.mismatches;
+        }
+        printf("\n");
+    }
+    return bad == 0 ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+    SpectateOptions opt;
+    for(int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        auto value = [&](const char* name) -> const char* {
+            size_t n = strlen(name);
+            return strncmp(arg, name, n) == 0 && arg[n] == '=' ? arg + n + 1 : nullptr;
+        };
+        if(const char* v = value("--ring")) opt.path = v;
+        else if(strcmp(arg, "--once") == 0) opt.once = true;
+        else if(strcmp(arg, "--bench") == 0) opt.bench = true;
+        else if(const char* v = value("--readers")) opt.readers = max(1, atoi(v));
+        else if(const char* v = value("--frames")) opt.frames = max(1, atoi(v));
+        else if(const char* v = value("--ring-bytes")) opt.ringBytes = strtoull(v, nullptr, 10);
+        else if(const char* v = value("--seed")) opt.seed = static_cast<uint32_t>(strtoul(v, nullptr, 10));
+        else {
+            fprintf(stderr,
+                    "usage: %s [--ring=PATH] [--once]\n"
+                    "       %s --bench [--ring=PATH] [--readers=N] [--frames=N] [--ring-bytes=N] [--seed=N]\n", argv[0], argv[0]);
+            return 2;
+        }
+    }
+    if(opt.bench) {
+        if(opt.path == stream::DEFAULT_PATH) opt.path += "-bench";   // 실행 중인 게임의 링을 건드리지 않음
+        return runBench(opt);
+    }
+    return runViewer(opt);
+}
@@ -0,0 +1,397 @@
+#pragma once
+// ---- 관전 스트림: 공유 메모리 링 버퍼 (쓰는 쪽 하나, 읽는 쪽 여럿) ----
+// 게임은 틱마다 바뀐 부분(DELTA)과 이펙트 이벤트를 링에 한 번만 쓰고, 관전자 프로세스들은
+// 같은 메모리를 직접 읽음. 구독자가 몇이든 게임 쪽 비용은 같음.
+// 중간에 들어온 관전자는 주기적으로 쓰는 KEYFRAME(전체 상태)에서 시작
+//
+// 파일 = 64바이트 헤더 + 링 (2의 거듭제곱 바이트). 레코드는 8바이트 정렬이며 링 끝을 넘지 않음
+// (남는 칸은 PAD 레코드). 위치는 처음부터 쓴 총 바이트 수 (링 안의 위치 = pos % capacity)
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#include "puyo_core.hpp"
+#include "mapped_file.hpp"
+
+namespace stream {
+
+static const char MAGIC[8] = {'P','U','Y','O','S','T','R','1'};
+static const std::uint32_t VERSION = 1;
+static const int HEADER_SIZE = 64;
+static const int RECORD_HEADER = 12;   // u32 크기, u32 틱, u8 종류, 패딩 3
+static const int MAX_RECORD = 256;
+
+// 게임과 관전 도구의 기본 링 위치 (리눅스는 메모리에만 있는 /dev/shm)
+#ifdef __linux__
+static const char* const DEFAULT_PATH = "/dev/shm/puyo-spectate";
+#else
+static const char* const DEFAULT_PATH = "puyo-spectate.ring";
+#endif
+
+enum RecordType : std::uint8_t { REC_PAD = 0, REC_KEYFRAME = 1, REC_DELTA = 2, REC_EVENT = 3 };
+
+// 이펙트 트리거 (관전 화면이 같은 이펙트를 재생할 수 있도록)
+enum EventKind : std::uint8_t { EV_POP = 1, EV_LEVEL_UP = 2, EV_GAME_OVER = 3, EV_RESET = 4 };
+
+struct Event {
+    std::uint32_t tick = 0;
+    EventKind kind = EV_POP;
+    std::uint8_t a = 0;     // POP: 연쇄 번호, LEVEL_UP: 레벨
+    std::uint16_t b = 0;    // POP: 지운 칸 수
+    std::uint32_t c = 0;    // POP: 얻은 점수
+};
+
+// 관전에 필요한 게임 상태 전체
+struct State {
+    std::array<std::array<Color, COLS>, ROWS> g{};
+    std::uint32_t score = 0;
+    std::uint8_t level = 1;
+    std::uint8_t chain = 0;
+    std::uint8_t gameState = 0;     // main.cpp의 GameState
+    std::int8_t px = 0, py = 0;
+    std::uint8_t orientation = 0;
+    Color c1 = EMPTY, c2 = EMPTY;   // 조작 중인 쌍 (없으면 EMPTY)
+    Color n1 = EMPTY, n2 = EMPTY;   // NEXT
+};
+
+// DELTA에 들어 있는 항목 비트
+enum DeltaField : std::uint8_t {
+    D_SCORE = 1, D_LEVEL = 2, D_CHAIN = 4, D_GAME_STATE = 8, D_PAIR = 16, D_NEXT = 32, D_CELLS = 64
+};
+
+// 헤더 (쓰는 쪽은 reserved를 먼저 올리고 데이터를 쓴 뒤 committed를 올림)
+struct Header {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t keyframeInterval;
+    std::uint64_t capacity;
+    std::atomic<std::uint64_t> committed;     // 읽어도 되는 끝 위치
+    std::atomic<std::uint64_t> reserved;      // 지금 쓰는 중인 레코드의 끝 위치
+    std::atomic<std::uint64_t> lastKeyframe;  // 가장 최근 KEYFRAME 시작 위치
+    std::atomic<std::uint32_t> session;       // 게임을 다시 열 때마다 바뀜
+    std::uint32_t padding[3];
+};
+static_assert(sizeof(Header) == HEADER_SIZE, "stream header must stay 64 bytes");
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "shared-memory counters need lock-free atomics");
+
+// 레코드 페이로드 작성 (고정 크기 버퍼)
+struct RecordBuilder {
+    std::uint8_t buf[MAX_RECORD];
+    int size = RECORD_HEADER;
+
+    template<class T>
+    void put(T v) {
+        std::memcpy(buf + size, &v, sizeof(T));
+        size += sizeof(T);
+    }
+};
+
+inline void putKeyframe(RecordBuilder& r, const State& s) {
+    for(int y = 0; y < ROWS; y++)
+        for(int x = 0; x < COLS; x++) r.put(static_cast<std::uint8_t>(s.g[y][x]));
+    r.put(s.score); r.put(s.level); r.put(s.chain); r.put(s.gameState);
+    r.put(s.px); r.put(s.py); r.put(s.orientation);
+    r.put(static_cast<std::uint8_t>(s.c1)); r.put(static_cast<std::uint8_t>(s.c2));
+    r.put(static_cast<std::uint8_t>(s.n1)); r.put(static_cast<std::uint8_t>(s.n2));
+}
+
+// prev 대비 바뀐 항목만. 바뀐 게 없으면 false
+inline bool putDelta(RecordBuilder& r, const State& s, const State& prev) {
+    std::uint8_t mask = 0;
+    if(s.score != prev.score) mask |= D_SCORE;
+    if(s.level != prev.level) mask |= D_LEVEL;
+    if(s.chain != prev.chain) mask |= D_CHAIN;
+    if(s.gameState != prev.gameState) mask |= D_GAME_STATE;
+    if(s.px != prev.px || s.py != prev.py || s.orientation != prev.orientation || s.c1 != prev.c1 || s.c2 != prev.c2)
+        mask |= D_PAIR;
+    if(s.n1 != prev.n1 || s.n2 != prev.n2) mask |= D_NEXT;
+    std::uint8_t cells[ROWS * COLS];
+    int n = 0;
+    for(int y = 0; y < ROWS; y++)
+        for(int x = 0; x < COLS; x++)
+            if(s.g[y][x] != prev.g[y][x]) cells[n++] = static_cast<std::uint8_t>(y * COLS + x);
+    if(n > 0) mask |= D_CELLS;
+    if(!mask) return false;
+
+    r.put(mask);
+    if(mask & D_SCORE) r.put(s.score);
+    if(mask & D_LEVEL) r.put(s.level);
+    if(mask & D_CHAIN) r.put(s.chain);
+    if(mask & D_GAME_STATE) r.put(s.gameState);
+    if(mask & D_PAIR) {
+        r.put(s.px); r.put(s.py); r.put(s.orientation);
+        r.put(static_cast<std::uint8_t>(s.c1)); r.put(static_cast<std::uint8_t>(s.c2));
+    }
+    if(mask & D_NEXT) {
+        r.put(static_cast<std::uint8_t>(s.n1)); r.put(static_cast<std::uint8_t>(s.n2));
+    }
+    if(mask & D_CELLS) {
+        // 칸 하나 = 칸 번호(7비트) + 색(3비트)을 u16으로 (최대 72칸 * 2 = 144바이트)
+        r.put(static_cast<std::uint8_t>(n));
+        for(int i = 0; i < n; i++) {
+            int cell = cells[i];
+            r.put(static_cast<std::uint16_t>(cell << 3 | s.g[cell / COLS][cell % COLS]));
+        }
+    }
+    return true;
+}
+
+class SpectatorWriter {
+private:
+    MappedFile file;
+    Header* header = nullptr;
+    std::uint8_t* ring = nullptr;
+    std::uint64_t capacity = 0;
+    std::uint64_t pos = 0;
+    std::uint32_t tick = 0;
+    std::uint32_t keyframeInterval = 60;
+    std::uint32_t sinceKeyframe = 0;
+    State last;
+    bool forceKeyframe = true;
+
+    void write(RecordBuilder& r, RecordType type) {
+        std::uint32_t size = static_cast<std::uint32_t>((r.size + 7) & ~7);
+        std::uint64_t at = pos % capacity;
+        if(at + size > capacity) {
+            // 링 끝의 남는 칸은 PAD로 채우고 처음부터
+            std::uint32_t padSize = static_cast<std::uint32_t>(capacity - at);
+            header->reserved.store(pos + padSize + size, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            std::uint8_t pad[RECORD_HEADER] = {};
+            std::memcpy(pad, &padSize, 4);
+            std::memcpy(ring + at, pad, std::min<std::uint32_t>(padSize, RECORD_HEADER));   // 8바이트만 남을 수도 있음
+            pos += padSize;
+            at = 0;
+        } else {
+            header->reserved.store(pos + size, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+        }
+        std::memcpy(r.buf, &size, 4);
+        std::memcpy(r.buf + 4, &tick, 4);
+        r.buf[8] = type;
+        r.buf[9] = r.buf[10] = r.buf[11] = 0;
+        std::memcpy(ring + at, r.buf, r.size);
+        std::uint64_t start = pos;
+        pos += size;
+        header->committed.store(pos, std::memory_order_release);
+        if(type == REC_KEYFRAME) header->lastKeyframe.store(start, std::memory_order_release);
+    }
+
+public:
+    // capacityBytes는 2의 거듭제곱으로 올림
+    bool open(const std::string& path, std::uint64_t capacityBytes = 1 << 20, std::uint32_t keyframeEvery = 60) {
+        capacity = 4096;
+        while(capacity < capacityBytes) capacity <<= 1;
+        if(!file.open(path, MappedFile::READ_WRITE, HEADER_SIZE + capacity)) return false;
+        header = reinterpret_cast<Header*>(file.data());
+        ring = file.data() + HEADER_SIZE;
+
+        // 새 세션: 위치를 0부터 다시 (읽는 쪽은 session이 바뀐 것을 보고 다시 동기화)
+        std::uint32_t session = header->session.load() + 1;
+        header->session.store(0, std::memory_order_release);   // 초기화 중 표시
+        std::memcpy(header->magic, MAGIC, sizeof(MAGIC));
+        header->version = VERSION;
+        header->keyframeInterval = keyframeInterval = std::max<std::uint32_t>(1, keyframeEvery);
+        header->capacity = capacity;
+        header->committed.store(0);
+        header->reserved.store(0);
+        header->lastKeyframe.store(0);
+        header->session.store(session ? session : 1, std::memory_order_release);
+        pos = 0;
+        tick = 0;
+        forceKeyframe = true;
+        return true;
+    }
+
+    bool isOpen() const { return header != nullptr; }
+
+    // 틱마다 호출: 주기가 되면 KEYFRAME, 아니면 바뀐 부분만
+    void publish(const State& s) {
+        if(!header) return;
+        tick++;
+        RecordBuilder r;
+        if(forceKeyframe || ++sinceKeyframe >= keyframeInterval) {
+            putKeyframe(r, s);
+            write(r, REC_KEYFRAME);
+            sinceKeyframe = 0;
+            forceKeyframe = false;
+        } else if(putDelta(r, s, last)) {
+            write(r, REC_DELTA);
+        }
+        last = s;
+    }
+
+    void event(EventKind kind, std::uint8_t a = 0, std::uint16_t b = 0, std::uint32_t c = 0) {
+        if(!header) return;
+        RecordBuilder r;
+        r.put(static_cast<std::uint8_t>(kind));
+        r.put(a);
+        r.put(b);
+        r.put(c);
+        write(r, REC_EVENT);
+        if(kind == EV_RESET) forceKeyframe = true;
+    }
+
+    std::uint64_t bytesWritten() const { return pos; }
+};
+
+class SpectatorReader {
+private:
+    MappedFile file;
+    const Header* header = nullptr;
+    const std::uint8_t* ring = nullptr;
+    std::uint64_t capacity = 0;
+    std::uint64_t pos = 0;
+    std::uint32_t session = 0;
+    bool synced = false;
+    State state;
+    std::uint32_t tick = 0;
+
+    bool applyRecord(const std::uint8_t* rec, std::uint32_t size, Event* ev) {
+        std::uint8_t type = rec[8];
+        const std::uint8_t* p = rec + RECORD_HEADER;
+        const std::uint8_t* end = rec + size;
+        auto get = [&](auto& v) {
+            if(p + sizeof(v) > end) return false;
+            std::memcpy(&v, p, sizeof(v));
+            p += sizeof(v);
+            return true;
+        };
+        auto getColor = [&](Color& c) {
+            std::uint8_t v = 0;
+            bool ok = get(v);
+            c = static_cast<Color>(v % COLOR_COUNT);
+            return ok;
+        };
+
+        if(type == REC_KEYFRAME) {
+            State s;
+            for(int y = 0; y < ROWS; y++)
+                for(int x = 0; x < COLS; x++)
+                    if(!getColor(s.g[y][x])) return false;
+            bool ok = get(s.score) && get(s.level) && get(s.chain) && get(s.gameState) && get(s.px) && get(s.py) &&
+                      get(s.orientation) && getColor(s.c1) && getColor(s.c2) && getColor(s.n1) && getColor(s.n2);
+            if(!ok) return false;
+            state = s;
+            synced = true;
+        } else if(type == REC_DELTA && synced) {
+            std::uint8_t mask = 0;
+            if(!get(mask)) return false;
+            bool ok = true;
+            if(mask & D_SCORE) ok = ok && get(state.score);
+            if(mask & D_LEVEL) ok = ok && get(state.level);
+            if(mask & D_CHAIN) ok = ok && get(state.chain);
+            if(mask & D_GAME_STATE) ok = ok && get(state.gameState);
+            if(mask & D_PAIR) ok = ok && get(state.px) && get(state.py) && get(state.orientation) &&
+                                   getColor(state.c1) && getColor(state.c2);
+            if(mask & D_NEXT) ok = ok && getColor(state.n1) && getColor(state.n2);
+            if(ok && (mask & D_CELLS)) {
+                std::uint8_t n = 0;
+                ok = get(n);
+                for(int i = 0; ok && i < n; i++) {
+                    std::uint16_t v = 0;
+                    ok = get(v) && (v >> 3) < ROWS * COLS;
+                    if(ok) state.g[(v >> 3) / COLS][(v >> 3) % COLS] = static_cast<Color>((v & 7) % COLOR_COUNT);
+                }
+            }
+            if(!ok) return false;
+        } else if(type == REC_EVENT && synced && ev) {
+            std::uint8_t kind = 0;
+            if(!get(kind) || !get(ev->a) || !get(ev->b) || !get(ev->c)) return false;
+            ev->kind = static_cast<EventKind>(kind);
+            ev->tick = tick;
+            return true;
+        }
+        return false;
+    }
+
+    // 가장 최근 KEYFRAME으로 이동 (아직 없으면 false)
+    bool resync() {
+        resyncs++;
+        synced = false;
+        session = header->session.load(std::memory_order_acquire);
+        std::uint64_t committed = header->committed.load(std::memory_order_acquire);
+        if(session == 0 || committed == 0) return false;
+        pos = header->lastKeyframe.load(std::memory_order_acquire);
+        return true;
+    }
+
+public:
+    std::uint64_t resyncs = 0;
+    std::uint64_t records = 0;
+
+    bool open(const std::string& path) {
+        if(!file.open(path, MappedFile::READ_ONLY) || file.size() < static_cast<size_t>(HEADER_SIZE)) return false;
+        header = reinterpret_cast<const Header*>(file.data());
+        if(std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0 || header->version != VERSION ||
+           file.size() < HEADER_SIZE + header->capacity) {
+            header = nullptr;
+            file.close();
+            return false;
+        }
+        capacity = header->capacity;
+        ring = file.data() + HEADER_SIZE;
+        resyncs = 0;
+        resync();
+        resyncs = 0;
+        return true;
+    }
+
+    bool isOpen() const { return header != nullptr; }
+    bool isSynced() const { return synced; }
+    const State& current() const { return state; }
+    std::uint32_t currentTick() const { return tick; }
+
+    // 쓰는 쪽보다 뒤처진 바이트 수
+    std::uint64_t lag() const { return header ? header->committed.load(std::memory_order_acquire) - pos : 0; }
+
+    // 쌓인 레코드를 모두 적용. 이벤트가 있으면 onEvent(const Event&) 호출. 적용한 레코드 수 반환
+    template<class OnEvent>
+    int poll(OnEvent&& onEvent) {
+        if(!header) return 0;
+        if(header->session.load(std::memory_order_acquire) != session && !resync()) return 0;
+
+        int applied = 0;
+        int retries = 0;   // 링이 너무 작아 KEYFRAME조차 덮어써지는 경우 다음 poll로 미룸
+        std::uint8_t rec[MAX_RECORD + 8];
+        while(true) {
+            std::uint64_t committed = header->committed.load(std::memory_order_acquire);
+            if(committed < pos || committed - pos > capacity) {
+                if(++retries > 4 || !resync()) return applied;   // 너무 뒤처졌거나 새 세션
+                continue;
+            }
+            if(pos == committed) return applied;
+
+            // 레코드를 복사한 뒤, 그동안 쓰는 쪽이 이 자리를 덮어쓰기 시작했는지 확인 (seqlock)
+            std::uint64_t at = pos % capacity;
+            std::uint32_t size = 0;
+            std::memcpy(&size, ring + at, 4);
+            bool sane = size >= 8 && size % 8 == 0 && at + size <= capacity;
+            if(sane && size <= sizeof(rec)) std::memcpy(rec, ring + at, size);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            std::uint64_t reserved = header->reserved.load(std::memory_order_relaxed);
+            if((reserved > capacity && reserved - capacity > pos) || !sane) {
+                if(++retries > 4 || !resync()) return applied;
+                continue;
+            }
+
+            std::uint8_t type = size >= static_cast<std::uint32_t>(RECORD_HEADER) && size <= sizeof(rec) ? rec[8] : static_cast<std::uint8_t>(REC_PAD);
+            if(type != REC_PAD) {
+                std::memcpy(&tick, rec + 4, 4);
+                Event ev;
+                bool isEvent = applyRecord(rec, size, &ev) && type == REC_EVENT;
+                if(isEvent) onEvent(ev);
+                records++;
+                applied++;
+            }
+            pos += size;
+        }
+    }
+
+    int poll() {
+        return poll([](const Event&) {});
+    }
+};
+
+} // namespace stream
@@ -0,0 +1,272 @@
+// ---- 평가 함수 가중치 튜너 (대각 공분산 진화 전략, sep-CMA 방식) ----
+// 세대마다 개체 population개를 샘플링하고, 모든 개체가 같은 시드 games개로
+// 헤드리스 게임을 진행해 (공통 난수로 분산 감소) 평균 점수를 적합도로 사용
+//
+//   ./puyo_tune --population=32 --games=16 --generations=200 --threads=8 --out=weights.txt
+//   ./puyo_tune --generations=400 --resume      (tune.ckpt에서 이어서)
+//   ./puyo_tune --rules=tsu                     (통 방식 점수 규칙으로 적합도 계산)
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "puyo_ai.hpp"
+
+using namespace std;
+
+struct TuneOptions {
+    int population = 32;
+    int games = 16;
+    int validationGames = 32;     // 최고 기록 비교용 고정 시드 묶음 크기
+    int generations = 100;
+    int threads = 0;
+    int maxMoves = 300;
+    double sigma = 0.3;
+    uint32_t seed = 1;
+    string checkpointPath = "tune.ckpt";
+    string outPath = "weights.txt";
+    string patternsPath;
+    string rules = rules::EnhancedRules::NAME;
+    bool resume = false;
+};
+
+// 탐색 상태 (체크포인트에 그대로 저장)
+struct TuneState {
+    int generation = 0;
+    uint64_t rngDraws = 0;
+    double sigma = 0.3;
+    array<double, ai::FEATURE_COUNT> mean{};
+    array<double, ai::FEATURE_COUNT> variance{};
+    double bestFitness = -1.0;       // 고정 검증 시드 묶음에서의 평균 점수
+    ai::EvalWeights best = ai::EvalWeights::defaults();
+};
+
+// 2: 버전/특징 수 헤더, best_fitness가 검증 시드 기준으로 바뀜 (이전 파일은 거부)
+static const int CHECKPOINT_VERSION = 2;
+
+// 임시 파일에 쓴 뒤 이름을 바꿔 중간에 끊겨도 이전 체크포인트가 남게 함
+bool saveCheckpoint(const string& path, const TuneState& s) {
+    string tmp = path + ".tmp";
+    FILE* fp = fopen(tmp.c_str(), "w");
+    if(!fp) return false;
+    fprintf(fp, "tune_checkpoint %d %d\n", CHECKPOINT_VERSION, ai::FEATURE_COUNT);
+    fprintf(fp, "generation %d\ndraws %llu\nsigma %.17g\nbest_fitness %.17g\n", s.generation,
+            (unsigned long long)s.rngDraws, s.sigma, s.bestFitness);
+    for(int i = 0; i < ai::FEATURE_COUNT; i++) {
+        fprintf(fp, "%s %.17g %.17g %.9g\n", ai::FEATURE_NAMES[i], s.mean[i], s.variance[i], s.best.w[i]);
+    }
+    bool ok = fclose(fp) == 0;
+    remove(path.c_str());
+    return ok && rename(tmp.c_str(), path.c_str()) == 0;
+}
+
+bool loadCheckpoint(const string& path, TuneState& s) {
+    FILE* fp = fopen(path.c_str(), "r");
+    if(!fp) return false;
+    unsigned long long draws = 0;
+    int version = 0, features = 0;
+    bool ok = fscanf(fp, " tune_checkpoint %d %d", &version, &features) == 2 &&
+              version == CHECKPOINT_VERSION && features == ai::FEATURE_COUNT;
+    ok = ok && fscanf(fp, " generation %d draws %llu sigma %lf best_fitness %lf", &s.generation, &draws, &s.sigma,
+                     &s.bestFitness) == 4;
+    s.rngDraws = draws;
+    for(int i = 0; ok && i < ai::FEATURE_COUNT; i++) {
+        char name[64];
+        ok = fscanf(fp, "%63s %lf %lf %f", name, &s.mean[i], &s.variance[i], &s.best.w[i]) == 4 &&
+             string(name) == ai::FEATURE_NAMES[i];
+    }
+    fclose(fp);
+    return ok;
+}
+
+// (개체, 게임) 쌍을 작업 단위로 나눠 스레드들이 원자적 인덱스로 가져감. Board는 점수 규칙
+template<class Board>
+void evaluatePopulation(const vector<ai::EvalWeights>& individuals, const vector<uint32_t>& seeds, int maxMoves,
+                        int threadCount, const patterns::PatternLibrary* library, vector<double>& fitness) {
+    size_t taskCount = individuals.size() * seeds.size();
+    vector<int64_t> scores(taskCount);
+    atomic<size_t> next{0};
+
+    auto work = [&] {
+        for(size_t t = next.fetch_add(1); t < taskCount; t = next.fetch_add(1)) {
+            size_t ind = t / seeds.size();
+            size_t game = t % seeds.size();
+            scores[t] = ai::playGame<Board>(individuals[ind], seeds[game], maxMoves, library).score;
+        }
+    };
+
+    vector<thread> workers;
+    for(int i = 1; i < threadCount; i++) workers.emplace_back(work);
+    work();
+    for(auto& w : workers) w.join();
+
+    fitness.assign(individuals.size(), 0.0);
+    for(size_t t = 0; t < taskCount; t++) fitness[t / seeds.size()] += static_cast<double>(scores[t]);
+    for(double& f : fitness) f /= static_cast<double>(seeds.size());
+}
+
+int main(int argc, char** argv) {
+    TuneOptions opt;
+    for(int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        auto value = [&](const char* name) -> const char* {
+            size_t n = strlen(name);
+            return strncmp(arg, name, n) == 0 && arg[n] == '=' ? arg + n + 1 : nullptr;
+        };
+        if(const char* v = value("--population")) opt.population = max(4, atoi(v));
+        else if(const char* v = value("--games")) opt.games = max(1, atoi(v));
+        else if(const char* v = value("--validation-games")) opt.validationGames = max(1, atoi(v));
+        else if(const char* v = value("--generations")) opt.generations = atoi(v);
+        else if(const char* v = value("--threads")) opt.threads = atoi(v);
+        else if(const char* v = value("--max-moves")) opt.maxMoves = atoi(v);
+        else if(const char* v = value("--sigma")) opt.sigma = atof(v);
+        else if(const char* v = value("--seed")) opt.seed = static_cast<uint32_t>(strtoul(v, nullptr, 10));
+        else if(const char* v = value("--checkpoint")) opt.checkpointPath = v;
+        else if(const char* v = value("--out")) opt.outPath = v;
+        else if(const char* v = value("--patterns")) opt.patternsPath = v;
+        else if(const char* v = value("--rules")) opt.rules = v;
+        else if(strcmp(arg, "--resume") == 0) opt.resume = true;
+        else {
+            fprintf(stderr,
+                    "usage: %s [--population=N] [--games=N] [--validation-games=N] [--generations=N] [--threads=N] [--max-moves=N]\n"
+                    "          [--sigma=F] [--seed=N] [--checkpoint=FILE] [--out=FILE] [--patterns=FILE]\n"
+                    "          [--rules=enhanced|enhanced64|tsu] [--resume]\n", argv[0]);
+            return 2;
+        }
+    }
+    int threadCount = opt.threads > 0 ? opt.threads : max(1u, thread::hardware_concurrency());
+
+    // 규칙마다 따로 인스턴스화된 평가 루프 (게임 안에서는 규칙 분기 없음)
+    auto evaluate = opt.rules == rules::TsuRules::NAME ? evaluatePopulation<TsuBoard> :
+                    opt.rules == "enhanced64" ? evaluatePopulation<Board64> :
+                    opt.rules == rules::EnhancedRules::NAME ? evaluatePopulation<BoardCore> : nullptr;
+    if(!evaluate) {
+        fprintf(stderr, "unknown rules: %s (enhanced, enhanced64, tsu)\n", opt.rules.c_str());
+        return 2;
+    }
+
+    // 패턴 라이브러리가 없으면 pattern_match 특징은 항상 0
+    patterns::PatternLibrary library;
+    if(!opt.patternsPath.empty() && !library.open(opt.patternsPath)) {
+        fprintf(stderr, "cannot open pattern library: %s\n", opt.patternsPath.c_str());
+        return 1;
+    }
+
+    TuneState state;
+    ai::EvalWeights start = ai::EvalWeights::defaults();
+    for(int i = 0; i < ai::FEATURE_COUNT; i++) {
+        state.mean[i] = start.w[i];
+        state.variance[i] = 1.0;
+    }
+    state.sigma = opt.sigma;
+    if(opt.resume) {
+        if(!loadCheckpoint(opt.checkpointPath, state)) {
+            fprintf(stderr, "[tune] cannot resume from %s\n", opt.checkpointPath.c_str());
+            return 1;
+        }
+        printf("resumed at generation %d (best %.1f)\n", state.generation, state.bestFitness);
+    }
+
+    // 샘플링 난수는 시드 + 사용 횟수로 체크포인트에서 그대로 이어짐
+    PuyoRng rng;
+    rng.restore(opt.seed, state.rngDraws);
+    normal_distribution<double> normal(0.0, 1.0);
+
+    // 상위 mu개를 로그 가중치로 재조합
+    int lambda = opt.population;
+    int mu = lambda / 2;
+    vector<double> recombination(mu);
+    for(int k = 0; k < mu; k++) recombination[k] = log(mu + 0.5) - log(k + 1.0);
+    double weightSum = accumulate(recombination.begin(), recombination.end(), 0.0);
+    double weightSq = 0.0;
+    for(double& w : recombination) { w /= weightSum; weightSq += w * w; }
+    double muEff = 1.0 / weightSq;
+    double n = ai::FEATURE_COUNT;
+    double cVar = min(1.0, muEff / ((n + 2.0) * (n + 2.0)) * (n + 2.0) / 3.0);  // sep-CMA 대각 학습률
+    double cSigma = 0.3;
+
+    auto startTime = chrono::steady_clock::now();
+    int startGeneration = state.generation;
+    vector<vector<double>> z(lambda, vector<double>(ai::FEATURE_COUNT));
+    vector<ai::EvalWeights> individuals(lambda);
+    vector<double> fitness;
+
+    // 세대마다 시드 묶음이 달라 세대 최고 점수끼리는 비교할 수 없음: 최고 기록은 세대 1등을
+    // 고정된 검증 시드 묶음(학습용과 다른 시드 수열)에서 다시 평가해 비교
+    vector<uint32_t> validationSeeds(opt.validationGames);
+    for(int gIdx = 0; gIdx < opt.validationGames; gIdx++) {
+        validationSeeds[gIdx] = (opt.seed ^ 0x5EEDC0DEu) * 2654435761u + 0x80000000u + static_cast<uint32_t>(gIdx);
+    }
+    vector<double> validation;
+
+    printf("%5s %10s %10s %10s %10s %8s %8s\n", "gen", "best_val", "gen_val", "gen_best", "gen_mean", "sigma", "gen/min");
+    while(state.generation < opt.generations) {
+        normal.reset();  // 캐시된 값을 버려 draws만으로 상태가 정해지게 함
+        for(int k = 0; k < lambda; k++) {
+            // 대칭 샘플링: 짝수 개체의 반대 방향을 다음 개체로 사용
+            for(int i = 0; i < ai::FEATURE_COUNT; i++) {
+                z[k][i] = (k % 2 == 1) ? -z[k-1][i] : normal(rng);
+                individuals[k].w[i] = static_cast<float>(state.mean[i] + state.sigma * sqrt(state.variance[i]) * z[k][i]);
+            }
+        }
+        state.rngDraws = rng.draws;
+
+        // 공통 난수: 세대마다 새 시드 묶음을 만들되 모든 개체가 같은 묶음을 사용
+        vector<uint32_t> seeds(opt.games);
+        for(int gIdx = 0; gIdx < opt.games; gIdx++) {
+            seeds[gIdx] = opt.seed * 1000003u + static_cast<uint32_t>(state.generation) * 7919u + static_cast<uint32_t>(gIdx);
+        }
+        evaluate(individuals, seeds, opt.maxMoves, threadCount, &library, fitness);
+
+        vector<int> order(lambda);
+        iota(order.begin(), order.end(), 0);
+        sort(order.begin(), order.end(), [&](int a, int b) { return fitness[a] > fitness[b]; });
+
+        // 평균 / 대각 분산 갱신
+        array<double, ai::FEATURE_COUNT> zMean{};
+        array<double, ai::FEATURE_COUNT> zSq{};
+        for(int k = 0; k < mu; k++) {
+            for(int i = 0; i < ai::FEATURE_COUNT; i++) {
+                zMean[i] += recombination[k] * z[order[k]][i];
+                zSq[i] += recombination[k] * z[order[k]][i] * z[order[k]][i];
+            }
+        }
+        double zNorm = 0.0;
+        for(int i = 0; i < ai::FEATURE_COUNT; i++) {
+            state.mean[i] += state.sigma * sqrt(state.variance[i]) * zMean[i];
+            state.variance[i] = (1.0 - cVar) * state.variance[i] + cVar * zSq[i] * state.variance[i];
+            zNorm += zMean[i] * zMean[i] * muEff;
+        }
+        // 선택된 방향이 무작위보다 길면 보폭을 키우고 짧으면 줄임
+        state.sigma *= exp(cSigma * (sqrt(zNorm / n) - 1.0));
+        state.sigma = min(max(state.sigma, 1e-4), 5.0);
+
+        double genBest = fitness[order[0]];
+        double genMean = accumulate(fitness.begin(), fitness.end(), 0.0) / lambda;
+        evaluate(vector<ai::EvalWeights>{ individuals[order[0]] }, validationSeeds, opt.maxMoves, threadCount,
+                 &library, validation);
+        if(validation[0] > state.bestFitness) {
+            state.bestFitness = validation[0];
+            state.best = individuals[order[0]];
+            state.best.save(opt.outPath);
+        }
+
+        state.generation++;
+        saveCheckpoint(opt.checkpointPath, state);
+
+        double minutes = chrono::duration<double>(chrono::steady_clock::now() - startTime).count() / 60.0;
+        printf("%5d %10.1f %10.1f %10.1f %10.1f %8.4f %8.2f\n", state.generation, state.bestFitness, validation[0], genBest, genMean,
+               state.sigma, (state.generation - startGeneration) / max(minutes, 1e-9));
+        fflush(stdout);
+    }
+
+    printf("best weights (%s):\n", opt.outPath.c_str());
+    for(int i = 0; i < ai::FEATURE_COUNT; i++) printf("  %-16s %9.4f\n", ai::FEATURE_NAMES[i], state.best.w[i]);
+    return 0;
+}
@@ -0,0 +1,210 @@
+#pragma once
+// ---- 트윈 타임라인 (흩어진 이펙트 타이머를 한곳에서) ----
+// 값 칸(track)마다 마지막 값을 두고, 진행 중인 트윈만 연속 배열(SoA)에 모아 advance()에서 한 번에 계산함.
+// 끝나는 시각은 타이머 휠(틱 = 1/60초)에 넣어 두고 그 틱이 지날 때만 꺼냄 (매 프레임 만료를 찾아 훑지 않음).
+// 렌더링은 value()만 읽음. 비용은 움직이는 트윈 수에 비례하고, 멈춘 값 칸은 비용이 없음
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace tween {
+
+enum Ease : std::uint8_t {
+    LINEAR,
+    OUT_QUAD,     // 처음 빠르고 끝에서 감속 (떠오르기)
+    IN_SQRT,      // 1 - sqrt(1 - u): 처음 천천히, 끝에서 급히 (페이드 아웃)
+    WAVE          // 반복: from + 진폭 * sin(2π * 경과 / 주기)
+};
+
+class Timeline {
+public:
+    static constexpr float TICK = 1.0f / 60.0f;
+    static constexpr float FOREVER = -1.0f;
+
+private:
+    static const int WHEEL_SIZE = 256;   // 약 4.3초 (더 긴 트윈은 바퀴를 더 돌고 만료)
+    static constexpr float TWO_PI = 6.28318531f;
+
+    // 진행 중인 트윈 (계산 루프가 읽는 필드끼리 연속)
+    std::vector<float> age;              // 시작 후 경과 (지연 중이면 음수)
+    std::vector<float> rate;             // 1/길이 (WAVE는 각속도)
+    std::vector<float> from, delta;      // WAVE는 중심, 진폭
+    std::vector<std::uint8_t> ease;
+    std::vector<std::uint8_t> ends;      // 끝이 있음 (타이머 휠에 들어 있음)
+    std::vector<int> target;             // 값 칸
+    std::vector<std::uint32_t> handle;   // 안정 번호 (휠 항목이 가리킴)
+
+    // 안정 번호 -> 배열 위치 / 세대 (끝나거나 취소되면 세대가 올라 휠의 옛 항목은 버려짐)
+    std::vector<std::int32_t> indexOf;
+    std::vector<std::uint32_t> generationOf;
+    std::vector<std::uint32_t> freeHandles;
+
+    struct WheelEntry {
+        std::uint32_t handle, generation;
+        std::int64_t tick;
+    };
+    std::vector<WheelEntry> wheel[WHEEL_SIZE];
+    double now = 0.0;
+    std::int64_t tick = 0;
+
+    // 값 칸
+    std::vector<float> values;
+    std::vector<std::uint16_t> running;  // 값 칸마다 진행 중인 트윈 수
+    std::vector<int> freeTracks;
+    int finite = 0;                      // 끝이 있는 트윈 수
+
+    void removeAt(size_t i) {
+        std::uint32_t h = handle[i];
+        running[target[i]]--;
+        finite -= ends[i];
+        generationOf[h]++;
+        indexOf[h] = -1;
+        freeHandles.push_back(h);
+        size_t last = age.size() - 1;
+        if(i != last) {
+            age[i] = age[last]; rate[i] = rate[last];
+            from[i] = from[last]; delta[i] = delta[last];
+            ease[i] = ease[last]; ends[i] = ends[last]; target[i] = target[last];
+            handle[i] = handle[last];
+            indexOf[handle[i]] = static_cast<std::int32_t>(i);
+        }
+        age.pop_back(); rate.pop_back(); from.pop_back(); delta.pop_back();
+        ease.pop_back(); ends.pop_back(); target.pop_back(); handle.pop_back();
+    }
+
+    void add(int track, float start, float r, float a, float b, Ease e, float endsIn) {
+        std::uint32_t h;
+        if(!freeHandles.empty()) {
+            h = freeHandles.back();
+            freeHandles.pop_back();
+        } else {
+            h = static_cast<std::uint32_t>(indexOf.size());
+            indexOf.push_back(-1);
+            generationOf.push_back(0);
+        }
+        indexOf[h] = static_cast<std::int32_t>(age.size());
+        age.push_back(start); rate.push_back(r);
+        from.push_back(a); delta.push_back(b);
+        ease.push_back(e); ends.push_back(endsIn >= 0.0f ? 1 : 0); target.push_back(track);
+        handle.push_back(h);
+        running[track]++;
+        if(endsIn >= 0.0f) {
+            finite++;
+            std::int64_t due = static_cast<std::int64_t>(std::ceil((now + endsIn) / TICK));
+            due = std::max(due, tick + 1);
+            wheel[due & (WHEEL_SIZE - 1)].push_back({h, generationOf[h], due});
+        }
+    }
+
+    // 만료 틱이 된 트윈을 끝값으로 두고 뺌
+    void expire(std::int64_t current) {
+        std::int64_t steps = std::min<std::int64_t>(current - tick, WHEEL_SIZE);
+        for(std::int64_t s = 1; s <= steps; s++) {
+            std::vector<WheelEntry>& bucket = wheel[(tick + s) & (WHEEL_SIZE - 1)];
+            for(size_t k = 0; k < bucket.size();) {
+                const WheelEntry& entry = bucket[k];
+                bool stale = generationOf[entry.handle] != entry.generation;
+                if(!stale && entry.tick > current) {
+                    k++;
+                    continue;
+                }
+                if(!stale) {
+                    size_t i = static_cast<size_t>(indexOf[entry.handle]);
+                    values[target[i]] = ease[i] == WAVE ? from[i] : from[i] + delta[i];
+                    removeAt(i);
+                }
+                bucket[k] = bucket.back();
+                bucket.pop_back();
+            }
+        }
+        tick = current;
+    }
+
+public:
+    // 새 값 칸
+    int track(float initial = 0.0f) {
+        int t;
+        if(!freeTracks.empty()) {
+            t = freeTracks.back();
+            freeTracks.pop_back();
+            values[t] = initial;
+        } else {
+            t = static_cast<int>(values.size());
+            values.push_back(initial);
+            running.push_back(0);
+        }
+        return t;
+    }
+
+    void release(int t) {
+        cancel(t);
+        freeTracks.push_back(t);
+    }
+
+    // seconds 동안 from -> to (delay 동안은 값을 건드리지 않음)
+    void play(int t, float a, float b, float seconds, Ease e = LINEAR, float delay = 0.0f) {
+        seconds = std::max(seconds, 1e-4f);
+        add(t, -delay, 1.0f / seconds, a, b - a, e, delay + seconds);
+    }
+
+    // center ± amplitude 로 period마다 흔들림 (seconds가 FOREVER면 cancel할 때까지)
+    void wave(int t, float center, float amplitude, float period, float seconds = FOREVER) {
+        add(t, 0.0f, TWO_PI / period, center, amplitude, WAVE, seconds);
+        values[t] = center;
+    }
+
+    // 값 칸의 트윈을 멈춤 (값은 그대로)
+    void cancel(int t) {
+        if(running[t] == 0) return;
+        for(size_t i = age.size(); i-- > 0;) {
+            if(target[i] == t) removeAt(i);
+        }
+    }
+
+    void set(int t, float v) {
+        cancel(t);
+        values[t] = v;
+    }
+
+    // 모든 트윈을 멈춤 (값 칸은 남음)
+    void stopAll() {
+        for(size_t i = age.size(); i-- > 0;) removeAt(i);
+        for(auto& bucket : wheel) bucket.clear();
+    }
+
+    float value(int t) const { return values[t]; }
+    bool active(int t) const { return running[t] > 0; }
+    // 끝이 있는 트윈이 남아 있음 (대기 화면 절전 판단용: 끝없는 WAVE는 세지 않음)
+    bool busy() const { return finite > 0; }
+    size_t size() const { return age.size(); }
+
+    void advance(float dt) {
+        now += dt;
+        size_t n = age.size();
+        for(size_t i = 0; i < n; i++) age[i] += dt;
+        for(size_t i = 0; i < n; i++) {
+            float a = age[i];
+            if(a < 0.0f) continue;
+            float u = a * rate[i];
+            float f;
+            switch(ease[i]) {
+                case OUT_QUAD: u = std::min(u, 1.0f); f = u * (2.0f - u); break;
+                case IN_SQRT:  u = std::min(u, 1.0f); f = 1.0f - std::sqrt(1.0f - u); break;
+                case WAVE:
+                    // 오래 돌아도 sin 정밀도가 떨어지지 않게 한 주기 안으로
+                    if(u >= TWO_PI) {
+                        age[i] -= TWO_PI / rate[i];
+                        u -= TWO_PI;
+                    }
+                    f = std::sin(u);
+                    break;
+                default:       f = std::min(u, 1.0f); break;
+            }
+            values[target[i]] = from[i] + delta[i] * f;
+        }
+        expire(static_cast<std::int64_t>(std::floor(now / TICK)));
+    }
+};
+
+} // namespace tween